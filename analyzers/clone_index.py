@@ -0,0 +1,247 @@
+"""
+Persistent Clone Index
+Corpus-wide MinHash/LSH index of function fingerprints stored in SQLite.
+
+Shared across runs and repositories: only new or changed function bodies
+are fingerprinted, inserted and queried, and pair verdicts are remembered
+by body hash. A verdict records what decided it and the threshold set in
+force; pairs nothing decided (LLM down, no LLM configured) are kept as
+pending instead, and both pending pairs and verdicts from other thresholds
+are verified again on the next run.
+"""
+
+import random
+import sqlite3
+import hashlib
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple, Callable
+
+
+class CloneIndex:
+    """
+    SQLite-backed LSH index.
+
+    Tables:
+      functions — one row per (repo, qualified_name) with body hash and fingerprint
+      lsh       — MinHash band buckets pointing at function rows
+      verdicts  — cached pair decisions keyed by the two body hashes, with their source and thresholds
+      pending   — pairs whose last verification was undecided
+    """
+
+    NUM_PERM = 64
+    BANDS = 32            # 32 bands x 2 rows ≈ 0.18 Jaccard candidate threshold
+    SHINGLE_SIZE = 2      # fingerprint tokens per shingle (bigrams keep recall high for ≥0.7 matches)
+    _PRIME = (1 << 61) - 1
+
+    def __init__(self, db_path: Path):
+        self.db_path = Path(db_path)
+        self.conn = sqlite3.connect(str(self.db_path))
+        self.conn.row_factory = sqlite3.Row
+        rng = random.Random(0x5EED)
+        self._perms = [(rng.randrange(1, self._PRIME), rng.randrange(0, self._PRIME))
+                       for _ in range(self.NUM_PERM)]
+        self._create_schema()
+
+    def _create_schema(self):
+        self.conn.executescript("""
+            CREATE TABLE IF NOT EXISTS functions (
+                id INTEGER PRIMARY KEY,
+                repo TEXT NOT NULL,
+                qualified_name TEXT NOT NULL,
+                name TEXT, parent TEXT, file TEXT, line INTEGER, signature TEXT,
+                body_hash TEXT NOT NULL,
+                fingerprint TEXT NOT NULL,
+                body_code TEXT,
+                UNIQUE(repo, qualified_name)
+            );
+            CREATE INDEX IF NOT EXISTS idx_functions_hash ON functions(body_hash);
+            CREATE TABLE IF NOT EXISTS lsh (
+                band INTEGER NOT NULL,
+                bucket TEXT NOT NULL,
+                func_id INTEGER NOT NULL
+            );
+            CREATE INDEX IF NOT EXISTS idx_lsh_bucket ON lsh(band, bucket);
+            CREATE INDEX IF NOT EXISTS idx_lsh_func ON lsh(func_id);
+            CREATE TABLE IF NOT EXISTS verdicts (
+                hash_a TEXT NOT NULL,
+                hash_b TEXT NOT NULL,
+                similarity REAL,
+                is_duplicate INTEGER,
+                reason TEXT,
+                suggestion TEXT,
+                source TEXT,
+                thresholds TEXT,
+                PRIMARY KEY(hash_a, hash_b)
+            );
+            CREATE TABLE IF NOT EXISTS pending (
+                hash_a TEXT NOT NULL,
+                hash_b TEXT NOT NULL,
+                PRIMARY KEY(hash_a, hash_b)
+            );
+            CREATE INDEX IF NOT EXISTS idx_pending_b ON pending(hash_b);
+            CREATE INDEX IF NOT EXISTS idx_verdicts_b ON verdicts(hash_b);
+        """)
+        # Indexes written before verdicts carried a source: their rows count as stale
+        columns = {row["name"] for row in self.conn.execute("PRAGMA table_info(verdicts)")}
+        for column in ("source", "thresholds"):
+            if column not in columns:
+                self.conn.execute(f"ALTER TABLE verdicts ADD COLUMN {column} TEXT")
+        self.conn.commit()
+
+    # ── Synchronisation ──────────────────────────────────────────────
+
+    @staticmethod
+    def body_hash(code: str) -> str:
+        return hashlib.sha1(code.strip().encode('utf-8', errors='replace')).hexdigest()
+
+    def sync(self, repo: str, functions: List, fingerprint_fn: Callable) -> Tuple[List, Dict[str, str]]:
+        """
+        Bring the index in line with the current functions of `repo`.
+
+        Returns (changed_symbols, fingerprints) where fingerprints covers every
+        function (unchanged ones are read back from the index, not recomputed).
+        """
+        existing = {
+            row["qualified_name"]: row
+            for row in self.conn.execute(
+                "SELECT id, qualified_name, body_hash, fingerprint FROM functions WHERE repo = ?", (repo,))
+        }
+
+        changed = []
+        fingerprints: Dict[str, str] = {}
+        seen = set()
+        for func in functions:
+            qname = func.qualified_name
+            seen.add(qname)
+            digest = self.body_hash(func.body_code)
+            row = existing.get(qname)
+            if row and row["body_hash"] == digest:
+                fingerprints[qname] = row["fingerprint"]
+                # Location may move without the body changing
+                self.conn.execute("UPDATE functions SET file = ?, line = ? WHERE id = ?",
+                                  (str(func.file), func.line, row["id"]))
+                continue
+
+            fp = fingerprint_fn(func)
+            fingerprints[qname] = fp
+            if row:
+                self._delete(row["id"])
+            cur = self.conn.execute(
+                "INSERT INTO functions (repo, qualified_name, name, parent, file, line, signature, "
+                "body_hash, fingerprint, body_code) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                (repo, qname, func.name, func.parent_name or "", str(func.file), func.line,
+                 func.signature, digest, fp, func.body_code)
+            )
+            if fp:
+                self.conn.executemany(
+                    "INSERT INTO lsh (band, bucket, func_id) VALUES (?, ?, ?)",
+                    [(band, bucket, cur.lastrowid) for band, bucket in enumerate(self._bands(fp))]
+                )
+            changed.append(func)
+
+        for qname, row in existing.items():
+            if qname not in seen:
+                self._delete(row["id"])
+
+        self.conn.commit()
+        return changed, fingerprints
+
+    def _delete(self, func_id: int):
+        self.conn.execute("DELETE FROM lsh WHERE func_id = ?", (func_id,))
+        self.conn.execute("DELETE FROM functions WHERE id = ?", (func_id,))
+
+    # ── Queries ──────────────────────────────────────────────────────
+
+    def candidates(self, repo: str, qualified_name: str) -> List[sqlite3.Row]:
+        """Functions (any repo) sharing at least one LSH band with the given one."""
+        return list(self.conn.execute("""
+            SELECT DISTINCT f.* FROM functions me
+            JOIN lsh mine ON mine.func_id = me.id
+            JOIN lsh other ON other.band = mine.band AND other.bucket = mine.bucket
+            JOIN functions f ON f.id = other.func_id
+            WHERE me.repo = ? AND me.qualified_name = ? AND f.id != me.id
+        """, (repo, qualified_name)))
+
+    def get_verdict(self, hash1: str, hash2: str, thresholds: Optional[str] = None) -> Optional[sqlite3.Row]:
+        """The cached verdict for a pair; with `thresholds`, only one taken under that threshold set."""
+        a, b = sorted((hash1, hash2))
+        row = self.conn.execute("SELECT * FROM verdicts WHERE hash_a = ? AND hash_b = ?", (a, b)).fetchone()
+        if row is not None and thresholds is not None and row["thresholds"] != thresholds:
+            return None
+        return row
+
+    def put_verdict(self, hash1: str, hash2: str, similarity: float, is_duplicate: bool,
+                    reason: str = "", suggestion: str = "", source: str = "", thresholds: str = ""):
+        a, b = sorted((hash1, hash2))
+        self.conn.execute(
+            "INSERT OR REPLACE INTO verdicts VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+            (a, b, similarity, int(is_duplicate), reason, suggestion, source, thresholds)
+        )
+        self.conn.execute("DELETE FROM pending WHERE hash_a = ? AND hash_b = ?", (a, b))
+        self.conn.commit()
+
+    def mark_pending(self, hash1: str, hash2: str):
+        """Undecided pair: verify it again next run. An older verdict, if any, stays until then."""
+        a, b = sorted((hash1, hash2))
+        self.conn.execute("INSERT OR IGNORE INTO pending VALUES (?, ?)", (a, b))
+        self.conn.commit()
+
+    def revisit_hashes(self, repo: str, thresholds: str) -> set:
+        """Body hashes of `repo` functions with a pending pair or a verdict from another threshold set."""
+        rows = self.conn.execute("""
+            SELECT f.body_hash FROM functions f
+            WHERE f.repo = ? AND (
+                EXISTS (SELECT 1 FROM pending p WHERE p.hash_a = f.body_hash OR p.hash_b = f.body_hash)
+                OR EXISTS (SELECT 1 FROM verdicts v
+                           WHERE (v.hash_a = f.body_hash OR v.hash_b = f.body_hash)
+                             AND (v.thresholds IS NULL OR v.thresholds != ?)))
+        """, (repo, thresholds))
+        return {row["body_hash"] for row in rows}
+
+    FUNCTION_COLUMNS = ("id", "repo", "qualified_name", "name", "parent", "file", "line", "signature",
+                        "body_hash", "fingerprint", "body_code")
+    VERDICT_COLUMNS = ("similarity", "is_duplicate", "reason", "suggestion", "source", "thresholds")
+
+    def duplicate_pairs(self, repo: str) -> List[Tuple[Dict, Dict, Dict]]:
+        """Confirmed duplicate pairs with at least one side in `repo`: (func_a, func_b, verdict), one query."""
+        columns = [f"fa.{c} AS a_{c}" for c in self.FUNCTION_COLUMNS] + \
+                  [f"fb.{c} AS b_{c}" for c in self.FUNCTION_COLUMNS] + \
+                  [f"v.{c} AS v_{c}" for c in self.VERDICT_COLUMNS]
+        rows = self.conn.execute(f"""
+            SELECT {", ".join(columns)} FROM verdicts v
+            JOIN functions fa ON fa.body_hash = v.hash_a
+            JOIN functions fb ON fb.body_hash = v.hash_b
+            WHERE v.is_duplicate = 1 AND fa.id != fb.id AND (fa.repo = ? OR fb.repo = ?)
+        """, (repo, repo))
+
+        pairs, seen = [], set()
+        for row in rows:
+            first, second = ("a", "b") if row["a_id"] < row["b_id"] else ("b", "a")
+            key = (row[f"{first}_id"], row[f"{second}_id"])
+            if key in seen:
+                continue
+            seen.add(key)
+            pairs.append((
+                {c: row[f"{first}_{c}"] for c in self.FUNCTION_COLUMNS},
+                {c: row[f"{second}_{c}"] for c in self.FUNCTION_COLUMNS},
+                {c: row[f"v_{c}"] for c in self.VERDICT_COLUMNS},
+            ))
+        return pairs
+
+    def close(self):
+        self.conn.close()
+
+    # ── MinHash ──────────────────────────────────────────────────────
+
+    def _bands(self, fingerprint: str) -> List[str]:
+        tokens = fingerprint.split()
+        k = self.SHINGLE_SIZE
+        shingles = {" ".join(tokens[i:i + k]) for i in range(max(1, len(tokens) - k + 1))}
+        bases = [int.from_bytes(hashlib.blake2b(s.encode(), digest_size=8).digest(), 'big') for s in shingles]
+
+        signature = [min((a * x + b) % self._PRIME for x in bases) for a, b in self._perms]
+        rows = self.NUM_PERM // self.BANDS
+        return [
+            hashlib.md5(",".join(map(str, signature[i * rows:(i + 1) * rows])).encode()).hexdigest()[:16]
+            for i in range(self.BANDS)
+        ]
@@ -0,0 +1,212 @@
+"""
+C++ Container Rule
+Flags standard containers whose use does not match their cost model.
+
+Works per function from the parser's declared variable types (template
+arguments kept) and the call sites made on each variable: which members are
+called, at what loop depth, and whether the variable is iterated or passed
+on. Type choices are only judged for locals that are neither returned nor
+handed to another function, since anything else depends on code elsewhere;
+scans and front erases in loops are reported for parameters too.
+"""
+
+import re
+from typing import Any, Dict, List, Optional
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class ContainerUse:
+    """What one function does with one container variable."""
+
+    def __init__(self, name: str, kind: str, args: str, decl: Dict[str, Any]):
+        self.name = name
+        self.kind = kind            # map, list, vector, set, ...
+        self.args = args            # template argument text
+        self.decl = decl
+        self.calls: List[dict] = []
+        self.iterated = False
+        self.escapes = False
+        self.subscripted = False
+
+    def called(self, *names: str) -> List[dict]:
+        return [c for c in self.calls if c["name"] in names]
+
+
+class ContainerChoiceRule(PerformanceRule):
+    name = "cpp-containers"
+    description = "C++ container misuse on hot paths"
+
+    CPP_SUFFIXES = ('.cpp', '.cc', '.cxx', '.hpp', '.hh', '.hxx', '.h')
+    SSO_CHARS = 15                  # libstdc++/libc++ keep strings up to this length inline
+
+    _CONTAINER = re.compile(
+        r"^(?:const\s+)?(?:std::)?(map|multimap|set|multiset|unordered_map|unordered_set|list|forward_list|"
+        r"vector|deque)\s*<(.*)>\s*[&*]?\s*$", re.S)
+    _BEGIN = re.compile(r"^\s*(?:(\w+)\s*(?:\.|->)\s*c?begin\s*\(\s*\)|(?:std::)?c?begin\s*\(\s*(\w+)\s*\))\s*$")
+    _STRING_LITERAL = re.compile(r'^\s*(?:u8|u|U|L)?"((?:[^"\\]|\\.)*)"\s*$')
+
+    # end() alone is find()'s not-found sentinel; walking the container needs a begin or a bound
+    ITERATION = {"begin", "cbegin", "rbegin", "crbegin", "lower_bound", "upper_bound", "equal_range"}
+    MAP_LOOKUPS = {"find", "count", "contains", "at", "insert", "emplace", "try_emplace", "insert_or_assign",
+                   "erase"}
+    LIST_ONLY = {"insert", "erase", "splice", "push_front", "emplace_front", "pop_front", "remove",
+                 "remove_if", "merge", "unique", "reverse", "sort"}
+    SET_MUTATIONS = {"insert", "emplace", "erase", "clear", "merge", "extract"}
+    SEARCHES = {"find", "find_if", "find_if_not", "count", "count_if", "any_of", "none_of", "all_of"}
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        findings = []
+        for path in ctx.files(self.CPP_SUFFIXES):
+            data = ctx.structural.file_data_map.get(path) or {}
+            for func in data.get("functions", []):
+                calls = func.get("calls_detailed", [])
+                uses = self._uses(func, calls)
+                findings.extend(self._check(path, ctx.qualified_name(path, func), func, calls, uses))
+        return findings
+
+    # ── Usage ────────────────────────────────────────────────────────
+
+    def _uses(self, func: Dict[str, Any], calls: List[dict]) -> Dict[str, ContainerUse]:
+        uses = {}
+        for name, decl in (func.get("variables") or {}).items():
+            match = self._CONTAINER.match(decl.get("type", "").strip())
+            if match:
+                uses[name] = ContainerUse(name, match.group(1), match.group(2), decl)
+        if not uses:
+            return uses
+
+        body = func.get("body_code", "")
+        for call in calls:
+            receiver = call.get("receiver")
+            if receiver in uses:
+                uses[receiver].calls.append(call)
+                if call["name"] in self.ITERATION:
+                    uses[receiver].iterated = True
+            for arg in call.get("args", []):
+                token = re.sub(r"^(?:std::move\(|&)\s*|\)$", "", arg.strip())
+                if token in uses and call["name"] not in self.SEARCHES:
+                    uses[token].escapes = True
+        for text in func.get("iterated", []):
+            if text.strip() in uses:
+                uses[text.strip()].iterated = True
+        for name, use in uses.items():
+            if re.search(rf"\breturn\s+{re.escape(name)}\s*;", body):
+                use.escapes = True
+            use.subscripted = bool(re.search(rf"\b{re.escape(name)}\s*\[", body))
+        return uses
+
+    # ── Checks ───────────────────────────────────────────────────────
+
+    def _check(self, path, qname, func, calls, uses) -> List[PerformanceFinding]:
+        findings = []
+        for use in uses.values():
+            if use.decl.get("parameter"):
+                continue  # the caller chose the type; only locals are this function's decision
+            if use.kind == "map" and not use.escapes and not use.iterated:
+                finding = self._lookup_only_map(path, qname, use)
+                if finding:
+                    findings.append(finding)
+            elif use.kind == "list" and not use.escapes and use.iterated and not use.called(*self.LIST_ONLY):
+                findings.append(self._finding(
+                    path, qname, use.decl.get("line", 0), self._deepest(use.calls), "medium",
+                    f"`std::list {use.name}` is only appended to and iterated: every node is a separate "
+                    f"allocation and iteration chases pointers across the heap",
+                    "Use `std::vector` (reserve up front if the size is known); keep `std::list` only for "
+                    "mid-sequence insert/erase or splicing with stable iterators",
+                    variable=use.name, container=f"list<{use.args}>"))
+            elif use.kind in ("set", "unordered_set") and re.fullmatch(r"\s*(?:std::)?string\s*", use.args):
+                finding = self._literal_string_set(path, qname, use)
+                if finding:
+                    findings.append(finding)
+
+        for call in calls:
+            depth = call.get("loop_depth", 0)
+            if not depth:
+                continue
+            args = call.get("args", [])
+            if call["name"] == "erase" and args:
+                begin = self._BEGIN.match(args[0])
+                target = begin and (begin.group(1) or begin.group(2))
+                use = uses.get(target)
+                if target and target == call.get("receiver") and (use is None or use.kind == "vector"):
+                    findings.append(self._finding(
+                        path, qname, call.get("line", 0), depth, "high",
+                        f"`{target}.erase({args[0].strip()})` inside a loop shifts every remaining element on "
+                        f"each iteration: draining a vector from the front is O(n²)",
+                        "Walk it with an index/iterator and `clear()` once afterwards, erase a whole prefix with "
+                        "one `erase(begin(), it)`, or use `std::deque` and `pop_front()`",
+                        variable=target))
+            elif call["name"] in self.SEARCHES and call.get("receiver") in ("std", "ranges", None) and args:
+                begin = self._BEGIN.match(args[0])
+                target = (begin.group(1) or begin.group(2)) if begin else args[0].strip()
+                use = uses.get(target)
+                if use is not None and use.kind in ("vector", "list", "deque"):
+                    findings.append(self._finding(
+                        path, qname, call.get("line", 0), depth, "high" if depth > 1 else "medium",
+                        f"`std::{call['name']}` over {use.kind} `{target}` inside a loop: a linear scan per "
+                        f"iteration makes the loop O(n·m)",
+                        "Build a `std::unordered_set` (or sort once and use `std::binary_search`) before the "
+                        "loop and look elements up in it",
+                        variable=target))
+        return findings
+
+    def _lookup_only_map(self, path, qname, use: ContainerUse) -> Optional[PerformanceFinding]:
+        lookups = use.called(*self.MAP_LOOKUPS)
+        if not lookups and not use.subscripted:
+            return None
+        depth = self._deepest(lookups)
+        return self._finding(
+            path, qname, use.decl.get("line", 0), depth, "medium" if depth else "low",
+            f"`std::map {use.name}` is only used for lookups, never iterated in order: each lookup walks a "
+            f"red-black tree (O(log n) cache misses)",
+            "Use `std::unordered_map` (reserve() if the size is known), or a sorted `std::vector` of pairs / "
+            "flat_map for small, read-mostly tables",
+            variable=use.name, container=f"map<{use.args}>", lookups=len(lookups))
+
+    def _literal_string_set(self, path, qname, use: ContainerUse) -> Optional[PerformanceFinding]:
+        literals = re.findall(r'"((?:[^"\\]|\\.)*)"', use.decl.get("init", ""))
+        init_only_literals = bool(literals) and not re.sub(r'"(?:[^"\\]|\\.)*"|[\s{},()=]', "",
+                                                           use.decl.get("init", ""))
+        literal_lookups = [c for c in use.called("find", "count", "contains")
+                           if c.get("args") and self._short_literal(c["args"][0])]
+        short_init = init_only_literals and all(len(text) <= self.SSO_CHARS for text in literals) \
+            and not use.called(*self.SET_MUTATIONS)
+        if not literal_lookups and not short_init:
+            return None
+        depth = self._deepest(literal_lookups)
+        if literal_lookups:
+            message = (f"`{use.name}` (std::{use.kind}<std::string>) is searched with string literals: every "
+                       f"lookup constructs a temporary std::string from the literal")
+            suggestion = ("Declare it with a transparent comparator, `std::set<std::string, std::less<>>`, so "
+                          "`find(\"...\")` compares in place, or key it by `std::string_view`")
+        else:
+            message = (f"`{use.name}` (std::{use.kind}<std::string>) is a fixed table of {len(literals)} short "
+                       f"literals: each instance allocates its nodes and copies the strings")
+            suggestion = ("Use a `static constexpr std::array<std::string_view, N>` (sorted, searched with "
+                          "`std::binary_search`) or a switch on the value")
+        return self._finding(
+            path, qname, use.decl.get("line", 0), depth, "medium" if depth else "low", message, suggestion,
+            variable=use.name, container=f"{use.kind}<{use.args}>")
+
+    # ── Helpers ──────────────────────────────────────────────────────
+
+    def _finding(self, path, qname, line, depth, severity, message, suggestion, **details) -> PerformanceFinding:
+        fan_in = self.ctx.hotness.fan_in(qname)
+        return PerformanceFinding(
+            rule=self.name, file=path, line=line, function=qname,
+            message=f"{message} (loop depth {depth}, fan-in {fan_in})",
+            suggestion=suggestion,
+            severity=severity,
+            priority=self.ctx.priority(severity, qname, depth),
+            details={"loop_depth": depth, "fan_in": fan_in, **details},
+        )
+
+    @staticmethod
+    def _deepest(calls: List[dict]) -> int:
+        return max((c.get("loop_depth", 0) for c in calls), default=0)
+
+    def _short_literal(self, text: str) -> bool:
+        match = self._STRING_LITERAL.match(text)
+        return bool(match) and len(match.group(1)) <= self.SSO_CHARS
@@ -2,9 +2,11 @@ import ast
 import re
 import json
 import difflib
-from typing import List, Dict
+from collections import Counter
+from typing import AsyncIterator, List, Dict, Optional, Tuple
 from pathlib import Path
 from core.symbol_table import Symbol, SymbolType
+from analyzers.tree_edit_distance import TreeEditVerifier
 
 
 class DuplicateFunction:
@@ -21,7 +23,8 @@ class CrossFileRedundancyDetector:
     
     Pipeline:
       1. Structural Filter  — compare AST fingerprints to find candidate pairs
-      2. LLM Verification   — ask the model to confirm functional equivalence
+      2. Tree Edit Distance — accept/reject mid-similarity pairs locally
+      3. LLM Verification   — ask the model about the remaining ambiguous pairs
     """
 
     # Dunder methods to skip — boilerplate that is naturally similar across classes
@@ -36,14 +39,56 @@ class CrossFileRedundancyDetector:
     AST_SIMILARITY_THRESHOLD = 0.30  # structural similarity cutoff for LLM pass
     AUTO_CONFIRM_THRESHOLD = 0.95    # above this → auto-confirm without LLM (near-exact structure only)
 
-    def __init__(self, symbol_table, llm_client=None):
+    # Overridable per run from a calibration config (see analyzers/redundancy_calibration.py)
+    THRESHOLD_KEYS = ("AST_SIMILARITY_THRESHOLD", "AUTO_CONFIRM_THRESHOLD", "MIN_BODY_LINES",
+                      "TED_REJECT_SIMILARITY")
+
+    # Verdict sources the clone index may keep: an actual decision under the current thresholds.
+    # LLM failures ("llm-error") and runs without an LLM ("no-llm") are retried on later runs.
+    DECISIVE_SOURCES = {"auto-confirm", "ted", "llm", "below-threshold"}
+
+    def __init__(self, symbol_table, llm_client=None, clone_index=None, repo_name: str = "",
+                 thresholds: Optional[Dict] = None):
         self.symbol_table = symbol_table
         self.llm_client = llm_client
+        self.clone_index = clone_index  # Optional CloneIndex shared across runs/repos
+        self.repo_name = repo_name
+        self.ted_verifier = TreeEditVerifier()
+        for key, value in (thresholds or {}).items():
+            if key == "TED_REJECT_SIMILARITY":
+                self.ted_verifier.REJECT_SIMILARITY = float(value)
+            elif key in self.THRESHOLD_KEYS:
+                setattr(self, key, type(getattr(self, key))(value))
+        self.stats = Counter()  # ted_duplicate / ted_distinct / ted_ambiguous / llm_verifications
+
+    def thresholds_key(self) -> str:
+        """The threshold set stored with each cached verdict; a recalibration invalidates them."""
+        values = {key: getattr(self, key) for key in self.THRESHOLD_KEYS if key != "TED_REJECT_SIMILARITY"}
+        values["TED_REJECT_SIMILARITY"] = self.ted_verifier.REJECT_SIMILARITY
+        return json.dumps(values, sort_keys=True)
+
+    @classmethod
+    def load_thresholds(cls, path: Path) -> Dict:
+        """Read the "thresholds" section written by the calibrate command."""
+        try:
+            with open(path, 'r', encoding='utf-8') as f:
+                data = json.load(f)
+            return {k: v for k, v in data.get("thresholds", {}).items() if k in cls.THRESHOLD_KEYS}
+        except (OSError, ValueError, AttributeError) as e:
+            print(f"Warning: Could not read redundancy thresholds from {path}: {e}")
+            return {}
 
     # ── Main entry point ─────────────────────────────────────────────
-    async def detect_duplicates(self, console=None) -> List[DuplicateFunction]:
-        duplicates = []
+    async def detect_duplicates(self, console=None, progress=None) -> List[DuplicateFunction]:
+        """
+        Exact duplicates, then structural candidates verified pair by pair.
+        Per-pair detail goes to `progress` (a utils.progress.ProgressDashboard:
+        counters on screen, detail in its log file) when given, else to `console`.
+        """
+        return [dup async for dup in self.iter_duplicates(console, progress)]
 
+    async def iter_duplicates(self, console=None, progress=None) -> AsyncIterator[DuplicateFunction]:
+        """detect_duplicates, yielding each pair as soon as it is confirmed."""
         # ── Step 0: exact duplicate definitions (same name, same scope) ──
         seen_files = {sym.file for sym in self.symbol_table.symbols.values()}
 
@@ -52,17 +97,16 @@ class CrossFileRedundancyDetector:
                 source = file_path.read_text(encoding='utf-8')
                 tree = ast.parse(source)
                 exact_dups = self._find_duplicate_defs(tree, file_path, source)
-                if exact_dups:
-                    duplicates.extend(exact_dups)
-                    if console:
-                        for dup in exact_dups:
-                            f1, f2 = dup.functions
-                            console.print(
-                                f"  [red]⚠ Exact duplicate: {f1.name}() at lines "
-                                f"{f1.line} & {f2.line} in {file_path.name}[/red]"
-                            )
             except Exception:
-                pass
+                exact_dups = []
+            for dup in exact_dups:
+                f1, f2 = dup.functions
+                self._report(
+                    console, progress,
+                    f"  [red]⚠ Exact duplicate: {f1.name}() at lines "
+                    f"{f1.line} & {f2.line} in {file_path.name}[/red]"
+                )
+                yield dup
 
         # ── Step 1: collect candidate functions ──────────────────────
         functions = [
@@ -79,6 +123,11 @@ class CrossFileRedundancyDetector:
                 f"(skipped dunder methods)...[/dim]"
             )
 
+        if self.clone_index is not None:
+            async for dup in self._detect_with_index(functions, console, progress):
+                yield dup
+            return
+
         # ── Step 2: generate structural fingerprints ─────────────────
         fingerprints: Dict[str, str] = {}
         for func in functions:
@@ -91,13 +140,19 @@ class CrossFileRedundancyDetector:
         # ── Step 3: pairwise comparison ──────────────────────────────
         functions.sort(key=lambda x: x.qualified_name)
         compared_pairs = set()  # track already-compared pairs to avoid duplicates
+        if progress:
+            progress.set_total(len(functions) * (len(functions) - 1) // 2)
 
         for i, func1 in enumerate(functions):
             fp1 = fingerprints.get(func1.qualified_name, "")
             if not fp1:
+                if progress:
+                    progress.advance(len(functions) - i - 1)
                 continue
 
             for func2 in functions[i + 1:]:
+                if progress:
+                    progress.advance()
                 fp2 = fingerprints.get(func2.qualified_name, "")
                 if not fp2:
                     continue
@@ -116,62 +171,197 @@ class CrossFileRedundancyDetector:
                 # structural similarity
                 sim = difflib.SequenceMatcher(None, fp1, fp2).ratio()
 
-                if console:
-                    console.print(
-                        f"  [dim]{func1.name} ({func1.file.name}:{func1.line}) vs "
-                        f"{func2.name} ({func2.file.name}:{func2.line}): "
-                        f"structural={sim:.0%}[/dim]"
-                    )
+                self._report(
+                    console, progress,
+                    f"  [dim]{func1.name} ({func1.file.name}:{func1.line}) vs "
+                    f"{func2.name} ({func2.file.name}:{func2.line}): "
+                    f"structural={sim:.0%}[/dim]"
+                )
 
                 if sim < self.AST_SIMILARITY_THRESHOLD:
                     continue
 
-                # ── Step 4: LLM verification ─────────────────────────
-                scope = "same-file" if func1.file == func2.file else "cross-file"
-                if console:
-                    console.print(
-                        f"  [cyan]🔍 Candidate ({scope}): "
-                        f"{func1.name} ({func1.file.name}:{func1.line}) ↔ "
-                        f"{func2.name} ({func2.file.name}:{func2.line}) "
-                        f"(structural {sim:.0%})[/cyan]"
-                    )
+                dup, _ = await self._verify_pair(func1, func2, sim, console, progress)
+                if dup:
+                    yield dup
 
-                is_dup = False
-                reason = f"Structurally similar ({sim:.0%})"
-                suggestion = ""
-
-                if sim >= self.AUTO_CONFIRM_THRESHOLD:
-                    # Very high structural match → auto-confirm
-                    is_dup = True
-                    reason = (f"Near-identical code structure ({sim:.0%} AST match). "
-                              f"Both functions have the same control flow, operations, "
-                              f"and return pattern — only variable names differ.")
-                    suggestion = "Keep one function and remove the other"
-                elif self.llm_client:
-                    result = await self._llm_verify(func1, func2)
-                    is_dup = result.get("are_duplicates", False)
-                    if is_dup:
-                        reason = result.get("shared_logic_summary", "Same logic")
-                        suggestion = result.get("optimization_suggestion", "")
-                else:
-                    # no LLM → trust structural similarity alone
-                    is_dup = True
+    async def _verify_pair(self, func1: Symbol, func2: Symbol, sim: float, console=None,
+                           progress=None) -> Tuple[Optional[DuplicateFunction], str]:
+        """
+        Decide a candidate pair above the structural threshold (auto-confirm,
+        tree edit distance or LLM). Returns (duplicate or None, source), where
+        source names what decided: one of DECISIVE_SOURCES, or "llm-error" /
+        "no-llm" when nothing actually did.
+        """
+        # ── Step 4: verification (auto-confirm → tree edit → LLM) ────
+        scope = "same-file" if func1.file == func2.file else "cross-file"
+        self._report(
+            console, progress,
+            f"  [cyan]🔍 Candidate ({scope}): "
+            f"{func1.name} ({func1.file.name}:{func1.line}) ↔ "
+            f"{func2.name} ({func2.file.name}:{func2.line}) "
+            f"(structural {sim:.0%})[/cyan]"
+        )
 
+        is_dup = False
+        reason = f"Structurally similar ({sim:.0%})"
+        suggestion = ""
+        source = "auto-confirm"
+
+        if sim >= self.AUTO_CONFIRM_THRESHOLD:
+            # Very high structural match → auto-confirm
+            is_dup = True
+            reason = (f"Near-identical code structure ({sim:.0%} AST match). "
+                      f"Both functions have the same control flow, operations, "
+                      f"and return pattern — only variable names differ.")
+            suggestion = "Keep one function and remove the other"
+        else:
+            # Local tree-edit-distance check settles most of the mid band
+            decision, ted_sim = self.ted_verifier.verify(
+                func1.body_code, func1.file.suffix, func2.body_code, func2.file.suffix
+            )
+            self.stats[f"ted_{decision}"] += 1
+            source = "ted"
+            if decision == "duplicate":
+                is_dup = True
+                reason = (f"Same syntax tree up to renaming ({ted_sim:.0%} tree-edit similarity, "
+                          f"{sim:.0%} token match).")
+                suggestion = "Keep one function and remove the other"
+            elif decision == "distinct":
+                is_dup = False
+                self._report(console, progress, f"    [dim]Tree edit distance rules it out ({ted_sim:.0%})[/dim]")
+            elif self.llm_client:
+                self.stats["llm_verifications"] += 1
+                result = await self._llm_verify(func1, func2)
+                # No "are_duplicates" key: the request failed or the reply was unreadable
+                source = "llm" if "are_duplicates" in result else "llm-error"
+                is_dup = result.get("are_duplicates", False)
                 if is_dup:
-                    dup = DuplicateFunction(
-                        functions=[func1, func2],
-                        similarity=sim,
-                        reason=reason,
+                    reason = result.get("shared_logic_summary", "Same logic")
+                    suggestion = result.get("optimization_suggestion", "")
+            else:
+                # no LLM → trust structural similarity alone
+                is_dup = True
+                source = "no-llm"
+
+        if not is_dup:
+            self._report(console, progress, "    [green]✓ Not a duplicate[/green]")
+            return None, source
+
+        dup = DuplicateFunction(
+            functions=[func1, func2],
+            similarity=sim,
+            reason=reason,
+        )
+        dup.suggestion = suggestion
+        self._report(console, progress, "    [red]⚠ Confirmed duplicate![/red]")
+        return dup, source
+
+    @staticmethod
+    def _report(console, progress, message: str):
+        """Per-item detail: the dashboard's log when one is running, else the console."""
+        if progress:
+            progress.log(message)
+        elif console:
+            console.print(message)
+
+    # ── Persistent clone index ───────────────────────────────────────
+
+    async def _detect_with_index(self, functions: List[Symbol], console=None,
+                                 progress=None) -> AsyncIterator[DuplicateFunction]:
+        """
+        Incremental path: only functions whose body changed since the last run
+        are fingerprinted and queried against the corpus-wide index. Pairs
+        confirmed now are yielded as they are verified; previously confirmed
+        pairs follow from stored verdicts.
+        """
+        index, repo = self.clone_index, self.repo_name
+        thresholds = self.thresholds_key()
+        changed, fingerprints = index.sync(
+            repo, functions,
+            lambda f: self._fingerprint(f.body_code, f.file.suffix)
+        )
+        # Unchanged functions with an undecided pair, or verdicts taken under other thresholds
+        revisit = index.revisit_hashes(repo, thresholds)
+        changed_names = {f.qualified_name for f in changed}
+        hashes = {f.qualified_name: index.body_hash(f.body_code) for f in functions}
+        stale = [f for f in functions
+                 if f.qualified_name not in changed_names and hashes[f.qualified_name] in revisit]
+        if console:
+            console.print(
+                f"  [dim]Clone index: {len(changed)}/{len(functions)} functions new or changed, "
+                f"{len(stale)} to re-verify, querying index...[/dim]"
+            )
+        changed = list(changed) + stale
+
+        by_qname = {f.qualified_name: f for f in functions}
+        if progress:
+            progress.set_total(len(changed), unit="functions")
+        attempted = set()  # pairs tried this run, decided or not
+        reported = set()   # ((repo, qualified name), (repo, qualified name)) already yielded
+        for func in changed:
+            if progress:
+                progress.advance()
+            fp1 = fingerprints.get(func.qualified_name, "")  # computed or read back by sync
+            my_hash = hashes[func.qualified_name]
+            for row in index.candidates(repo, func.qualified_name):
+                pair = tuple(sorted((my_hash, row["body_hash"])))
+                if pair in attempted or index.get_verdict(my_hash, row["body_hash"], thresholds):
+                    continue  # decided in an earlier run under these thresholds, or tried earlier in this one
+                attempted.add(pair)
+                same_repo = row["repo"] == repo
+                if same_repo and func.parent_name and func.parent_name == row["parent"]:
+                    continue  # methods of the same class
+
+                sim = difflib.SequenceMatcher(None, fp1, row["fingerprint"]).ratio()
+                other = by_qname.get(row["qualified_name"]) if same_repo else None
+                other = other or self._symbol_from_row(row)
+
+                dup, source = None, "below-threshold"
+                if sim >= self.AST_SIMILARITY_THRESHOLD:
+                    dup, source = await self._verify_pair(func, other, sim, console, progress)
+                if source in self.DECISIVE_SOURCES:
+                    index.put_verdict(
+                        my_hash, row["body_hash"], sim, dup is not None,
+                        dup.reason if dup else "", dup.suggestion if dup else "",
+                        source=source, thresholds=thresholds
                     )
-                    dup.suggestion = suggestion
-                    duplicates.append(dup)
-                    if console:
-                        console.print("    [red]⚠ Confirmed duplicate![/red]")
                 else:
-                    if console:
-                        console.print("    [green]✓ Not a duplicate[/green]")
+                    index.mark_pending(my_hash, row["body_hash"])  # retried on the next run
+                    if dup and index.get_verdict(my_hash, row["body_hash"]):
+                        continue  # an older verdict still stands; it is reported from the index below
+                if dup:
+                    # Undecided ones are reported this run only (e.g. no LLM: structural match)
+                    reported.add(tuple(sorted(((repo, func.qualified_name), (row["repo"], row["qualified_name"])))))
+                    yield dup
+
+        for row_a, row_b, verdict in index.duplicate_pairs(repo):
+            if row_a["repo"] == row_b["repo"] and row_a["parent"] and row_a["parent"] == row_b["parent"]:
+                continue
+            key = tuple(sorted(((row_a["repo"], row_a["qualified_name"]), (row_b["repo"], row_b["qualified_name"]))))
+            if key in reported:
+                continue
+            sym_a = by_qname.get(row_a["qualified_name"]) if row_a["repo"] == repo else None
+            sym_b = by_qname.get(row_b["qualified_name"]) if row_b["repo"] == repo else None
+            dup = DuplicateFunction(
+                functions=[sym_a or self._symbol_from_row(row_a), sym_b or self._symbol_from_row(row_b)],
+                similarity=verdict["similarity"],
+                reason=verdict["reason"] or f"Structurally similar ({verdict['similarity']:.0%})",
+            )
+            dup.suggestion = verdict["suggestion"] or ""
+            yield dup
 
-        return duplicates
+    @staticmethod
+    def _symbol_from_row(row) -> Symbol:
+        """Rebuild a Symbol for an indexed function (possibly from another repository)."""
+        sym = Symbol(
+            name=row["name"], symbol_type=SymbolType.FUNCTION,
+            file_path=Path(row["file"]), line=row["line"],
+            signature=row["signature"] or "", body_code=row["body_code"] or "",
+            parent_name=row["parent"] or "",
+        )
+        sym.qualified_name = f"{row['repo']}:{row['qualified_name']}"
+        return sym
 
     # ── Structural Fingerprinting ────────────────────────────────────
 
@@ -333,7 +523,7 @@ RULES:
             response = await self.llm_client.generate_completion(prompt)
             return self._parse_llm_json(response)
         except Exception:
-            return {"are_duplicates": False}
+            return {}  # undecided: not cached, asked again next run
 
     def _parse_llm_json(self, response: str) -> Dict:
         """Extract JSON from LLM response with improved robustness."""
@@ -358,8 +548,10 @@ RULES:
         # 3. Heuristic
         if '"are_duplicates": true' in response.lower():
             return {"are_duplicates": True, "shared_logic_summary": "Heuristic match", "optimization_suggestion": "N/A"}
+        if '"are_duplicates": false' in response.lower():
+            return {"are_duplicates": False}
         
-        return {"are_duplicates": False}
+        return {}  # unreadable reply: undecided
 
     @staticmethod
     def _safe_json_load(text: str) -> Dict:
@@ -369,4 +561,4 @@ RULES:
         try:
             return json.loads(text)
         except json.JSONDecodeError:
-            return {"are_duplicates": False}
+            return {}
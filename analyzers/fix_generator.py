@@ -34,11 +34,16 @@ class FixGenerator:
         language: str,
         description: str,
         suggestion: str,
-        global_context: str = ""
+        global_context: str = "",
+        file_context=None
     ) -> Optional[CodeFix]:
         """
         Generate a fix for a detected bug.
+        file_context: optional utils.context_builder.FileContext supplying the
+        precomputed imports/globals block when global_context is not given.
         """
+        if not global_context and file_context is not None:
+            global_context = file_context.module_block
         
         prompt = self._build_fix_prompt(
             bug_type, severity, str(file_path), line, code_snippet, language, description, suggestion, global_context
@@ -0,0 +1,604 @@
+"""
+Fix Verifier
+Evidence for LLM-suggested performance fixes: a differential test on random
+inputs plus a micro-benchmark of the original and corrected function, run in
+a sandboxed subprocess before the fix is offered.
+
+Python: this file doubles as the harness (`python -I fix_verifier.py
+payload.json`). It runs only the module's imports and literal constants,
+never its other top-level code, defines both versions side by side, draws
+property-style inputs from the parameters' annotations, defaults and names,
+compares return values, exceptions and argument mutation, and times both on
+pre-copied inputs so copying is not part of the measurement.
+
+Verification executes the analyzed function and the LLM's rewrite, so it is
+opt-in (`analyze --verify-fixes`).
+
+C/C++: if a compiler is on PATH, a small driver containing both versions
+(renamed) is generated for functions over scalar and pointer+length
+parameters, compiled with -O2 and run the same way.
+
+The sandbox is a temporary working directory, a scrubbed environment,
+resource limits (CPU seconds, address space, file size, no core dumps) on
+POSIX, and a wall-clock timeout. It limits the damage of buggy code; it is
+not a security boundary against hostile code.
+"""
+
+import ast
+import copy
+import json
+import math
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+
+class VerificationResult:
+    """Outcome of verifying one corrected function against the original."""
+
+    NOISE = 0.1               # relative timing differences below this are reported as none
+
+    def __init__(self, status: str, reason: str = "", cases: int = 0, mismatches: int = 0,
+                 example: str = "", original_time: Optional[float] = None,
+                 corrected_time: Optional[float] = None, bench_size: Optional[int] = None):
+        self.status = status                # equivalent, different, error or skipped
+        self.reason = reason
+        self.cases = cases
+        self.mismatches = mismatches
+        self.example = example              # first mismatching input and both outputs
+        self.original_time = original_time  # seconds per call
+        self.corrected_time = corrected_time
+        self.bench_size = bench_size
+
+    @property
+    def speedup(self) -> Optional[float]:
+        if self.original_time and self.corrected_time:
+            return self.original_time / self.corrected_time
+        return None
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {"status": self.status, "reason": self.reason, "cases": self.cases,
+                "mismatches": self.mismatches, "example": self.example,
+                "original_time": self.original_time, "corrected_time": self.corrected_time,
+                "bench_size": self.bench_size, "speedup": self.speedup}
+
+    def summary(self) -> str:
+        if self.status == "skipped":
+            return f"not verified: {self.reason}"
+        if self.status == "error":
+            return f"verification failed: {self.reason}"
+        if self.status == "different":
+            text = f"outputs differ on {self.mismatches}/{self.cases} random inputs"
+            return text + (f", e.g. {self.example}" if self.example else "")
+        text = f"equivalent on {self.cases} random inputs"
+        if self.speedup is not None:
+            size = f" at input size {self.bench_size}" if self.bench_size else ""
+            times = f"({_per_call(self.original_time)} → {_per_call(self.corrected_time)} per call{size})"
+            if abs(self.speedup - 1) < self.NOISE:
+                text += f"; no measurable speedup {times}"
+            else:
+                text += f"; {self.speedup:.2f}× {'faster' if self.speedup > 1 else 'slower'} {times}"
+        return text
+
+
+def _per_call(seconds: float) -> str:
+    for unit, scale in (("s", 1), ("ms", 1e-3), ("µs", 1e-6)):
+        if seconds >= scale:
+            return f"{seconds / scale:.1f} {unit}"
+    return f"{seconds / 1e-9:.0f} ns"
+
+
+class FixVerifier:
+    """Runs the differential test and benchmark for one (original, corrected) pair."""
+
+    CASES = 200               # random inputs in the differential test
+    SEED = 1234               # fixed so reruns reproduce a mismatch
+    TIMEOUT = 30              # wall-clock seconds per sandboxed run
+    CPU_SECONDS = 30
+    MEMORY_BYTES = 1 << 30
+    FILE_BYTES = 16 << 20
+
+    C_COMPILERS = {"c": ("cc", "gcc", "clang"), "cpp": ("c++", "g++", "clang++")}
+
+    def verify(self, original: str, corrected: str, name: str, language: str,
+               file_path: Optional[Path] = None, parent_class: Optional[str] = None) -> VerificationResult:
+        """`original`/`corrected` are complete definitions of function `name`."""
+        if not corrected or not corrected.strip():
+            return VerificationResult("skipped", "no corrected code")
+        if parent_class:
+            return VerificationResult("skipped", "methods need an instance; only free functions are benchmarked")
+        try:
+            with tempfile.TemporaryDirectory(prefix="fix_verify_") as workdir:
+                if language == "python":
+                    return self._verify_python(original, corrected, name, file_path, Path(workdir))
+                if language in self.C_COMPILERS:
+                    return self._verify_native(original, corrected, name, language, file_path, Path(workdir))
+        except subprocess.TimeoutExpired:
+            return VerificationResult("error", f"timed out after {self.TIMEOUT}s")
+        except OSError as e:
+            return VerificationResult("error", str(e))
+        return VerificationResult("skipped", f"no harness for {language}")
+
+    # ── Python ───────────────────────────────────────────────────────
+
+    def _verify_python(self, original, corrected, name, file_path, workdir: Path) -> VerificationResult:
+        payload = {"original": original, "corrected": corrected, "name": name, "seed": self.SEED,
+                   "cases": self.CASES, "module": str(file_path.resolve()) if file_path else None,
+                   "sys_path": [str(file_path.resolve().parent), str(Path.cwd())] if file_path else []}
+        payload_path = workdir / "payload.json"
+        payload_path.write_text(json.dumps(payload), encoding='utf-8')
+        result = self._sandboxed([sys.executable, "-I", str(Path(__file__).resolve()), str(payload_path)], workdir)
+        return self._parse_report(result)
+
+    # ── C / C++ ──────────────────────────────────────────────────────
+
+    C_SCALARS = {
+        "int": "i", "long": "i", "long long": "i", "short": "i", "char": "i", "signed char": "i",
+        "unsigned": "u", "unsigned int": "u", "unsigned long": "u", "unsigned long long": "u",
+        "unsigned char": "u", "size_t": "u", "uint32_t": "u", "uint64_t": "u", "int32_t": "i", "int64_t": "i",
+        "double": "f", "float": "f", "bool": "b",
+    }
+    LENGTH_NAMES = {"n", "len", "length", "size", "count", "num", "cnt", "sz"}
+    _SIGNATURE = re.compile(r"^\s*(?:static\s+|inline\s+|constexpr\s+)*(?P<ret>[\w\s:*&<>]+?)\s*\b(?P<name>\w+)\s*"
+                            r"\((?P<params>[^)]*)\)\s*(?:const\s*)?(?:noexcept\s*)?\{", re.S)
+
+    def _verify_native(self, original, corrected, name, language, file_path, workdir: Path) -> VerificationResult:
+        compiler = next((shutil.which(c) for c in self.C_COMPILERS[language] if shutil.which(c)), None)
+        if compiler is None:
+            return VerificationResult("skipped", f"no {language} compiler on PATH")
+        signature = self._c_signature(original, name)
+        if isinstance(signature, str):
+            return VerificationResult("skipped", signature)
+        ret, params = signature
+
+        includes = []
+        if file_path and file_path.exists():
+            includes = [line for line in file_path.read_text(encoding='utf-8', errors='replace').splitlines()
+                        if line.lstrip().startswith("#include")]
+        source = self._c_driver(original, corrected, name, ret, params, includes, language)
+        driver = workdir / ("driver.cpp" if language == "cpp" else "driver.c")
+        driver.write_text(source, encoding='utf-8')
+        std = "-std=c++17" if language == "cpp" else "-std=c11"
+        include_dir = [f"-I{file_path.resolve().parent}"] if file_path else []
+        build = subprocess.run([compiler, "-O2", std, *include_dir, str(driver), "-o", str(workdir / "driver"), "-lm"],
+                               cwd=workdir, capture_output=True, text=True, timeout=self.TIMEOUT)
+        if build.returncode != 0:
+            first = next((line for line in build.stderr.splitlines() if "error" in line), build.stderr.strip()[:200])
+            return VerificationResult("skipped", f"driver did not compile (the function may depend on other code "
+                                                 f"in its file): {first}")
+        return self._parse_report(self._sandboxed([str(workdir / "driver")], workdir))
+
+    def _c_signature(self, code: str, name: str):
+        """(return kind, [(kind, c type, is_array)]) or a reason string when unsupported."""
+        match = self._SIGNATURE.search(code)
+        if not match or match.group("name") != name:
+            return "could not read the function signature"
+        ret = re.sub(r"\b(?:const|static|inline|std::)\b", "", match.group("ret")).strip()
+        if ret != "void" and ret not in self.C_SCALARS:
+            return f"return type `{ret}` is not a scalar"
+        params = []
+        text = match.group("params").strip()
+        for raw in ([] if text in ("", "void") else text.split(",")):
+            decl = re.sub(r"\b(?:const|restrict|__restrict)\b", "", raw).strip()
+            array = "*" in decl or "[" in decl
+            decl = re.sub(r"\[\s*\w*\s*\]", "", decl).replace("*", " ").replace("&", " ")
+            parts = decl.split()
+            if len(parts) < 2:
+                return f"unnamed or unsupported parameter `{raw.strip()}`"
+            ctype, pname = " ".join(parts[:-1]).replace("std::", ""), parts[-1]
+            if ctype not in self.C_SCALARS:
+                return f"parameter type `{raw.strip()}` is not generated"
+            params.append((pname, ctype, array))
+        if any(array for _, _, array in params) and not any(
+                not array and self.C_SCALARS[ctype] in "iu" and (pname.lower() in self.LENGTH_NAMES or
+                                                                 pname.lower().startswith(("len", "num", "size")))
+                for pname, ctype, array in params):
+            return "array parameter without a recognisable length parameter"
+        return ret, params
+
+    def _c_driver(self, original, corrected, name, ret, params, includes, language) -> str:
+        rename = re.compile(rf"\b{re.escape(name)}\s*\(")
+        versions = rename.sub(f"orig_{name}(", original) + "\n\n" + rename.sub(f"fixed_{name}(", corrected)
+        bench = 2000
+        lines = ["#include <stdio.h>", "#include <stdlib.h>", "#include <string.h>", "#include <math.h>",
+                 "#include <time.h>", "#include <stdbool.h>" if language == "c" else "", *includes, "",
+                 versions, "", f"#define CASES {self.CASES}", f"#define BENCH {bench}"]
+        for pname, ctype, array in params:
+            if array:
+                lines.append(f"static {ctype} a_{pname}[BENCH], b_{pname}[BENCH], p_{pname}[BENCH];")
+
+        def fill(size: str) -> List[str]:
+            body = []
+            for pname, ctype, array in params:
+                value = self._c_random(ctype)
+                if array:
+                    body.append(f"    for (size_t k = 0; k < {size}; k++) p_{pname}[k] = {value};")
+                elif pname.lower() in self.LENGTH_NAMES or pname.lower().startswith(("len", "num", "size")):
+                    body.append(f"    {ctype} v_{pname} = ({ctype}){size};")
+                else:
+                    body.append(f"    {ctype} v_{pname} = {value};")
+            return body
+
+        def reset(prefix: str, size: str) -> List[str]:
+            return [f"    memcpy({prefix}_{p}, p_{p}, {size} * sizeof({t}));" for p, t, array in params if array]
+
+        def call(version: str, prefix: str) -> str:
+            args = ", ".join(f"{prefix}_{p}" if array else f"v_{p}" for p, _, array in params)
+            return f"{version}_{name}({args})"
+
+        same = "1" if ret == "void" else ("(r1 == r2 || fabs((double)r1 - (double)r2) <= 1e-9 * fabs((double)r1) "
+                                          "|| (r1 != r1 && r2 != r2))" if self.C_SCALARS[ret] == "f" else "r1 == r2")
+        for pname, ctype, array in params:
+            if array:
+                same += f" && memcmp(a_{pname}, b_{pname}, n * sizeof({ctype})) == 0"
+        store = "" if ret == "void" else f"{ret} r1 = "
+        store2 = "" if ret == "void" else f"{ret} r2 = "
+        sink = "" if ret == "void" else "sink += (double)"
+        lines += [
+            "static volatile double sink;",
+            "static double per_call(int fixed, size_t n) {",
+            "    long reps = 1; double elapsed = 0;",
+            f"    srand({self.SEED + 1});  /* same inputs for both versions */",
+            *[line.replace("{size}", "n") for line in fill("n")],
+            "    for (;;) {",
+            "        clock_t start = clock();",
+            "        for (long r = 0; r < reps; r++) {",
+            *["    " + line for line in reset("a", "n")],
+            f"            if (fixed) {{ {sink}{call('fixed', 'a')}; }} else {{ {sink}{call('orig', 'a')}; }}",
+            "        }",
+            "        elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;",
+            "        if (elapsed >= 0.2 || reps >= (1L << 30)) break;",
+            "        reps *= elapsed > 0.02 ? 0.2 / elapsed + 1 : 10;",
+            "    }",
+            "    return elapsed / reps;",
+            "}",
+            "",
+            "int main(void) {",
+            f"    srand({self.SEED});",
+            "    int mismatches = 0;",
+            "    for (int c = 0; c < CASES; c++) {",
+            "    size_t n = (size_t)(c % 33);",
+            *fill("n"),
+            *reset("a", "n"), *reset("b", "n"),
+            f"    {store}{call('orig', 'a')};",
+            f"    {store2}{call('fixed', 'b')};",
+            f"    if (!({same})) {{",
+            "        if (!mismatches) printf(\"example inputs of length %zu\\n\", n);",
+            "        mismatches++;",
+            "    }",
+            "    }",
+            "    printf(\"cases %d\\nmismatches %d\\n\", CASES, mismatches);",
+            "    if (!mismatches) {",
+            "        double best[2] = {1e30, 1e30};",
+            "        for (int r = 0; r < 6; r++) {  /* interleaved, best of three each */",
+            "            double t = per_call(r & 1, BENCH);",
+            "            if (t < best[r & 1]) best[r & 1] = t;",
+            "        }",
+            "        printf(\"original %.12f\\ncorrected %.12f\\n\", best[0], best[1]);",
+            "        printf(\"bench_size %d\\n\", BENCH);" if any(array for _, _, array in params) else "",
+            "    }",
+            "    return 0;",
+            "}",
+        ]
+        return "\n".join(lines) + "\n"
+
+    def _c_random(self, ctype: str) -> str:
+        kind = self.C_SCALARS[ctype]
+        if kind == "f":
+            return f"({ctype})((rand() % 20001 - 10000) / 100.0)"
+        if kind == "b":
+            return "(rand() & 1)"
+        if ctype in ("char", "signed char", "unsigned char"):
+            return f"({ctype})(rand() % 26 + 'a')"
+        return f"({ctype})(rand() % 201{' - 100' if kind == 'i' else ''})"
+
+    # ── Sandbox ──────────────────────────────────────────────────────
+
+    def _sandboxed(self, command: List[str], workdir: Path) -> subprocess.CompletedProcess:
+        env = {"PATH": os.environ.get("PATH", ""), "PYTHONHASHSEED": "0", "HOME": str(workdir),
+               "TMPDIR": str(workdir), "LANG": "C.UTF-8"}
+        return subprocess.run(command, cwd=workdir, env=env, capture_output=True, text=True,
+                               timeout=self.TIMEOUT, stdin=subprocess.DEVNULL,
+                               preexec_fn=self._limits if os.name == "posix" else None)
+
+    def _limits(self):
+        import resource
+        for limit, value in ((resource.RLIMIT_CPU, self.CPU_SECONDS), (resource.RLIMIT_AS, self.MEMORY_BYTES),
+                             (resource.RLIMIT_FSIZE, self.FILE_BYTES), (resource.RLIMIT_CORE, 0)):
+            try:
+                resource.setrlimit(limit, (value, value))
+            except (ValueError, OSError):
+                pass
+
+    @staticmethod
+    def _parse_report(result: subprocess.CompletedProcess) -> VerificationResult:
+        """Harness/driver output: one `key value` pair per line (the Python harness prints JSON)."""
+        output = result.stdout.strip()
+        if result.returncode != 0:
+            tail = (result.stderr.strip().splitlines() or [f"exit status {result.returncode}"])[-1]
+            return VerificationResult("error", f"sandboxed run failed: {tail[:200]}")
+        if output.startswith("{"):
+            return VerificationResult(**json.loads(output.splitlines()[-1]))
+        values = dict(line.split(" ", 1) for line in output.splitlines() if " " in line)
+        cases, mismatches = int(values.get("cases", 0)), int(values.get("mismatches", 0))
+        return VerificationResult(
+            "different" if mismatches else "equivalent", cases=cases, mismatches=mismatches,
+            example=values.get("example", ""),
+            original_time=float(values["original"]) if "original" in values else None,
+            corrected_time=float(values["corrected"]) if "corrected" in values else None,
+            bench_size=int(values["bench_size"]) if "bench_size" in values else None)
+
+
+# ── Python harness (runs inside the sandbox) ─────────────────────────
+
+INT_NAMES = {"n", "k", "i", "j", "m", "count", "size", "num", "limit", "index", "idx", "start", "stop", "end",
+             "depth", "width", "height", "steps", "times", "length", "step", "offset", "x", "y"}
+STR_NAMES = {"s", "text", "string", "name", "word", "line", "prefix", "suffix", "key", "sep", "char", "sentence",
+             "content", "path", "label", "title"}
+LIST_NAMES = {"items", "values", "nums", "numbers", "xs", "ys", "arr", "array", "lst", "data", "seq", "elements",
+              "scores", "weights", "ids", "keys", "a", "b"}
+ALPHABET = "abcde fghij"      # small alphabet: repeats and shared prefixes are likely
+BENCH_SIZES = (2000, 200, 20)  # largest size whose original call stays under SLOW_CALL seconds is benchmarked
+SLOW_CALL = 0.5
+BENCH_SECONDS = 0.2            # target duration of one timed batch
+POOL_LIMIT = 1000              # most input copies held at once for a batch
+
+Gen = Callable[[random.Random, int], Any]
+
+
+def _from_annotation(node: Optional[ast.AST]) -> Optional[Gen]:
+    if node is None:
+        return None
+    if isinstance(node, ast.Constant) and node.value is None:
+        return lambda rng, size: None
+    if isinstance(node, ast.Constant) and isinstance(node.value, str):
+        try:
+            return _from_annotation(ast.parse(node.value, mode="eval").body)
+        except SyntaxError:
+            return None
+    if isinstance(node, ast.BinOp) and isinstance(node.op, ast.BitOr):
+        options = [_from_annotation(node.left), _from_annotation(node.right)]
+        return None if None in options else (lambda rng, size: rng.choice(options)(rng, size))
+    name = node.id if isinstance(node, ast.Name) else node.attr if isinstance(node, ast.Attribute) else None
+    if name is not None:
+        return {"int": lambda rng, size: rng.randint(-size, size),
+                "float": lambda rng, size: rng.uniform(-size, size),
+                "str": lambda rng, size: "".join(rng.choice(ALPHABET) for _ in range(rng.randint(0, size))),
+                "bytes": lambda rng, size: bytes(rng.randrange(256) for _ in range(rng.randint(0, size))),
+                "bool": lambda rng, size: rng.random() < 0.5,
+                "list": _list_of(_int_gen), "List": _list_of(_int_gen),
+                "dict": _dict_of(_str_gen, _int_gen), "Dict": _dict_of(_str_gen, _int_gen)}.get(name)
+    if isinstance(node, ast.Subscript):
+        base = node.value.id if isinstance(node.value, ast.Name) else getattr(node.value, "attr", "")
+        args = node.slice.elts if isinstance(node.slice, ast.Tuple) else [node.slice]
+        inner = [_from_annotation(a) if not (isinstance(a, ast.Constant) and a.value is Ellipsis) else ...
+                 for a in args]
+        if None in inner:
+            return None
+        base = base.lower()
+        if base == "optional":
+            return lambda rng, size: None if rng.random() < 0.1 else inner[0](rng, size)
+        if base in ("list", "sequence", "iterable", "collection", "mutablesequence"):
+            return _list_of(inner[0])
+        if base in ("set", "frozenset", "abstractset"):
+            return lambda rng, size: set(_list_of(inner[0])(rng, size))
+        if base in ("dict", "mapping", "mutablemapping") and len(inner) == 2:
+            return _dict_of(inner[0], inner[1])
+        if base == "tuple":
+            if len(inner) == 2 and inner[1] is ...:
+                return lambda rng, size: tuple(_list_of(inner[0])(rng, size))
+            return lambda rng, size: tuple(g(rng, size) for g in inner)
+    return None
+
+
+def _int_gen(rng, size):
+    return rng.randint(-size, size)
+
+
+def _str_gen(rng, size):
+    return "".join(rng.choice(ALPHABET) for _ in range(rng.randint(0, min(size, 12))))
+
+
+def _list_of(element: Gen) -> Gen:
+    return lambda rng, size: [element(rng, size) for _ in range(rng.randint(0, size))]
+
+
+def _dict_of(key: Gen, value: Gen) -> Gen:
+    return lambda rng, size: {key(rng, size): value(rng, size) for _ in range(rng.randint(0, size))}
+
+
+def _from_default(value: Any) -> Optional[Gen]:
+    if isinstance(value, bool):
+        return lambda rng, size: rng.random() < 0.5
+    if isinstance(value, int):
+        return lambda rng, size: rng.randint(0, max(size, abs(value)))
+    if isinstance(value, float):
+        return lambda rng, size: rng.uniform(0, max(size, abs(value)))
+    if isinstance(value, str):
+        return _str_gen
+    if isinstance(value, (list, tuple)):
+        element = _from_default(value[0]) if value else _int_gen
+        return element and (lambda rng, size: type(value)(_list_of(element)(rng, size)))
+    return None
+
+
+def _from_name(name: str) -> Optional[Gen]:
+    lowered = name.lower()
+    if lowered in INT_NAMES or lowered.startswith(("num_", "n_", "max_", "min_")):
+        return lambda rng, size: rng.randint(0, min(size, 25))  # ints often drive loop counts or recursion
+    if lowered in STR_NAMES or lowered.endswith(("_str", "_name", "text")):
+        return lambda rng, size: "".join(rng.choice(ALPHABET) for _ in range(rng.randint(0, size)))
+    if lowered in LIST_NAMES or lowered.endswith("s"):
+        return _list_of(_int_gen)
+    return None
+
+
+def _generators(func: ast.FunctionDef, defaults: Dict[str, Any]):
+    """(positional generators, keyword generators) or a reason string."""
+    positional, keyword = [], {}
+    args = func.args
+    for arg in args.posonlyargs + args.args:
+        gen = _from_annotation(arg.annotation) or (_from_default(defaults[arg.arg]) if arg.arg in defaults else None) \
+            or _from_name(arg.arg)
+        if gen is None:
+            return f"cannot generate inputs for parameter `{arg.arg}` (add a type annotation)"
+        positional.append(gen)
+    for arg in args.kwonlyargs:
+        if arg.arg in defaults:
+            continue  # keep keyword-only defaults
+        gen = _from_annotation(arg.annotation) or _from_name(arg.arg)
+        if gen is None:
+            return f"cannot generate inputs for parameter `{arg.arg}` (add a type annotation)"
+        keyword[arg.arg] = gen
+    return positional, keyword
+
+
+def _same(a: Any, b: Any) -> bool:
+    if isinstance(a, float) and isinstance(b, float):
+        return math.isclose(a, b, rel_tol=1e-9, abs_tol=1e-12) or (math.isnan(a) and math.isnan(b))
+    if isinstance(a, (list, tuple)) and isinstance(b, (list, tuple)) and type(a) == type(b):
+        return len(a) == len(b) and all(_same(x, y) for x, y in zip(a, b))
+    if isinstance(a, dict) and isinstance(b, dict):
+        return a.keys() == b.keys() and all(_same(a[k], b[k]) for k in a)
+    try:
+        return bool(a == b)
+    except Exception:
+        return repr(a) == repr(b)
+
+
+def _outcome(func, args, kwargs):
+    """(kind, value, arguments after the call): iterators are drained, exceptions compared by type."""
+    try:
+        value = func(*args, **kwargs)
+        if hasattr(value, "__next__") and not isinstance(value, (str, bytes)):
+            value = list(value)
+        return "value", value, (args, kwargs)
+    except Exception as e:
+        return "raise", type(e).__name__, (args, kwargs)
+
+
+def _short(value: Any) -> str:
+    text = repr(value)
+    return text if len(text) <= 60 else text[:57] + "..."
+
+
+def _load_namespace(module: Optional[str], sys_path: List[str]) -> Dict[str, Any]:
+    """The module's imports and literal constants; its other top-level statements never run."""
+    sys.path[:0] = sys_path
+    namespace = {"__name__": "__fix_verifier__", "__builtins__": __builtins__}
+    if not module:
+        return namespace
+    source = Path(module).read_text(encoding='utf-8')
+    namespace["__file__"] = module
+    for node in ast.parse(source).body:
+        if isinstance(node, (ast.Import, ast.ImportFrom)):
+            try:
+                exec(compile(ast.Module([node], []), module, "exec"), namespace)
+            except BaseException:
+                pass
+        elif isinstance(node, (ast.Assign, ast.AnnAssign)) and node.value is not None:
+            targets = node.targets if isinstance(node, ast.Assign) else [node.target]
+            try:
+                value = ast.literal_eval(node.value)
+            except (ValueError, TypeError, SyntaxError, MemoryError, RecursionError):
+                continue
+            for target in targets:
+                if isinstance(target, ast.Name):
+                    namespace[target.id] = value
+    return namespace
+
+
+def _define(namespace: Dict[str, Any], code: str, name: str):
+    """Define only the function itself (and the imports next to it), not other code the LLM returned."""
+    tree = ast.parse(code)
+    defs = [n for n in tree.body if isinstance(n, (ast.FunctionDef, ast.AsyncFunctionDef))]
+    target = next((n for n in defs if n.name == name), defs[0] if defs else None)
+    if target is None:
+        raise ValueError("no function definition in the code")
+    imports = [n for n in tree.body if isinstance(n, (ast.Import, ast.ImportFrom))]
+    exec(compile(ast.Module(imports + [target], []), "<fix>", "exec"), namespace)
+    return namespace[target.name], target
+
+
+def _time_per_call(func, args, kwargs) -> float:
+    """Best of three per-call times; inputs are copied before the clock starts, so in-place functions
+    see the same input on every call and the copying is not measured."""
+    def run(number):
+        pool = [copy.deepcopy((args, kwargs)) for _ in range(number)]
+        start = time.perf_counter()
+        for call_args, call_kwargs in pool:
+            _outcome(func, call_args, call_kwargs)
+        return (time.perf_counter() - start) / number
+
+    single = run(1)
+    number = max(1, min(POOL_LIMIT, int(BENCH_SECONDS / max(single, 1e-9))))
+    return min(run(number) for _ in range(3))
+
+
+def run_harness(payload_path: str) -> Dict[str, Any]:
+    payload = json.loads(Path(payload_path).read_text(encoding='utf-8'))
+    base = _load_namespace(payload["module"], payload["sys_path"])
+    try:
+        original, node = _define(dict(base), payload["original"], payload["name"])
+        corrected, fixed_node = _define(dict(base), payload["corrected"], payload["name"])
+    except (SyntaxError, ValueError) as e:
+        return {"status": "error", "reason": f"could not define both versions: {e}"}
+    except Exception as e:
+        return {"status": "error", "reason": f"defining a version raised {type(e).__name__}: {e}"}
+    if isinstance(node, ast.AsyncFunctionDef) or isinstance(fixed_node, ast.AsyncFunctionDef):
+        return {"status": "skipped", "reason": "async functions are not benchmarked"}
+    defaults = {}
+    params = node.args.posonlyargs + node.args.args
+    for arg, value in zip(params[len(params) - len(node.args.defaults):], original.__defaults__ or ()):
+        defaults[arg.arg] = value
+    defaults.update(original.__kwdefaults__ or {})
+    generators = _generators(node, defaults)
+    if isinstance(generators, str):
+        return {"status": "skipped", "reason": generators}
+    positional, keyword = generators
+
+    rng = random.Random(payload["seed"])
+    cases, mismatches, example, ran = payload["cases"], 0, "", 0
+    for case in range(cases):
+        size = case % 33
+        args = [gen(rng, size) for gen in positional]
+        kwargs = {k: gen(rng, size) for k, gen in keyword.items()}
+        first = _outcome(original, copy.deepcopy(args), copy.deepcopy(kwargs))
+        second = _outcome(corrected, copy.deepcopy(args), copy.deepcopy(kwargs))
+        ran += first[0] == "value"
+        if first[0] != second[0] or not _same(first[1], second[1]) or not _same(first[2], second[2]):
+            mismatches += 1
+            if not example:
+                shown = ", ".join([_short(a) for a in args] + [f"{k}={_short(v)}" for k, v in kwargs.items()])
+                example = (f"{payload['name']}({shown}) → {_short(first[1])} vs {_short(second[1])}"
+                           + (" (arguments mutated differently)" if _same(first[1], second[1]) else ""))
+    if mismatches:
+        return {"status": "different", "cases": cases, "mismatches": mismatches, "example": example}
+    if not ran:
+        return {"status": "skipped", "reason": "the original raised on every generated input", "cases": cases}
+
+    bench_rng = random.Random(payload["seed"] + 1)
+    for size in BENCH_SIZES:
+        args = [gen(bench_rng, size) for gen in positional]
+        kwargs = {k: gen(bench_rng, size) for k, gen in keyword.items()}
+        start = time.perf_counter()
+        _outcome(original, copy.deepcopy(args), copy.deepcopy(kwargs))
+        if time.perf_counter() - start < SLOW_CALL or size == BENCH_SIZES[-1]:
+            break
+    timings = {label: _time_per_call(func, args, kwargs)
+               for label, func in (("original", original), ("corrected", corrected))}
+    return {"status": "equivalent", "cases": cases, "original_time": timings["original"],
+            "corrected_time": timings["corrected"], "bench_size": size}
+
+
+if __name__ == "__main__":
+    report = run_harness(sys.argv[1])
+    sys.stdout.flush()
+    print(json.dumps(report))
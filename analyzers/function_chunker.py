@@ -0,0 +1,230 @@
+"""
+Function Chunker
+Splits oversized functions into auditable chunks along block boundaries.
+
+Blocks come from the Python AST or the Tree-sitter tree: top-level body
+statements, descending into any statement that is itself too large. Every
+chunk repeats a shared header (signature plus local declarations) and a
+few overlap lines from the previous chunk, and carries a line map back to
+the original function so findings can be remapped.
+"""
+
+import ast
+import textwrap
+from typing import List, Optional, Tuple
+
+try:
+    import tree_sitter_languages
+    TREESITTER_AVAILABLE = True
+except ImportError:
+    TREESITTER_AVAILABLE = False
+
+from utils.context_builder import ContextBuilder
+
+
+class FunctionChunk:
+    def __init__(self, text: str, line_map: List[Optional[int]], start: int, end: int):
+        self.text = text
+        self.line_map = line_map  # displayed line (0-based) -> function line (1-based), None for markers
+        self.start = start        # first/last function line (1-based) audited by this chunk
+        self.end = end
+
+    def remap(self, line: int) -> int:
+        """Chunk-relative line reported by the model → function-relative line."""
+        if isinstance(line, int) and 1 <= line <= len(self.line_map) and self.line_map[line - 1]:
+            return self.line_map[line - 1]
+        return self.start
+
+
+class FunctionChunker:
+    """Decides whether a function needs splitting and produces the chunks."""
+
+    MAX_FUNCTION_LINES = 200     # above this (or the token limit) a function is chunked
+    MAX_FUNCTION_TOKENS = 3000
+    CHUNK_LINES = 120            # target body lines per chunk
+    OVERLAP_LINES = 8            # trailing lines of the previous chunk repeated for continuity
+    HEADER_MAX_LINES = 40        # signature + local declarations cap
+
+    TS_LANGS = {'c': 'c', 'cpp': 'cpp', 'java': 'java'}
+    TS_FUNCTIONS = {'function_definition', 'method_declaration', 'constructor_declaration'}
+    TS_DECLARATIONS = {'declaration', 'local_variable_declaration'}
+
+    def __init__(self):
+        self._ts_parsers = {}
+
+    def needs_split(self, code: str) -> bool:
+        lines = code.count("\n") + 1
+        return (lines > self.MAX_FUNCTION_LINES
+                or ContextBuilder.estimate_tokens(code) > self.MAX_FUNCTION_TOKENS)
+
+    def split(self, code: str, language: str) -> List[FunctionChunk]:
+        lines = code.splitlines()
+        layout = None
+        if language == 'python':
+            layout = self._python_layout(code)
+        elif language in self.TS_LANGS:
+            layout = self._treesitter_layout(code, self.TS_LANGS[language])
+        if layout is None:
+            # No tree: fall back to fixed windows with the first line as header
+            layout = ([0], [], (1, len(lines) - 1), [])
+
+        header_lines, decl_lines, (body_start, body_end), segments = layout
+        segments = self._cover(segments, body_start, body_end)
+        comment = '#' if language == 'python' else '//'
+
+        chunks = []
+        current: List[Tuple[int, int]] = []
+        prev_end = None
+        for seg in segments:
+            size = sum(e - s + 1 for s, e in current)
+            if current and size + (seg[1] - seg[0] + 1) > self.CHUNK_LINES:
+                chunks.append(self._render(lines, header_lines, decl_lines, current, prev_end, comment))
+                prev_end = current[-1][1]
+                current = []
+            current.append(seg)
+        if current:
+            chunks.append(self._render(lines, header_lines, decl_lines, current, prev_end, comment))
+        if not chunks:
+            chunks.append(FunctionChunk(code, list(range(1, len(lines) + 1)), 1, len(lines)))
+        return chunks
+
+    # ── Layout: (header, declarations, body range, segments), 0-based lines ──
+
+    def _python_layout(self, code: str):
+        try:
+            tree = ast.parse(textwrap.dedent(code))
+        except SyntaxError:
+            return None
+        if not tree.body or not isinstance(tree.body[0], (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef)):
+            return None
+        func = tree.body[0]
+        body_start = func.body[0].lineno - 1
+        header = list(range(0, body_start))
+        decls = [stmt.lineno - 1 for stmt in func.body
+                 if isinstance(stmt, (ast.Assign, ast.AnnAssign)) and stmt.lineno == stmt.end_lineno]
+
+        def node_span(node):
+            return node.lineno - 1, node.end_lineno - 1
+
+        def children(node):
+            out = []
+            for name in ('body', 'orelse', 'handlers', 'finalbody', 'cases'):
+                out.extend(n for n in getattr(node, name, []) or [] if hasattr(n, 'lineno'))
+            return out
+
+        segments = []
+        for stmt in func.body:
+            segments.extend(self._segments(stmt, node_span, children))
+        return header, decls, (body_start, func.end_lineno - 1), segments
+
+    def _treesitter_layout(self, code: str, lang_id: str):
+        parser = self._get_ts_parser(lang_id)
+        if parser is None:
+            return None
+        offset = 0
+        source = code
+        if lang_id == 'java':
+            # Methods only parse inside a class body
+            source, offset = "class __Chunk {\n" + code + "\n}", 1
+        try:
+            root = parser.parse(bytes(source, "utf8")).root_node
+        except Exception:
+            return None
+
+        func = self._find_function(root)
+        body = func.child_by_field_name('body') if func is not None else None
+        if body is None:
+            return None
+        stmts = [c for c in body.named_children if c.type != 'comment']
+        if not stmts:
+            return None
+
+        def node_span(node):
+            return node.start_point[0] - offset, node.end_point[0] - offset
+
+        def children(node):
+            return [c for c in node.named_children if c.type != 'comment']
+
+        body_start = body.start_point[0] - offset + 1
+        header = list(range(0, body_start))
+        decls = [node_span(s)[0] for s in stmts
+                 if s.type in self.TS_DECLARATIONS and node_span(s)[0] == node_span(s)[1]]
+        segments = []
+        for stmt in stmts:
+            segments.extend(self._segments(stmt, node_span, children))
+        return header, decls, (body_start, body.end_point[0] - offset), segments
+
+    def _find_function(self, node):
+        if node.type in self.TS_FUNCTIONS:
+            return node
+        for child in node.named_children:
+            found = self._find_function(child)
+            if found is not None:
+                return found
+        return None
+
+    def _segments(self, node, node_span, children) -> List[Tuple[int, int]]:
+        """Line ranges for one statement, descending while it is larger than a chunk."""
+        start, end = node_span(node)
+        if end - start + 1 <= self.CHUNK_LINES:
+            return [(start, end)]
+        kids = children(node)
+        if not kids:
+            return [(s, min(s + self.CHUNK_LINES - 1, end)) for s in range(start, end + 1, self.CHUNK_LINES)]
+        out = []
+        for kid in kids:
+            out.extend(self._segments(kid, node_span, children))
+        return out
+
+    def _cover(self, segments, body_start: int, body_end: int) -> List[Tuple[int, int]]:
+        """Make segments contiguous over the body: gaps (comments, else-lines, braces) join the next one."""
+        segments = sorted((max(s, body_start), min(e, body_end)) for s, e in segments if e >= body_start)
+        if not segments:
+            return [(s, min(s + self.CHUNK_LINES - 1, body_end))
+                    for s in range(body_start, body_end + 1, self.CHUNK_LINES)]
+        covered, cursor = [], body_start
+        for s, e in segments:
+            if e < cursor:
+                continue
+            covered.append((cursor, e))
+            cursor = e + 1
+        if cursor <= body_end:
+            covered[-1] = (covered[-1][0], body_end)
+        return covered
+
+    # ── Rendering ────────────────────────────────────────────────────
+
+    def _render(self, lines, header_lines, decl_lines, segs, prev_end, comment) -> FunctionChunk:
+        start, end = segs[0][0], segs[-1][1]
+        header_end = (max(header_lines) + 1) if header_lines else 0
+        body_from = start
+        if prev_end is not None:
+            body_from = max(start - self.OVERLAP_LINES, header_end)
+
+        head = [i for i in header_lines if i < len(lines)]
+        head += [i for i in decl_lines if i < body_from and i not in head]
+        shown: List[Tuple[Optional[int], str]] = [(i, lines[i]) for i in sorted(head)[:self.HEADER_MAX_LINES]]
+
+        if shown and body_from > shown[-1][0] + 1:
+            first = lines[body_from] if body_from < len(lines) else ""
+            indent = first[:len(first) - len(first.lstrip())]
+            shown.append((None, f"{indent}{comment} ... lines {shown[-1][0] + 2}-{body_from} omitted ..."))
+        for i in range(body_from, min(end + 1, len(lines))):
+            shown.append((i, lines[i]))
+        if end + 1 < len(lines):
+            shown.append((None, f"{comment} ... lines {end + 2}-{len(lines)} omitted ..."))
+
+        text = "\n".join(line for _, line in shown)
+        line_map = [i + 1 if i is not None else None for i, _ in shown]
+        return FunctionChunk(text, line_map, start + 1, end + 1)
+
+    def _get_ts_parser(self, lang_id: str):
+        if not TREESITTER_AVAILABLE:
+            return None
+        if lang_id not in self._ts_parsers:
+            try:
+                self._ts_parsers[lang_id] = tree_sitter_languages.get_parser(lang_id)
+            except Exception as e:
+                print(f"Warning: Chunker has no Tree-sitter parser for {lang_id}: {e}")
+                self._ts_parsers[lang_id] = None
+        return self._ts_parsers[lang_id]
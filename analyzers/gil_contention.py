@@ -0,0 +1,276 @@
+"""
+GIL Contention Rule
+Finds CPU-bound Python work dispatched to threads, and locks held around
+CPU-heavy sections.
+
+Thread targets come from `threading.Thread(target=...)`, Thread subclasses'
+`run`, thread-pool `submit`/`map`, `run_in_executor` and `asyncio.to_thread`.
+Each target and its transitive callees (resolved call graph) get a static
+profile: arithmetic inside loops counts as CPU work, blocking calls
+(sockets, files, HTTP, DB, sleep, subprocess) as I/O. Pure-Python CPU work
+holds the GIL, so threads running it execute one at a time.
+"""
+
+import ast
+from typing import Dict, List, Optional, Set, Tuple
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class FunctionProfile:
+    def __init__(self, cpu: int = 0, io: int = 0):
+        self.cpu = cpu   # arithmetic operations inside loops, weighted by nesting depth
+        self.io = io     # blocking calls
+
+    def __iadd__(self, other: "FunctionProfile"):
+        self.cpu += other.cpu
+        self.io += other.io
+        return self
+
+
+class GILContentionRule(PerformanceRule):
+    name = "gil-contention"
+    description = "CPU-bound work on threads / locks around CPU-heavy code"
+
+    CPU_THRESHOLD = 2          # weighted loop arithmetic before work counts as CPU-bound (`total += i * i` in a loop)
+    CPU_TO_IO_RATIO = 8        # mixed work is reported when CPU dominates by this factor
+
+    IO_CALLS = {
+        'sleep', 'recv', 'recv_into', 'recvfrom', 'send', 'sendall', 'sendto', 'connect', 'accept',
+        'urlopen', 'open', 'read', 'readline', 'readlines', 'write', 'writelines', 'flush',
+        'execute', 'executemany', 'commit', 'fetchone', 'fetchall', 'fetchmany', 'select', 'poll',
+        'check_output', 'check_call', 'communicate', 'wait', 'getaddrinfo', 'input', 'print',
+    }
+    IO_MODULES = {'requests', 'httpx', 'urllib', 'socket', 'subprocess', 'sqlite3', 'psycopg2',
+                  'pymysql', 'redis', 'boto3', 'shutil', 'aiohttp'}
+    ARITHMETIC = (ast.Add, ast.Sub, ast.Mult, ast.Div, ast.FloorDiv, ast.Mod, ast.Pow,
+                  ast.LShift, ast.RShift, ast.BitXor, ast.BitAnd, ast.BitOr, ast.MatMult)
+    LOOPS = (ast.For, ast.AsyncFor, ast.While, ast.ListComp, ast.SetComp, ast.DictComp, ast.GeneratorExp)
+    THREAD_POOLS = {'ThreadPoolExecutor', 'ThreadPool'}
+    LOCK_FACTORIES = {'Lock', 'RLock', 'Condition', 'Semaphore', 'BoundedSemaphore'}
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        self._profiles: Dict[str, FunctionProfile] = {}
+        self._nodes = {}
+        for path in ctx.files(('.py',)):
+            for qname, node, owner in ctx.functions(path):
+                self._nodes[qname] = (path, node, owner)
+
+        findings = []
+        for path in ctx.files(('.py',)):
+            tree = ctx.module(path)
+            if tree is None:
+                continue
+            findings.extend(self._thread_targets(path, tree))
+            findings.extend(self._lock_sections(path, tree))
+        return findings
+
+    # ── Profiles ─────────────────────────────────────────────────────
+
+    def _local_profile(self, node: ast.AST) -> FunctionProfile:
+        """Profile of one function body (or lambda / with-block), callees excluded."""
+        profile = FunctionProfile()
+
+        def visit(n, depth):
+            for child in ast.iter_child_nodes(n):
+                if isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef)):
+                    continue
+                inner = depth
+                if isinstance(child, self.LOOPS):
+                    inner = depth + 1
+                if depth and isinstance(child, ast.BinOp) and isinstance(child.op, self.ARITHMETIC):
+                    profile.cpu += depth
+                elif depth and isinstance(child, ast.AugAssign) and isinstance(child.op, self.ARITHMETIC):
+                    profile.cpu += depth
+                elif isinstance(child, ast.Call) and self._is_io_call(child):
+                    profile.io += 1
+                visit(child, inner)
+
+        visit(node, 0)
+        return profile
+
+    def _is_io_call(self, call: ast.Call) -> bool:
+        name, receiver = PerformanceContext.call_name(call)
+        if receiver and receiver.split(".")[0] in self.IO_MODULES:
+            return True
+        return name in self.IO_CALLS
+
+    def _profile(self, qname: str) -> FunctionProfile:
+        if qname not in self._profiles:
+            entry = self._nodes.get(qname)
+            self._profiles[qname] = self._local_profile(entry[1]) if entry else FunctionProfile()
+        return self._profiles[qname]
+
+    def _transitive(self, qname: Optional[str], extra: Optional[ast.AST] = None) -> Tuple[FunctionProfile, List[str]]:
+        """Profile of a callable plus everything it reaches; also the hottest CPU contributors."""
+        total = FunctionProfile()
+        members: Set[str] = set()
+        if qname:
+            members = {qname} | self.ctx.callees(qname)
+        if extra is not None:
+            total += self._local_profile(extra)
+        for member in members:
+            total += self._profile(member)
+        hot = sorted((m for m in members if self._profile(m).cpu), key=lambda m: -self._profile(m).cpu)
+        return total, hot[:3]
+
+    def _classify(self, profile: FunctionProfile) -> Optional[str]:
+        if profile.cpu < self.CPU_THRESHOLD:
+            return None
+        if profile.io == 0:
+            return "cpu"
+        if profile.cpu >= self.CPU_TO_IO_RATIO * profile.io:
+            return "mostly-cpu"
+        return None
+
+    # ── Thread dispatch sites ────────────────────────────────────────
+
+    def _thread_targets(self, path: str, tree: ast.Module) -> List[PerformanceFinding]:
+        findings = []
+        pools = self._bound_names(tree, self.THREAD_POOLS)
+        enclosing = self._enclosing_functions(path)
+
+        for cls in (n for n in ast.walk(tree) if isinstance(n, ast.ClassDef)):
+            if any(self._base_name(b) == "Thread" for b in cls.bases):
+                target = self.ctx.hierarchy.lookup(cls.name, "run")
+                if target:
+                    findings.extend(self._report_target(path, cls.lineno, target.qualified_name, None,
+                                                        f"Thread subclass {cls.name}.run", ""))
+
+        for node in ast.walk(tree):
+            if not isinstance(node, ast.Call):
+                continue
+            name, receiver = PerformanceContext.call_name(node)
+            target_expr, how = None, None
+            if name == "Thread":
+                target_expr = next((k.value for k in node.keywords if k.arg == "target"), None)
+                how = "threading.Thread"
+            elif name in ("submit", "map") and receiver in pools and node.args:
+                target_expr, how = node.args[0], f"{receiver}.{name}"
+            elif name == "run_in_executor" and len(node.args) >= 2 and self._is_thread_executor(node.args[0], pools):
+                target_expr, how = node.args[1], "run_in_executor"
+            elif name == "to_thread" and node.args:
+                target_expr, how = node.args[0], "asyncio.to_thread"
+            if target_expr is None:
+                continue
+
+            caller, owner = enclosing.get(id(node), ("", None))
+            if isinstance(target_expr, ast.Lambda):
+                calls = [n for n in ast.walk(target_expr.body) if isinstance(n, ast.Call)]
+                qname = next((q for q in (self.ctx.resolve_callable(c.func, path, owner) for c in calls) if q), None)
+                findings.extend(self._report_target(path, node.lineno, qname, target_expr.body,
+                                                    f"lambda passed to {how}", caller))
+            else:
+                qname = self.ctx.resolve_callable(target_expr, path, owner)
+                if qname:
+                    findings.extend(self._report_target(path, node.lineno, qname, None,
+                                                        f"{qname.split('.')[-1]} passed to {how}", caller))
+        return findings
+
+    def _report_target(self, path, line, qname, extra, label, caller) -> List[PerformanceFinding]:
+        profile, hot = self._transitive(qname, extra)
+        kind = self._classify(profile)
+        if not kind:
+            return []
+        hot_names = ", ".join(h.split(".")[-1] for h in hot) or "the target"
+        if kind == "cpu":
+            message = (f"CPU-bound work runs on a thread ({label}): the loops in {hot_names} do Python "
+                       f"arithmetic with no blocking I/O, so the GIL lets only one such thread run at a time")
+            severity = "high"
+        else:
+            message = (f"Mostly CPU-bound work runs on a thread ({label}): {hot_names} dominate "
+                       f"its {profile.io} blocking call(s), so threads mostly wait on the GIL")
+            severity = "medium"
+        return [PerformanceFinding(
+            rule=self.name, file=path, line=line, function=caller,
+            message=message,
+            suggestion="Use ProcessPoolExecutor / multiprocessing for the CPU part, or move the hot loop "
+                       "to native code (NumPy, Cython, a C extension) that releases the GIL",
+            severity=severity,
+            details={"target": qname or "", "cpu_score": profile.cpu, "io_calls": profile.io, "hot": hot},
+        )]
+
+    # ── Lock-protected sections ──────────────────────────────────────
+
+    def _lock_sections(self, path: str, tree: ast.Module) -> List[PerformanceFinding]:
+        findings = []
+        locks = self._bound_names(tree, self.LOCK_FACTORIES)
+        for qname, func, owner in self.ctx.functions(path):
+            for node in PerformanceContext.walk_body(func):
+                if not isinstance(node, ast.With):
+                    continue
+                for item in node.items:
+                    text = self._expr_text(item.context_expr)
+                    if not text or not (text in locks or "lock" in text.split(".")[-1].lower()):
+                        continue
+                    block = ast.Module(body=node.body, type_ignores=[])
+                    profile = self._local_profile(block)
+                    callees: Set[str] = set()
+                    for call in (n for n in ast.walk(block) if isinstance(n, ast.Call)):
+                        target = self.ctx.resolve_callable(call.func, path, owner)
+                        if target:
+                            callees |= {target} | self.ctx.callees(target)
+                    for callee in callees:
+                        profile += self._profile(callee)
+                    if self._classify(profile) != "cpu":
+                        continue
+                    findings.append(PerformanceFinding(
+                        rule=self.name, file=path, line=node.lineno, function=qname,
+                        message=f"`with {text}:` holds the lock across CPU-heavy work "
+                                f"(weighted loop arithmetic {profile.cpu}); other threads block on both "
+                                f"the lock and the GIL for its whole duration",
+                        suggestion="Compute outside the critical section and take the lock only to publish "
+                                   "the result (or copy the shared state in, release, then compute)",
+                        severity="medium",
+                        details={"lock": text, "cpu_score": profile.cpu},
+                    ))
+        return findings
+
+    # ── Helpers ──────────────────────────────────────────────────────
+
+    def _enclosing_functions(self, path: str) -> Dict[int, Tuple[str, Optional[str]]]:
+        owners = {}
+        for qname, func, owner in self.ctx.functions(path):
+            for node in PerformanceContext.walk_body(func):
+                owners[id(node)] = (qname, owner)
+        return owners
+
+    def _bound_names(self, tree: ast.Module, factories: Set[str]) -> Set[str]:
+        """Names (incl. `self.x`) assigned from, or bound with `with ... as`, one of `factories`."""
+        names = set()
+        for node in ast.walk(tree):
+            pairs = []
+            if isinstance(node, ast.Assign):
+                pairs = [(t, node.value) for t in node.targets]
+            elif isinstance(node, ast.AnnAssign) and node.value is not None:
+                pairs = [(node.target, node.value)]
+            elif isinstance(node, (ast.With, ast.AsyncWith)):
+                pairs = [(i.optional_vars, i.context_expr) for i in node.items if i.optional_vars is not None]
+            for target, value in pairs:
+                if isinstance(value, ast.Call) and PerformanceContext.call_name(value)[0] in factories:
+                    text = self._expr_text(target)
+                    if text:
+                        names.add(text)
+        return names
+
+    def _is_thread_executor(self, node: ast.AST, pools: Set[str]) -> bool:
+        # None selects the loop's default executor, which is a thread pool
+        return (isinstance(node, ast.Constant) and node.value is None) or self._expr_text(node) in pools
+
+    @staticmethod
+    def _expr_text(node: ast.AST) -> Optional[str]:
+        if isinstance(node, ast.Name):
+            return node.id
+        if isinstance(node, ast.Attribute):
+            inner = GILContentionRule._expr_text(node.value)
+            return f"{inner}.{node.attr}" if inner else None
+        return None
+
+    @staticmethod
+    def _base_name(node: ast.AST) -> Optional[str]:
+        if isinstance(node, ast.Name):
+            return node.id
+        if isinstance(node, ast.Attribute):
+            return node.attr
+        return None
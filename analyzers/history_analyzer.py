@@ -0,0 +1,205 @@
+"""
+History Trend Analyzer
+Walks the last N commits and produces a per-commit time series of
+dead code, function cycles, structural duplicates and static findings.
+
+Only blobs that changed between consecutive commits are touched; parse
+results are cached by git blob ID (optionally on disk across runs) and
+the structural index is updated in place instead of rebuilt. The metrics
+follow the same deltas: dead code is re-tested only for changed files and
+names that gained their first or lost their last caller, only affected
+calls are re-resolved, and duplicate counts move with their buckets.
+"""
+
+import shelve
+import hashlib
+from pathlib import Path
+from typing import Dict, List, Any, Optional, Set, Tuple
+
+from core.git_repo import GitRepository
+from core.scanner import FileScanner
+from analyzers.structural_analyzer import StructuralAnalyzer
+from analyzers.cross_file_redundancy import CrossFileRedundancyDetector
+from analyzers.static_bug_detector import StaticBugDetector
+
+
+class HistoryAnalyzer:
+    """Incremental multi-commit analysis keyed on git blob IDs."""
+
+    CACHE_VERSION = 1
+
+    def __init__(self, repo_path: Path, cache_path: Optional[Path] = None):
+        self.repo = GitRepository(repo_path)
+        scanner = FileScanner(repo_path)
+        self.extensions = scanner.extensions
+        self.ignore_dirs = scanner.ignore_dirs
+
+        self.structural = StructuralAnalyzer()
+        self.redundancy = CrossFileRedundancyDetector(symbol_table=None)
+        self.static_detector = StaticBugDetector()
+        self.cache = shelve.open(str(cache_path)) if cache_path else {}
+
+        # Incremental state for the commit currently being looked at
+        self.current: Dict[str, Tuple[str, list]] = {}         # path -> (blob ID, fingerprints)
+        self.fp_buckets: Dict[str, Set[Tuple[str, str, str, int]]] = {}  # fingerprint -> functions
+        self.dup_groups = 0
+        self.dup_funcs = 0
+        self.dead: Set[str] = set()                             # "file:qualified_name"
+        self.static_by_path: Dict[str, int] = {}
+        self.stats = {"blobs_parsed": 0, "blobs_reused": 0}
+
+    # ── Main entry point ─────────────────────────────────────────────
+
+    def run(self, count: int, rev: str = "HEAD", progress=None) -> List[Dict[str, Any]]:
+        """Analyze the last `count` commits (oldest first)."""
+        series = []
+        prev_sha = None
+        prev_dead: Set[str] = set()
+        last_point = None
+
+        try:
+            for commit in self.repo.commits(count, rev):
+                if prev_sha is None:
+                    changes = list(self.repo.tree_blobs(commit.sha).items())
+                else:
+                    changes = self.repo.changed_blobs(prev_sha, commit.sha)
+                code_changes = [(p, sha) for p, sha in changes if self._wanted(p)]
+
+                parsed_before = self.stats["blobs_parsed"]
+                for path, sha in code_changes:
+                    if path in self.current:
+                        self._remove(path)
+                    if sha:
+                        self._add(path, sha)
+
+                if code_changes or last_point is None:
+                    self._update_dead([path for path, sha in code_changes if sha])
+                    self.structural.update_call_graph()
+                    dead = set(self.dead)
+                    last_point = {
+                        "files": len(self.current),
+                        "functions": len(self.structural.call_names_of),  # one entry per function symbol
+                        "dead_code": len(dead),
+                        "function_cycles": len(self.structural.reachability.cyclic_components()),
+                        "duplicate_groups": self.dup_groups,
+                        "duplicate_functions": self.dup_funcs,
+                        "static_findings": sum(self.static_by_path.values()),
+                    }
+                else:
+                    dead = prev_dead
+
+                point = {
+                    "commit": commit.sha,
+                    "timestamp": commit.timestamp,
+                    "subject": commit.subject,
+                    **last_point,
+                    "dead_code_added": sorted(dead - prev_dead) if prev_sha else [],
+                    "dead_code_removed": sorted(prev_dead - dead) if prev_sha else [],
+                    "changed_files": len(code_changes),
+                    "reparsed_blobs": self.stats["blobs_parsed"] - parsed_before,
+                }
+                series.append(point)
+                if progress:
+                    progress(point)
+
+                prev_sha = commit.sha
+                prev_dead = dead
+        finally:
+            self.repo.close()
+            if hasattr(self.cache, "close"):
+                self.cache.close()
+
+        return series
+
+    # ── Incremental index maintenance ────────────────────────────────
+
+    def _wanted(self, path: str) -> bool:
+        p = Path(path)
+        if p.suffix not in self.extensions:
+            return False
+        return not any(part in self.ignore_dirs for part in p.parts[:-1])
+
+    def _add(self, path: str, sha: str):
+        record = self._blob_record(path, sha)
+        self.current[path] = (sha, record["fingerprints"])
+        self.structural.index_file(Path(path), record["data"])
+        for fp, parent, name, line in record["fingerprints"]:
+            self._update_bucket(fp, lambda bucket: bucket.add((path, parent, name, line)))
+        self.static_by_path[path] = record["static_findings"]
+
+    def _remove(self, path: str):
+        _, fingerprints = self.current.pop(path)
+        for qname in self.structural.file_symbols.get(str(Path(path)), []):
+            self.dead.discard(f"{Path(path)}:{qname}")
+        self.structural.remove_file(Path(path))
+        for fp, parent, name, line in fingerprints:
+            self._update_bucket(fp, lambda bucket: bucket.discard((path, parent, name, line)))
+        self.static_by_path.pop(path, None)
+
+    def _update_dead(self, added: List[str]):
+        """Re-test functions of added files and every function named after a name whose caller count crossed zero."""
+        structural = self.structural
+        qnames = {qname for path in added for qname in structural.file_symbols.get(str(Path(path)), [])}
+        for name in structural.flipped_names:
+            qnames |= structural.functions_named.get(name, set())
+        structural.flipped_names.clear()
+        for qname in qnames:
+            sym = structural.symbol_table.symbols.get(qname)
+            if sym is None:
+                continue
+            key = f"{sym.file}:{qname}"
+            if structural._is_dead(sym):
+                self.dead.add(key)
+            else:
+                self.dead.discard(key)
+
+    def _blob_record(self, path: str, sha: str) -> Dict[str, Any]:
+        """Parse results for one blob; the extension is part of the key since it picks the parser."""
+        suffix = Path(path).suffix
+        key = f"v{self.CACHE_VERSION}:{sha}:{suffix}"
+        record = self.cache.get(key)
+        if record is not None:
+            self.stats["blobs_reused"] += 1
+            return record
+
+        code = self.repo.read_blob(sha)
+        data = self.structural.parser.parse(code, Path(path))
+
+        fingerprints = []
+        for func in data.get("functions", []):
+            body = func.get("body_code", "")
+            if (func["name"] in self.redundancy.SKIP_METHODS
+                    or len(body.strip().splitlines()) < self.redundancy.MIN_BODY_LINES):
+                continue
+            fp = self.redundancy._fingerprint(body, suffix)
+            if fp:
+                digest = hashlib.md5(fp.encode()).hexdigest()
+                fingerprints.append((digest, func.get("parent_class") or "", func["name"], func["line"]))
+
+        static_findings = len(self.static_detector.analyze_code(code)) if suffix == ".py" else 0
+
+        record = {"data": data, "fingerprints": fingerprints, "static_findings": static_findings}
+        self.cache[key] = record
+        self.stats["blobs_parsed"] += 1
+        return record
+
+    def _update_bucket(self, fp: str, change):
+        """Apply `change` to one fingerprint bucket, moving the running duplicate counts with it."""
+        bucket = self.fp_buckets.setdefault(fp, set())
+        groups, funcs = self._duplicate_weight(bucket)
+        change(bucket)
+        new_groups, new_funcs = self._duplicate_weight(bucket)
+        self.dup_groups += new_groups - groups
+        self.dup_funcs += new_funcs - funcs
+        if not bucket:
+            del self.fp_buckets[fp]
+
+    @staticmethod
+    def _duplicate_weight(members: Set[Tuple[str, str, str, int]]) -> Tuple[int, int]:
+        """(groups, functions) one bucket contributes: identical fingerprints, ignoring same-class siblings."""
+        if len(members) < 2:
+            return 0, 0
+        owners = {(path, parent) for path, parent, _, _ in members}
+        if len(owners) == 1 and next(iter(owners))[1]:
+            return 0, 0
+        return 1, len(members)
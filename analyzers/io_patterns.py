@@ -0,0 +1,320 @@
+"""
+I/O Pattern Rule
+Finds inefficient file and stream access from the parser's call-site data.
+
+Every call site carries its line, loop nesting and argument texts, so the
+checks are table lookups over (receiver, name, arguments, loop depth):
+files reopened on every iteration, small or unbuffered reads and writes in
+loops, per-iteration flush/fsync, whole-file reads that are then split into
+lines, stat/exists storms and C character-at-a-time stdio loops. Findings
+report loop depth and fan-in, and are prioritised by static hotness.
+"""
+
+import ast
+import re
+from collections import defaultdict
+from typing import Any, Dict, List, Optional
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class IOPatternRule(PerformanceRule):
+    name = "io-patterns"
+    description = "Inefficient file/stream I/O in loops"
+
+    SMALL_IO = 64                      # bytes per call at or below which a read/write counts as small
+    STORM_SITES = 3                    # stat-like calls in loops of one function that make it high severity
+
+    PY_OPEN_MODULES = {None, "io", "codecs", "gzip", "bz2", "lzma"}
+    PATH_OPEN = {"open", "read_text", "read_bytes", "write_text", "write_bytes"}
+    PY_STAT = {
+        "os.path": {"exists", "lexists", "isfile", "isdir", "islink", "getsize", "getmtime", "getctime",
+                    "getatime", "samefile"},
+        "os": {"stat", "lstat", "access"},
+        "path": {"exists", "lexists", "isfile", "isdir", "islink", "getsize", "getmtime"},
+    }
+    PATH_STAT = {"exists", "is_file", "is_dir", "is_symlink", "stat", "lstat"}
+
+    C_SUFFIXES = ('.c', '.h', '.cpp', '.cc', '.cxx', '.hpp', '.hh', '.hxx')
+    C_CHAR_IO = {"fgetc", "fputc", "getc", "putc", "getchar", "putchar", "fgetwc", "fputwc"}
+    C_STAT = {"stat", "lstat", "access", "faccessat", "fstatat"}
+    C_SYSCALL_IO = {"read": 2, "write": 2, "recv": 2, "send": 2, "pread": 2, "pwrite": 2}
+    C_UNBUFFERED = re.compile(r"\bsetvbuf\s*\([^;]*_IONBF")
+
+    JAVA_FILES_OPEN = {"readAllLines", "readAllBytes", "readString", "write", "writeString", "lines",
+                       "newBufferedReader", "newBufferedWriter", "newInputStream", "newOutputStream"}
+    JAVA_FILES_STAT = {"exists", "notExists", "isRegularFile", "isDirectory", "size", "getLastModifiedTime",
+                       "isReadable", "isWritable"}
+    JAVA_FILE_STAT = {"exists", "isFile", "isDirectory", "length", "lastModified", "canRead", "canWrite"}
+    JAVA_UNBUFFERED = {"FileInputStream", "FileOutputStream", "FileReader", "FileWriter", "RandomAccessFile"}
+    JAVA_WHOLE_FILE = {"readAllLines", "readAllBytes", "readString"}
+
+    _INT = re.compile(r"^\(?\s*(\d+)\s*\)?$")
+    _STRING = re.compile(r"""^[rbuRBU]{0,2}(['"])""")
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        findings = []
+        for path in ctx.files(('.py',)):
+            findings.extend(self._python(path))
+        for path in ctx.files(self.C_SUFFIXES):
+            findings.extend(self._native_c(path))
+        for path in ctx.files(('.java',)):
+            findings.extend(self._java(path))
+        return findings
+
+    # ── Python ───────────────────────────────────────────────────────
+
+    def _python(self, path: str) -> List[PerformanceFinding]:
+        findings = []
+        storms = defaultdict(list)
+        unbuffered = self._unbuffered_functions(path)
+        for qname, func, call in self.ctx.call_sites(path):
+            name, receiver, depth = call["name"], call.get("receiver"), call.get("loop_depth", 0)
+            args = call.get("args", [])
+            rtype = call.get("receiver_type") or ""
+            is_path = "Path" in rtype or (receiver or "").endswith("Path()")
+
+            if depth and ((name == "open" and receiver in self.PY_OPEN_MODULES) or
+                          (is_path and name in self.PATH_OPEN)):
+                target = args[0] if receiver in self.PY_OPEN_MODULES and args else receiver
+                if self._invariant(target):
+                    findings.append(self._reopen(path, qname, call, f"{target}"))
+
+            elif depth and name in ("flush", "fsync"):
+                findings.append(self._flush(path, qname, call, f"{receiver}.{name}()" if receiver else name))
+            elif depth and name == "print" and receiver is None and "flush=True" in args:
+                findings.append(self._flush(path, qname, call, "print(..., flush=True)"))
+
+            elif depth and receiver == "os" and name in ("read", "write"):
+                size = self._int_arg(args, 1) if name == "read" else self._literal_len(args, 1)
+                if size is not None and size <= self.SMALL_IO:
+                    findings.append(self._small_io(path, qname, call, f"os.{name}", size, syscall=True))
+            elif depth and name in ("recv", "read") and receiver:
+                size = self._int_arg(args, 0)
+                if size is not None and size <= self.SMALL_IO:
+                    syscall = name == "recv" or qname in unbuffered
+                    findings.append(self._small_io(path, qname, call, f"{receiver}.{name}", size, syscall))
+            elif depth and name == "write" and rtype == "open()" and qname in unbuffered:
+                findings.append(self._small_io(path, qname, call, f"{receiver}.write", None, syscall=True))
+
+            elif name == "readlines" and receiver and not args:
+                findings.append(self._whole_file(
+                    path, qname, call, f"{receiver}.readlines()",
+                    "Iterate the file object (`for line in f:`) to stream lines instead of materialising them"))
+            elif name in ("splitlines", "split") and receiver and \
+                    re.search(r"\.(read|read_text|read_bytes)\(\)$", receiver) and \
+                    (name == "splitlines" or args[:1] in ([], ["'\\n'"], ['"\\n"'])):
+                findings.append(self._whole_file(
+                    path, qname, call, f"{receiver}.{name}()",
+                    "Iterate the open file (`for line in f:`) so only one line is held in memory at a time"))
+
+            elif depth and (name in self.PY_STAT.get(receiver, ()) or (is_path and name in self.PATH_STAT)):
+                storms[qname].append((call, f"{receiver}.{name}()"))
+
+        for qname, sites in storms.items():
+            findings.append(self._stat_storm(
+                path, qname, sites,
+                "Scan the directory once with `os.scandir()` (DirEntry caches the stat result) or list it into "
+                "a set and test membership; cache results that repeat across iterations"))
+        return findings
+
+    def _unbuffered_functions(self, path: str) -> set:
+        """Functions that open a file with `buffering=0` (every read/write is a system call)."""
+        found = set()
+        for qname, _, call in self.ctx.call_sites(path):
+            args = call.get("args", [])
+            if call["name"] == "open" and call.get("receiver") in self.PY_OPEN_MODULES and \
+                    ("buffering=0" in args or (len(args) > 2 and args[2] == "0")):
+                found.add(qname)
+        return found
+
+    # ── C / C++ ──────────────────────────────────────────────────────
+
+    def _native_c(self, path: str) -> List[PerformanceFinding]:
+        findings = []
+        unbuffered = bool(self.C_UNBUFFERED.search(self.ctx.source(path)))
+        char_loops = defaultdict(list)
+        storms = defaultdict(list)
+        for qname, func, call in self.ctx.call_sites(path):
+            name, receiver, depth = call["name"], call.get("receiver"), call.get("loop_depth", 0)
+            if not depth or receiver not in (None, "std"):
+                continue
+            args = call.get("args", [])
+            if name in self.C_CHAR_IO:
+                char_loops[qname].append(call)
+            elif name in ("fopen", "open", "freopen") and args and self._invariant(args[0]):
+                findings.append(self._reopen(path, qname, call, args[0]))
+            elif name in ("fflush", "fsync", "fdatasync"):
+                findings.append(self._flush(path, qname, call, f"{name}()"))
+            elif name in self.C_SYSCALL_IO:
+                size = self._int_arg(args, self.C_SYSCALL_IO[name])
+                if size is not None and size <= self.SMALL_IO:
+                    findings.append(self._small_io(path, qname, call, name, size, syscall=True))
+            elif name in ("fread", "fwrite") and len(args) >= 3:
+                size, count = self._int_arg(args, 1), self._int_arg(args, 2)
+                if size is not None and count is not None and size * count <= self.SMALL_IO:
+                    findings.append(self._small_io(path, qname, call, name, size * count, syscall=unbuffered))
+            elif name in self.C_STAT:
+                storms[qname].append((call, f"{name}()"))
+
+        for qname, calls in char_loops.items():
+            depth = max(c.get("loop_depth", 0) for c in calls)
+            names = ", ".join(sorted({c["name"] for c in calls}))
+            fan_in = self.ctx.hotness.fan_in(qname)
+            severity = "high" if unbuffered else "medium"
+            why = ("the stream is unbuffered (`setvbuf(..., _IONBF, ...)`), so each character is a system call"
+                   if unbuffered else "each character pays a locked stdio call")
+            findings.append(PerformanceFinding(
+                rule=self.name, file=path, line=calls[0].get("line", 0), function=qname,
+                message=f"Character-at-a-time I/O ({names}) in a loop: {why} "
+                        f"(loop depth {depth}, fan-in {fan_in})",
+                suggestion="Read/write blocks with fread/fwrite (or fgets) into a buffer and loop over the "
+                           "buffer; keep stdio buffered, and use getc_unlocked/putc_unlocked if per-char "
+                           "access must stay",
+                severity=severity,
+                priority=self.ctx.priority(severity, qname, depth),
+                details=self._details(qname, depth, calls=len(calls), unbuffered=unbuffered),
+            ))
+        for qname, sites in storms.items():
+            findings.append(self._stat_storm(
+                path, qname, sites,
+                "Read the directory once (readdir/std::filesystem::directory_iterator, whose entries cache "
+                "file type) or open the file and handle ENOENT instead of testing first"))
+        return findings
+
+    # ── Java ─────────────────────────────────────────────────────────
+
+    def _java(self, path: str) -> List[PerformanceFinding]:
+        findings = []
+        storms = defaultdict(list)
+        for qname, func, call in self.ctx.call_sites(path):
+            name, receiver, depth = call["name"], call.get("receiver"), call.get("loop_depth", 0)
+            args = call.get("args", [])
+            rtype = call.get("receiver_type") or ""
+            if receiver == "Files" and name in self.JAVA_WHOLE_FILE:
+                findings.append(self._whole_file(
+                    path, qname, call, f"Files.{name}()",
+                    "Stream with `Files.lines()` (in try-with-resources) or a BufferedReader"))
+            if not depth:
+                continue
+            if receiver == "Files" and name in self.JAVA_FILES_OPEN and args and \
+                    (self._invariant(args[0]) or re.search(r'"[^"]*"', args[0])):
+                findings.append(self._reopen(path, qname, call, args[0]))
+            elif receiver == "Files" and name in self.JAVA_FILES_STAT:
+                storms[qname].append((call, f"Files.{name}()"))
+            elif rtype == "File" and name in self.JAVA_FILE_STAT:
+                storms[qname].append((call, f"{receiver}.{name}()"))
+            elif name == "flush" and receiver:
+                findings.append(self._flush(path, qname, call, f"{receiver}.flush()"))
+            elif rtype in self.JAVA_UNBUFFERED and ((name == "read" and not args) or
+                                                    (name == "write" and len(args) == 1)):
+                findings.append(self._small_io(path, qname, call, f"{rtype}.{name}", 1, syscall=True))
+
+        for qname, sites in storms.items():
+            findings.append(self._stat_storm(
+                path, qname, sites,
+                "List the directory once (`Files.newDirectoryStream`, `Files.walk` with attributes) or read "
+                "`BasicFileAttributes` once per file instead of separate exists/size/time calls"))
+        return findings
+
+    # ── Findings ─────────────────────────────────────────────────────
+
+    def _finding(self, path, qname, call, severity, message, suggestion, **details) -> PerformanceFinding:
+        depth = call.get("loop_depth", 0)
+        fan_in = self.ctx.hotness.fan_in(qname)
+        return PerformanceFinding(
+            rule=self.name, file=path, line=call.get("line", 0), function=qname,
+            message=f"{message} (loop depth {depth}, fan-in {fan_in})",
+            suggestion=suggestion,
+            severity=severity,
+            priority=self.ctx.priority(severity, qname, depth),
+            details=self._details(qname, depth, **details),
+        )
+
+    def _details(self, qname: str, depth: int, **extra) -> Dict[str, Any]:
+        return {"loop_depth": depth, "fan_in": self.ctx.hotness.fan_in(qname),
+                "estimated_calls": round(10 ** self.ctx.hotness.heat(qname, depth)), **extra}
+
+    def _reopen(self, path, qname, call, target) -> PerformanceFinding:
+        depth = call.get("loop_depth", 0)
+        return self._finding(
+            path, qname, call, "high" if depth > 1 else "medium",
+            f"`{target}` is opened on every loop iteration; each open pays path lookup, a file "
+            f"descriptor and a fresh buffer",
+            "Open it once before the loop (keep the handle, or collect the data and write it in one go)",
+            target=target)
+
+    def _flush(self, path, qname, call, text) -> PerformanceFinding:
+        durable = "sync" in call["name"]
+        return self._finding(
+            path, qname, call, "high" if durable else "medium",
+            f"`{text}` inside a loop {'forces a disk sync' if durable else 'empties the buffer'} on every "
+            f"iteration",
+            "Flush (or fsync) once after the loop, or every N records/seconds if progress must be visible",
+            site=text)
+
+    def _small_io(self, path, qname, call, text, size: Optional[int], syscall: bool) -> PerformanceFinding:
+        cost = "a system call" if syscall else "a full call through the buffered I/O stack"
+        if size is None:
+            message = f"`{text}` on an unbuffered file inside a loop; each call is {cost}"
+        else:
+            message = f"`{text}` moves {size} byte{'s' if size != 1 else ''} per call inside a loop; each call is {cost}"
+        return self._finding(
+            path, qname, call, "high" if syscall else "medium",
+            message,
+            "Read/write in blocks of 64 KiB (or the whole record) and split in memory; keep the "
+            "stream buffered",
+            site=text, bytes_per_call=size, syscall=syscall)
+
+    def _whole_file(self, path, qname, call, text, suggestion) -> PerformanceFinding:
+        depth = call.get("loop_depth", 0)
+        return self._finding(
+            path, qname, call, "medium" if depth else "low",
+            f"`{text}` loads the whole file into memory before processing it line by line; memory grows "
+            f"with file size and nothing is processed until the read completes",
+            suggestion, site=text)
+
+    def _stat_storm(self, path, qname, sites, suggestion) -> PerformanceFinding:
+        calls = [c for c, _ in sites]
+        depth = max(c.get("loop_depth", 0) for c in calls)
+        names = ", ".join(sorted({text for _, text in sites}))
+        severity = "high" if depth > 1 or len(calls) >= self.STORM_SITES else "medium"
+        first = min(calls, key=lambda c: c.get("line", 0))
+        return self._finding(
+            path, qname, dict(first, loop_depth=depth), severity,
+            f"{len(calls)} metadata call site(s) inside loops ({names}); each is a stat() system call per "
+            f"iteration",
+            suggestion, calls=len(calls))
+
+    # ── Argument helpers ─────────────────────────────────────────────
+
+    @classmethod
+    def _invariant(cls, text: Optional[str]) -> bool:
+        """Loop-invariant file target: a string literal, a constant or an attribute like `self.log_path`."""
+        if not text:
+            return False
+        if cls._STRING.match(text) and "{" not in text:
+            return True
+        root = text.split(".")[0]
+        if root == "self":
+            return "(" not in text and "[" not in text
+        return root.isupper() and root.replace("_", "").isalnum()
+
+    @classmethod
+    def _int_arg(cls, args: List[str], index: int) -> Optional[int]:
+        """Integer literal at `index`, None if absent or not a literal."""
+        if not 0 <= index < len(args):
+            return None
+        match = cls._INT.match(args[index].strip())
+        return int(match.group(1)) if match else None
+
+    @classmethod
+    def _literal_len(cls, args: List[str], index: int) -> Optional[int]:
+        """Length of a string/bytes literal at `index`, None if it is not a literal."""
+        if not 0 <= index < len(args) or not cls._STRING.match(args[index]):
+            return None
+        try:
+            return len(ast.literal_eval(args[index]))
+        except (ValueError, SyntaxError):
+            return None
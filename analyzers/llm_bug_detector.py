@@ -6,7 +6,9 @@ Uses vLLM (Qwen2.5-Coder) for semantic bug detection.
 from pathlib import Path
 from typing import List, Dict
 import json
+import asyncio
 from utils.llm_utils import extract_json, robust_json_load
+from analyzers.function_chunker import FunctionChunker
 
 class SemanticBug:
     def __init__(self, bug_type: str, severity: str, line: int, description: str, suggestion: str):
@@ -21,8 +23,12 @@ class LLMBugDetector:
     Detects semantic bugs using LLM inference.
     """
     
+    CHUNK_CONCURRENCY = 4   # chunks of one oversized symbol audited in parallel
+    SEVERITY_RANK = {"critical": 0, "high": 1, "medium": 2, "low": 3}
+
     def __init__(self, llm_client):
         self.llm_client = llm_client
+        self.chunker = FunctionChunker()
     
     async def analyze_symbol(
         self, 
@@ -38,8 +44,15 @@ class LLMBugDetector:
     ) -> tuple[List[SemanticBug], str]:
         """
         Analyze a specific symbol (function/method) with focused context.
+        Oversized symbols are audited in chunks (no corrected_code then).
         Returns: (List[SemanticBug], corrected_code)
         """
+        if self.chunker.needs_split(code):
+            bugs = await self._analyze_chunked(
+                symbol_name, code, language, file_path, dependency_hints, global_vars, imports_list
+            )
+            return bugs, ""
+
         prompt = self._build_focused_prompt(
             symbol_name, code, language, file_path.name, 
             class_context, dependency_hints, global_vars, imports_list
@@ -51,28 +64,90 @@ class LLMBugDetector:
             print("[bold blue]--------------------------------------------------[/bold blue]\n")
             
         try:
-            response = await self.llm_client.generate_completion(prompt, temperature=0.1)
-            result = robust_json_load(response)
-            
-            if not result or not result.get("issues"):
-                return [], ""
-            
-            bugs = []
-            for issue in result.get("issues", []):
-                bugs.append(SemanticBug(
-                    bug_type=issue.get("type", "bug"),
-                    severity=issue.get("severity", "medium"),
-                    line=issue.get("line", 0),
-                    description=issue.get("description", ""),
-                    suggestion=issue.get("suggestion", "")
-                ))
-            
-            corrected_code = result.get("corrected_code", "")
-            return bugs, corrected_code
+            return await self._run_prompt(prompt)
         except Exception as e:
+            if self._is_context_overflow(e):
+                print(f"Focused analysis of {symbol_name} exceeded the model context; retrying in chunks")
+                bugs = await self._analyze_chunked(
+                    symbol_name, code, language, file_path, dependency_hints, global_vars, imports_list,
+                    force=True
+                )
+                return bugs, ""
             print(f"Focused analysis failed for {symbol_name}: {e}")
             return [], ""
 
+    async def _run_prompt(self, prompt: str) -> tuple[List[SemanticBug], str]:
+        response = await self.llm_client.generate_completion(prompt, temperature=0.1)
+        result = robust_json_load(response)
+        
+        if not result or not result.get("issues"):
+            return [], ""
+        
+        bugs = []
+        for issue in result.get("issues", []):
+            bugs.append(SemanticBug(
+                bug_type=issue.get("type", "bug"),
+                severity=issue.get("severity", "medium"),
+                line=issue.get("line", 0),
+                description=issue.get("description", ""),
+                suggestion=issue.get("suggestion", "")
+            ))
+        
+        return bugs, result.get("corrected_code", "")
+
+    @staticmethod
+    def _is_context_overflow(error: Exception) -> bool:
+        text = str(error).lower()
+        return any(marker in text for marker in (
+            "maximum context length", "context length", "too many tokens", "prompt is too long", "max_model_len"
+        ))
+
+    # ── Oversized symbols: map (chunk audits) → reduce (merge + dedupe) ──
+
+    async def _analyze_chunked(
+        self, symbol_name: str, code: str, language: str, file_path: Path,
+        dependency_hints: str, global_vars: str, imports_list: str, force: bool = False
+    ) -> List[SemanticBug]:
+        chunks = self.chunker.split(code, language)
+        if len(chunks) == 1 and force:
+            # Not splittable along blocks; halve the chunk size once
+            saved = self.chunker.CHUNK_LINES
+            self.chunker.CHUNK_LINES = max(20, (code.count("\n") + 1) // 2)
+            chunks = self.chunker.split(code, language)
+            self.chunker.CHUNK_LINES = saved
+
+        semaphore = asyncio.Semaphore(self.CHUNK_CONCURRENCY)
+
+        async def audit(idx, chunk):
+            label = f"{symbol_name} (part {idx}/{len(chunks)}, lines {chunk.start}-{chunk.end})"
+            prompt = self._build_focused_prompt(
+                label, chunk.text, language, file_path.name,
+                "", dependency_hints, global_vars, imports_list
+            )
+            async with semaphore:
+                try:
+                    bugs, _ = await self._run_prompt(prompt)
+                except Exception as e:
+                    print(f"Chunk audit failed for {label} in {file_path.name}: {e}")
+                    return []
+            for bug in bugs:
+                bug.line = chunk.remap(bug.line)
+            return bugs
+
+        results = await asyncio.gather(*(audit(i, c) for i, c in enumerate(chunks, 1)))
+        return self._merge_findings([bug for bugs in results for bug in bugs])
+
+    def _merge_findings(self, bugs: List[SemanticBug]) -> List[SemanticBug]:
+        """Overlapping chunks report the same issue twice: keep one per (line, type), most severe wins."""
+        merged: Dict[tuple, SemanticBug] = {}
+        for bug in bugs:
+            key = (bug.line, (bug.type or "").lower())
+            kept = merged.get(key)
+            if kept is None or (self.SEVERITY_RANK.get(bug.severity.lower(), 9)
+                                < self.SEVERITY_RANK.get(kept.severity.lower(), 9)):
+                merged[key] = bug
+        return sorted(merged.values(), key=lambda b: b.line if isinstance(b.line, int) else 0)
+
     def _build_focused_prompt(
         self, name: str, code: str, lang: str, file: str, 
         class_ctx: str, dep_hints: str, global_vars: str, imports: str
@@ -0,0 +1,138 @@
+"""
+Logging Cost Rule
+Finds log calls on hot paths whose message is built before the logger
+decides whether to emit it.
+
+Python `logger.debug(f"...")`, `"..." % x` and `.format()` messages and
+Java `log.debug("..." + x)` are formatted even when the level is disabled;
+C/C++ `printf`-family calls format on every iteration and `<< std::endl`
+flushes the stream per line. A call is on a hot path when the hotness index
+estimates it runs at least once per loop iteration somewhere (its own loop
+or a caller's) or its function is widely called; priority comes from the
+same estimate. Functions that test the level (`isEnabledFor`,
+`isDebugEnabled`, ...) anywhere in their body count as guarded.
+"""
+
+import re
+from typing import List, Optional
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class LoggingCostRule(PerformanceRule):
+    name = "logging-cost"
+    description = "Eagerly formatted log messages on hot paths"
+
+    HOT_FAN_IN = 5                 # callers from which a function counts as hot on its own
+    HOT_HEAT = 1.0                 # ... or log10 of estimated executions of the call site (one loop level)
+
+    LOGGER = re.compile(r"(?:^|\.)_*(?:log|logger|logging|getLogger\(\))$", re.I)
+    # Levels usually disabled in production: formatting them is pure waste
+    QUIET_LEVELS = {"debug", "trace", "fine", "finer", "finest", "verbose"}
+    LEVELS = QUIET_LEVELS | {"info", "warning", "warn", "error", "critical", "exception", "log"}
+    GUARDS = re.compile(r"\b(?:isEnabledFor|is(?:Debug|Trace|Info)Enabled|isLoggable|getEffectiveLevel)\b")
+
+    PY_EAGER = [
+        ("f-string", re.compile(r"^[rR]?[fF]['\"]")),
+        ("%-formatting", re.compile(r"^['\"].*['\"]\s*%\s*\S")),
+        ("str.format()", re.compile(r"^['\"].*['\"]\.format\(")),
+        ("concatenation", re.compile(r"^['\"].*['\"]\s*\+|\+\s*(?:str\()?['\"]")),
+    ]
+    JAVA_EAGER = [
+        ("string concatenation", re.compile(r"\"\s*\+|\+\s*\"")),
+        ("String.format()", re.compile(r"^String\.format\(")),
+    ]
+    C_PRINTF = {"printf", "fprintf", "sprintf", "snprintf", "vprintf", "vfprintf", "syslog", "dprintf",
+                "wprintf", "fwprintf"}
+    C_SUFFIXES = ('.c', '.h', '.cpp', '.cc', '.cxx', '.hpp', '.hh', '.hxx')
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        findings = []
+        checks = ((('.py',), self._python), (('.java',), self._java), (self.C_SUFFIXES, self._native))
+        for suffixes, check in checks:
+            for path in ctx.files(suffixes):
+                guarded = {}
+                for qname, func, call in ctx.call_sites(path):
+                    if qname not in guarded:
+                        guarded[qname] = bool(self.GUARDS.search(func.get("body_code", "")))
+                    if not self._hot(qname, call):
+                        continue
+                    finding = check(path, qname, call, guarded[qname])
+                    if finding:
+                        findings.append(finding)
+        return findings
+
+    def _hot(self, qname: str, call: dict) -> bool:
+        return self.ctx.hotness.heat(qname, call.get("loop_depth", 0)) >= self.HOT_HEAT or \
+            self.ctx.hotness.fan_in(qname) >= self.HOT_FAN_IN
+
+    # ── Per language ─────────────────────────────────────────────────
+
+    def _python(self, path, qname, call, guarded) -> Optional[PerformanceFinding]:
+        receiver, level, args = call.get("receiver") or "", call["name"], call.get("args", [])
+        if level not in self.LEVELS or not self.LOGGER.search(receiver) or not args:
+            return None
+        message = args[1] if level == "log" and len(args) > 1 else args[0]
+        kind = next((label for label, pattern in self.PY_EAGER if pattern.search(message)), None)
+        if kind is None or (guarded and level in self.QUIET_LEVELS):
+            return None
+        quiet = level in self.QUIET_LEVELS
+        return self._finding(
+            path, qname, call, "medium" if quiet else "low",
+            f"`{receiver}.{level}()` builds its message with {kind} before the logger checks the level"
+            + (f"; with {level.upper()} disabled the formatting is thrown away" if quiet else ""),
+            "Pass the template and arguments separately (`logger.debug(\"x=%s\", x)`) so formatting happens "
+            "only for emitted records; wrap costly argument computation in `if logger.isEnabledFor(...)`",
+            kind)
+
+    def _java(self, path, qname, call, guarded) -> Optional[PerformanceFinding]:
+        receiver, level, args = call.get("receiver") or "", call["name"], call.get("args", [])
+        if level not in self.LEVELS or not self.LOGGER.search(receiver) or not args or guarded:
+            return None
+        kind = next((label for label, pattern in self.JAVA_EAGER if pattern.search(args[0])), None)
+        if kind is None:
+            return None
+        quiet = level in self.QUIET_LEVELS
+        return self._finding(
+            path, qname, call, "medium" if quiet else "low",
+            f"`{receiver}.{level}()` builds its message with {kind} without an `is{level.title()}Enabled()` "
+            f"guard; the string is built even when the level is off",
+            "Use parameterised messages (`log.debug(\"x={}\", x)`), a `Supplier` lambda, or guard with "
+            f"`if ({receiver}.is{level.title()}Enabled())`",
+            kind)
+
+    def _native(self, path, qname, call, guarded) -> Optional[PerformanceFinding]:
+        depth = call.get("loop_depth", 0)
+        if not depth:
+            return None  # formatting is the point of a printf; only per-iteration cost is reported
+        if call["name"] == "operator<<":
+            return self._finding(
+                path, qname, call, "medium",
+                f"`{call.get('receiver')} << {call['args'][0]}` inside a loop flushes the stream on every "
+                f"line, turning buffered output into one write per iteration",
+                "Write '\\n' instead and flush once after the loop (std::cerr is unbuffered already)",
+                "std::endl")
+        if call["name"] in self.C_PRINTF and call.get("receiver") in (None, "std"):
+            return self._finding(
+                path, qname, call, "low",
+                f"`{call['name']}` formats a message on every loop iteration",
+                "Move diagnostics out of the loop, accumulate and print a summary, or compile them out "
+                "(`#ifdef DEBUG`/a level check) on release builds",
+                call["name"])
+        return None
+
+    # ── Findings ─────────────────────────────────────────────────────
+
+    def _finding(self, path, qname, call, severity, message, suggestion, kind) -> PerformanceFinding:
+        depth = call.get("loop_depth", 0)
+        fan_in = self.ctx.hotness.fan_in(qname)
+        estimated = round(10 ** self.ctx.hotness.heat(qname, depth))
+        return PerformanceFinding(
+            rule=self.name, file=path, line=call.get("line", 0), function=qname,
+            message=f"{message} (loop depth {depth}, fan-in {fan_in}, ~{estimated:,} calls per run)",
+            suggestion=suggestion,
+            severity=severity,
+            priority=self.ctx.priority(severity, qname, depth),
+            details={"kind": kind, "loop_depth": depth, "fan_in": fan_in, "estimated_calls": estimated},
+        )
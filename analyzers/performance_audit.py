@@ -0,0 +1,42 @@
+"""
+Performance Audit
+Runs every performance rule pack over the structural phase's results and
+ranks the findings.
+"""
+
+from typing import List, Optional
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+from analyzers.gil_contention import GILContentionRule
+from analyzers.regex_backtracking import RegexBacktrackingRule
+from analyzers.io_patterns import IOPatternRule
+from analyzers.slots_memory import SlotsMemoryRule
+from analyzers.sequential_await import SequentialAwaitRule
+from analyzers.cpp_containers import ContainerChoiceRule
+from analyzers.logging_cost import LoggingCostRule
+from analyzers.resource_churn import ResourceChurnRule
+
+
+class PerformanceAudit:
+    """Registry of rule packs; `run` returns findings, highest priority first."""
+
+    RULES = [GILContentionRule, RegexBacktrackingRule, IOPatternRule, SlotsMemoryRule,
+             SequentialAwaitRule, ContainerChoiceRule, LoggingCostRule, ResourceChurnRule]
+
+    def __init__(self, structural, rules: Optional[List[PerformanceRule]] = None):
+        self.structural = structural
+        self.rules = rules if rules is not None else [rule() for rule in self.RULES]
+
+    def run(self) -> List[PerformanceFinding]:
+        ctx = PerformanceContext(self.structural)
+        findings = []
+        for rule in self.rules:
+            try:
+                findings.extend(rule.analyze(ctx))
+            except Exception as e:
+                print(f"Warning: Performance rule {rule.name} failed: {e}")
+        for finding in findings:
+            if not finding.priority:
+                finding.priority = ctx.priority(finding.severity, finding.function)
+        findings.sort(key=lambda f: (-f.priority, f.file, f.line))
+        return findings
@@ -0,0 +1,178 @@
+"""
+Performance Rules
+Shared model for the performance audit: the finding type, the per-run
+context every rule reads from, and the rule base class.
+
+The context reuses the structural phase: parse results, the resolved call
+graph with its reachability index, the class hierarchy and a hotness index
+(fan-in and loop-weighted call frequency) used for priorities. Python module
+ASTs are parsed once on demand and their function nodes are keyed by the
+same qualified names the symbol table uses.
+"""
+
+import ast
+import math
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Dict, Iterator, List, Optional, Set, Tuple
+
+from core.class_hierarchy import ClassHierarchy
+from core.hotness import HotnessIndex
+from core.ast_parser import StructuralParser
+from core.symbol_table import SymbolType
+
+
+SEVERITY_WEIGHT = {"high": 3.0, "medium": 2.0, "low": 1.0}
+
+
+@dataclass
+class PerformanceFinding:
+    rule: str
+    file: str
+    line: int
+    function: str                 # qualified name of the enclosing function, "" at module level
+    message: str
+    suggestion: str
+    severity: str = "medium"      # high / medium / low
+    priority: float = 0.0         # severity weighted by static hotness; higher first
+    details: Dict[str, Any] = field(default_factory=dict)
+
+
+class PerformanceContext:
+    """Everything a rule needs, computed once per audit."""
+
+    def __init__(self, structural):
+        self.structural = structural
+        self.hierarchy = ClassHierarchy.build(structural.file_data_map, structural.symbol_table)
+        self.hotness = HotnessIndex(structural.call_graph)
+        self._modules: Dict[str, Optional[ast.Module]] = {}
+        self._sources: Dict[str, str] = {}
+        self._functions: Dict[str, List[Tuple[str, ast.AST, Optional[str]]]] = {}
+
+    def files(self, suffixes: Tuple[str, ...]) -> List[str]:
+        return sorted(p for p in self.structural.file_data_map if Path(p).suffix.lower() in suffixes)
+
+    def source(self, path: str) -> str:
+        if path not in self._sources:
+            try:
+                self._sources[path] = Path(path).read_text(encoding='utf-8')
+            except (OSError, UnicodeDecodeError):
+                self._sources[path] = ""
+        return self._sources[path]
+
+    def module(self, path: str) -> Optional[ast.Module]:
+        if path not in self._modules:
+            try:
+                self._modules[path] = ast.parse(self.source(path))
+            except SyntaxError:
+                self._modules[path] = None
+        return self._modules[path]
+
+    def functions(self, path: str) -> List[Tuple[str, ast.AST, Optional[str]]]:
+        """(qualified name, def node, enclosing class) for every def in a Python file."""
+        if path in self._functions:
+            return self._functions[path]
+        found = []
+        tree = self.module(path)
+        stem = Path(path).stem
+
+        def visit(node, current_class):
+            for child in ast.iter_child_nodes(node):
+                if isinstance(child, ast.ClassDef):
+                    visit(child, child.name)
+                elif isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef)):
+                    # Same naming as the parser: nested defs keep the enclosing class
+                    qname = f"{stem}.{current_class}.{child.name}" if current_class else f"{stem}.{child.name}"
+                    found.append((qname, child, current_class))
+                    visit(child, current_class)
+                else:
+                    visit(child, current_class)
+
+        if tree is not None:
+            visit(tree, None)
+        self._functions[path] = found
+        return found
+
+    def call_sites(self, path: str) -> Iterator[Tuple[str, Dict[str, Any], Dict[str, Any]]]:
+        """(qualified name, function data, call) for every call site the parser recorded in `path`."""
+        data = self.structural.file_data_map.get(path) or {}
+        for func in data.get("functions", []):
+            qname = self.qualified_name(path, func)
+            for call in func.get("calls_detailed", []):
+                yield qname, func, call
+
+    @staticmethod
+    def qualified_name(path: str, func: Dict[str, Any]) -> str:
+        """Symbol-table name of a parsed function: `module.Class.method` or `module.function`."""
+        stem = Path(path).stem
+        parent = func.get("parent_class")
+        return f"{stem}.{parent}.{func['name']}" if parent else f"{stem}.{func['name']}"
+
+    # ── Call graph ───────────────────────────────────────────────────
+
+    def priority(self, severity: str, qname: str, loop_depth: int = 0, scale: float = 1.0) -> float:
+        """
+        Severity weight scaled by the estimated execution count (orders of magnitude) of the site.
+        `scale` corrects the count when a rule knows better than the default iterations per loop.
+        """
+        heat = max(self.hotness.heat(qname, loop_depth) + math.log10(max(scale, 1e-3)), 0.0)
+        return SEVERITY_WEIGHT.get(severity, 1.0) * (1.0 + heat)
+
+    def callees(self, qname: str) -> Set[str]:
+        """Functions transitively called from `qname` (resolved edges only)."""
+        return self.structural.reachability.descendants(qname)
+
+    def resolve_callable(self, node: ast.AST, path: str, owner: Optional[str]) -> Optional[str]:
+        """Qualified name of a function reference such as `work`, `self.work` or `Cls.work`."""
+        if isinstance(node, ast.Name):
+            candidates = [s for s in self.structural.symbol_table.find_symbols_by_name(node.id)
+                          if s.type == SymbolType.FUNCTION and not s.parent_name]
+            same_file = [s for s in candidates if str(s.file) == path]
+            chosen = (same_file or candidates or [None])[0]
+            return chosen.qualified_name if chosen else None
+        if isinstance(node, ast.Attribute):
+            receiver = StructuralParser._py_receiver_text(node.value)
+            cls = self.hierarchy.receiver_class(receiver, None, owner)
+            if cls is None and self.hierarchy.has_class(receiver):
+                cls = receiver
+            target = self.hierarchy.lookup(cls, node.attr) if cls else None
+            return target.qualified_name if target else None
+        if isinstance(node, ast.Call) and node.args:
+            # functools.partial(work, ...)
+            func = node.func
+            if (isinstance(func, ast.Name) and func.id == "partial") or \
+                    (isinstance(func, ast.Attribute) and func.attr == "partial"):
+                return self.resolve_callable(node.args[0], path, owner)
+        return None
+
+    # ── AST helpers ──────────────────────────────────────────────────
+
+    @staticmethod
+    def walk_body(node: ast.AST) -> Iterator[ast.AST]:
+        """Like ast.walk, but does not enter nested function or class definitions."""
+        stack = list(ast.iter_child_nodes(node))
+        while stack:
+            child = stack.pop()
+            yield child
+            if not isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef)):
+                stack.extend(ast.iter_child_nodes(child))
+
+    @staticmethod
+    def call_name(call: ast.Call) -> Tuple[Optional[str], Optional[str]]:
+        """(called name, receiver text) for `f()` / `a.b.f()`."""
+        func = call.func
+        if isinstance(func, ast.Name):
+            return func.id, None
+        if isinstance(func, ast.Attribute):
+            return func.attr, StructuralParser._py_receiver_text(func.value)
+        return None, None
+
+
+class PerformanceRule:
+    """Base class: one rule pack, producing findings from the shared context."""
+
+    name = ""
+    description = ""
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        raise NotImplementedError
@@ -0,0 +1,269 @@
+"""
+Redundancy Threshold Calibration
+Replays the fingerprint, similarity and tree-edit stages of the duplicate
+detector over a labelled set of function pairs and picks the thresholds
+(AST_SIMILARITY_THRESHOLD, AUTO_CONFIRM_THRESHOLD, MIN_BODY_LINES and the
+tree-edit reject cutoff) that keep recall while sending the fewest pairs
+to the LLM.
+
+The LLM stage itself is not run: every pair that would be escalated is
+counted as one LLM call and assumed to be decided correctly.
+"""
+
+import json
+import difflib
+from pathlib import Path
+from typing import Dict, List, Any, Optional
+
+from core.ast_parser import StructuralParser
+from analyzers.cross_file_redundancy import CrossFileRedundancyDetector
+from analyzers.tree_edit_distance import TreeEditVerifier
+
+
+REPO_ROOT = Path(__file__).resolve().parent.parent
+
+# (file_a, function_a, file_b, function_b, is_duplicate), paths relative to the repo root.
+# Unlabelled pairs between functions of the labelled files count as non-duplicates.
+BUILTIN_LABELS = [
+    ("tests/04_redundancy/duplicate_a.py", "process_data",
+     "tests/04_redundancy/duplicate_b.py", "transform_list", True),
+    ("tests/04_redundancy/logic_match.py", "iterative_sum_squares",
+     "tests/04_redundancy/logic_match.py", "recursive_sum_squares", True),
+    ("tests/04_redundancy/duplicate_a.py", "process_data",
+     "tests/04_redundancy/structural_distractor.py", "process_data_v3", False),
+    ("tests/04_redundancy/duplicate_b.py", "transform_list",
+     "tests/04_redundancy/structural_distractor.py", "process_data_v3", False),
+    ("syntax_test/redundancy_part1.py", "calculate_area_circle",
+     "syntax_test/redundancy_part2.py", "compute_field_size", True),
+    ("syntax_test/redundancy_part1.py", "factorial_recursive",
+     "syntax_test/redundancy_part2.py", "get_combinations_count", True),
+]
+
+AST_GRID = [round(0.05 * i, 2) for i in range(2, 19)]   # 0.10 … 0.90
+AUTO_CONFIRM_GRID = [0.85, 0.90, 0.95, 1.01]            # 1.01 = never auto-confirm
+MIN_LINES_GRID = [1, 2, 3, 4, 5]
+TED_REJECT_GRID = [0.0, 0.15, 0.30, 0.45]              # 0.0 = tree edit never rejects
+
+
+class LabelledPair:
+    def __init__(self, key_a: str, key_b: str, is_duplicate: bool, explicit: bool = True):
+        self.key_a = key_a
+        self.key_b = key_b
+        self.is_duplicate = is_duplicate
+        self.explicit = explicit
+        # Filled in by the calibrator
+        self.similarity = 0.0
+        self.min_lines = 0
+        self.ted_duplicate = False
+        self.ted_similarity = None  # None: no tree (escalated regardless of cutoff)
+
+
+class RedundancyCalibrator:
+    """Grid search over the detector thresholds on a labelled pair set."""
+
+    def __init__(self, target_recall: float = 1.0, max_false_accepts: int = 0):
+        self.target_recall = target_recall
+        self.max_false_accepts = max_false_accepts
+        self.parser = StructuralParser()
+        self.detector = CrossFileRedundancyDetector(symbol_table=None)
+        # Reject cutoff 0 disables pruning so the exact similarity is known for every cutoff
+        self.ted = TreeEditVerifier()
+        self.ted.REJECT_SIMILARITY = 0.0
+        self.functions: Dict[str, Dict[str, Any]] = {}  # "path::qualified" -> {body, suffix, lines, parent}
+        self.pairs: List[LabelledPair] = []
+
+    # ── Label loading ────────────────────────────────────────────────
+
+    def load_builtin(self):
+        for file_a, func_a, file_b, func_b, is_dup in BUILTIN_LABELS:
+            self._add_label(REPO_ROOT / file_a, func_a, REPO_ROOT / file_b, func_b, is_dup)
+
+    def load_labels_file(self, path: Path):
+        """
+        User labels, JSON:
+          {"pairs": [{"a": "src/x.py::func", "b": "src/y.py::Class.method", "duplicate": true}, ...]}
+        Paths are relative to the labels file.
+        """
+        path = Path(path)
+        with open(path, 'r', encoding='utf-8') as f:
+            data = json.load(f)
+        for entry in data.get("pairs", []):
+            try:
+                file_a, func_a = entry["a"].split("::", 1)
+                file_b, func_b = entry["b"].split("::", 1)
+                is_dup = bool(entry["duplicate"])
+            except (KeyError, ValueError, AttributeError):
+                print(f"Warning: Skipping malformed label in {path}: {entry}")
+                continue
+            self._add_label(path.parent / file_a, func_a, path.parent / file_b, func_b, is_dup)
+
+    def _add_label(self, file_a: Path, func_a: str, file_b: Path, func_b: str, is_dup: bool):
+        key_a = self._load_function(file_a, func_a)
+        key_b = self._load_function(file_b, func_b)
+        if not key_a or not key_b:
+            return
+        self._drop_pair(key_a, key_b)
+        self.pairs.append(LabelledPair(key_a, key_b, is_dup))
+
+    def _drop_pair(self, key_a: str, key_b: str):
+        wanted = {key_a, key_b}
+        self.pairs = [p for p in self.pairs if {p.key_a, p.key_b} != wanted]
+
+    def _load_function(self, file_path: Path, name: str) -> Optional[str]:
+        file_path = file_path.resolve()
+        if not any(k.startswith(f"{file_path}::") for k in self.functions):
+            try:
+                code = file_path.read_text(encoding='utf-8', errors='replace')
+            except OSError as e:
+                print(f"Warning: Cannot read {file_path}: {e}")
+                return None
+            data = self.parser.parse(code, file_path)
+            for func in data.get("functions", []):
+                parent = func.get("parent_class") or ""
+                qualified = f"{parent}.{func['name']}" if parent else func["name"]
+                body = func.get("body_code", "")
+                self.functions[f"{file_path}::{qualified}"] = {
+                    "name": func["name"],
+                    "body": body,
+                    "suffix": file_path.suffix,
+                    "lines": len(body.strip().splitlines()),
+                    "parent": parent,
+                }
+        key = f"{file_path}::{name}"
+        if key not in self.functions:
+            print(f"Warning: Function {name} not found in {file_path}")
+            return None
+        return key
+
+    def _close_world(self):
+        """Every unlabelled pair among the loaded functions is a negative."""
+        labelled = {frozenset((p.key_a, p.key_b)) for p in self.pairs}
+        keys = sorted(k for k, f in self.functions.items()
+                      if f["name"] not in CrossFileRedundancyDetector.SKIP_METHODS)
+        for i, key_a in enumerate(keys):
+            for key_b in keys[i + 1:]:
+                fa, fb = self.functions[key_a], self.functions[key_b]
+                if fa["parent"] and fa["parent"] == fb["parent"] and key_a.split("::")[0] == key_b.split("::")[0]:
+                    continue  # the detector never compares methods of the same class
+                if frozenset((key_a, key_b)) not in labelled:
+                    self.pairs.append(LabelledPair(key_a, key_b, False, explicit=False))
+
+    # ── Stage replay ─────────────────────────────────────────────────
+
+    def _score_pairs(self):
+        fingerprints = {}
+        for key, func in self.functions.items():
+            try:
+                fingerprints[key] = self.detector._fingerprint(func["body"], func["suffix"])
+            except Exception:
+                fingerprints[key] = ""
+
+        for pair in self.pairs:
+            fa, fb = self.functions[pair.key_a], self.functions[pair.key_b]
+            fp1, fp2 = fingerprints[pair.key_a], fingerprints[pair.key_b]
+            pair.min_lines = min(fa["lines"], fb["lines"])
+            pair.similarity = difflib.SequenceMatcher(None, fp1, fp2).ratio() if fp1 and fp2 else 0.0
+            if pair.similarity >= AST_GRID[0]:
+                decision, pair.ted_similarity = self.ted.verify(
+                    fa["body"], fa["suffix"], fb["body"], fb["suffix"]
+                )
+                pair.ted_duplicate = decision == "duplicate"
+
+    def evaluate(self, ast_threshold: float, auto_threshold: float, min_lines: int,
+                 ted_reject: float) -> Dict[str, Any]:
+        """Outcome of one threshold setting (LLM assumed to decide escalated pairs correctly)."""
+        positives = sum(1 for p in self.pairs if p.is_duplicate)
+        found = false_accepts = llm_calls = candidates = 0
+        for pair in self.pairs:
+            if pair.min_lines < min_lines or pair.similarity < ast_threshold:
+                continue
+            candidates += 1
+            if pair.similarity >= auto_threshold or pair.ted_duplicate:
+                accepted = True
+            elif pair.ted_similarity is not None and pair.ted_similarity <= ted_reject:
+                accepted = False
+            else:
+                llm_calls += 1
+                accepted = pair.is_duplicate
+            if accepted and pair.is_duplicate:
+                found += 1
+            elif accepted:
+                false_accepts += 1
+        return {
+            "AST_SIMILARITY_THRESHOLD": ast_threshold,
+            "AUTO_CONFIRM_THRESHOLD": auto_threshold,
+            "MIN_BODY_LINES": min_lines,
+            "TED_REJECT_SIMILARITY": ted_reject,
+            "candidates": candidates,
+            "llm_calls": llm_calls,
+            "found": found,
+            "false_accepts": false_accepts,
+            "recall": found / positives if positives else 1.0,
+        }
+
+    def calibrate(self) -> Dict[str, Any]:
+        """Run the grid search; returns the chosen setting, the recall/LLM-call curve and a summary."""
+        self._close_world()
+        self._score_pairs()
+
+        grid = [self.evaluate(a, c, m, t) for t in TED_REJECT_GRID for m in MIN_LINES_GRID
+                for c in AUTO_CONFIRM_GRID for a in AST_GRID]
+        allowed = [r for r in grid if r["false_accepts"] <= self.max_false_accepts] or grid
+        best_recall = max(r["recall"] for r in allowed)
+        floor = min(self.target_recall, best_recall)
+        eligible = [r for r in allowed if r["recall"] >= floor]
+        # Fewest LLM calls; ties go to the most permissive filter so unseen code keeps recall
+        chosen = min(eligible, key=lambda r: (r["llm_calls"], r["AST_SIMILARITY_THRESHOLD"],
+                                              -r["AUTO_CONFIRM_THRESHOLD"], r["MIN_BODY_LINES"],
+                                              r["TED_REJECT_SIMILARITY"]))
+
+        curve = [r for r in grid
+                 if r["AUTO_CONFIRM_THRESHOLD"] == chosen["AUTO_CONFIRM_THRESHOLD"]
+                 and r["MIN_BODY_LINES"] == chosen["MIN_BODY_LINES"]
+                 and r["TED_REJECT_SIMILARITY"] == chosen["TED_REJECT_SIMILARITY"]]
+        baseline = self.evaluate(CrossFileRedundancyDetector.AST_SIMILARITY_THRESHOLD,
+                                 CrossFileRedundancyDetector.AUTO_CONFIRM_THRESHOLD,
+                                 CrossFileRedundancyDetector.MIN_BODY_LINES,
+                                 TreeEditVerifier.REJECT_SIMILARITY)
+        return {
+            "chosen": chosen,
+            "baseline": baseline,
+            "curve": curve,
+            "labelled_pairs": sum(1 for p in self.pairs if p.explicit),
+            "positives": sum(1 for p in self.pairs if p.is_duplicate),
+            "negatives": sum(1 for p in self.pairs if not p.is_duplicate),
+            "functions": len(self.functions),
+        }
+
+    # ── Output ───────────────────────────────────────────────────────
+
+    @staticmethod
+    def render_curve(curve: List[Dict[str, Any]], chosen: Dict[str, Any], width: int = 40) -> List[str]:
+        """ASCII plot: one row per AST threshold, bar = LLM calls, recall on the right."""
+        most = max((r["llm_calls"] for r in curve), default=0) or 1
+        lines = [f"{'AST thr':>7} │ {'LLM calls':<{width + 6}}│ recall"]
+        for r in curve:
+            bar = "█" * round(width * r["llm_calls"] / most)
+            marker = " ◀ chosen" if r is chosen else ""
+            lines.append(f"{r['AST_SIMILARITY_THRESHOLD']:>7.2f} │ {bar:<{width}}{r['llm_calls']:>5} │ "
+                         f"{r['recall']:>6.0%}{marker}")
+        return lines
+
+    @staticmethod
+    def write_config(result: Dict[str, Any], path: Path):
+        chosen = result["chosen"]
+        config = {
+            "thresholds": {key: chosen[key] for key in CrossFileRedundancyDetector.THRESHOLD_KEYS},
+            "calibration": {
+                "recall": chosen["recall"],
+                "llm_calls": chosen["llm_calls"],
+                "false_accepts": chosen["false_accepts"],
+                "labelled_pairs": result["labelled_pairs"],
+                "positives": result["positives"],
+                "negatives": result["negatives"],
+                "curve": [{k: r[k] for k in ("AST_SIMILARITY_THRESHOLD", "llm_calls", "recall")}
+                          for r in result["curve"]],
+            },
+        }
+        with open(path, 'w', encoding='utf-8') as f:
+            json.dump(config, f, indent=2)
@@ -0,0 +1,622 @@
+"""
+Regex Backtracking Rule
+Finds regular expressions with super-linear worst-case matching time (ReDoS).
+
+Regex literals are collected from Python `re`/`regex` calls, C++
+`std::regex` constructions and Java `Pattern`/`String` regex methods, and
+parsed with Python's own regex parser (the C++ ECMAScript and Java dialects
+agree with it on everything the checks look at). On the parse tree:
+
+  - exponential: a repeat whose body matches both `s` and `ss` (nested
+    quantifiers such as `(a+)+`, `(\\w+\\s?)*`) or has alternatives matching
+    the same string (`(a|a)*`), followed by something that can fail
+  - polynomial O(n^k): k adjacent unbounded repeats over overlapping
+    characters; an unanchored search adds one degree when the text before a
+    repeat can itself be consumed by it (every start position re-scans)
+
+Each candidate gets an attack string (prefix + pump * n + failing suffix).
+It is matched in a subprocess under TIME_BUDGET with growing n, because a
+catastrophic match cannot be interrupted in-process; the timings decide
+whether the blow-up is confirmed. All dialects are checked with Python's
+backtracking engine, which behaves like libstdc++ and java.util.regex here.
+"""
+
+import ast
+import json
+import re
+import subprocess
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, FrozenSet, Iterator, List, Optional, Tuple
+
+try:
+    import re._parser as sre_parse
+    import re._compiler as sre_compile
+except ImportError:  # Python < 3.11
+    import sre_parse
+    import sre_compile
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+@dataclass
+class RegexLiteral:
+    pattern: str
+    flags: int
+    mode: str           # "search", "match" or "fullmatch": how the engine anchors it
+    line: int
+    function: str
+    api: str            # e.g. "re.search", "std::regex", "Pattern.compile"
+
+
+@dataclass
+class Backtracking:
+    complexity: str     # "exponential" or "polynomial"
+    degree: int         # k of O(n^k); 0 for exponential
+    construct: str
+    prefix: str
+    pump: str
+    suffix: str = ""
+
+    @property
+    def label(self) -> str:
+        return "exponential O(2^n)" if self.complexity == "exponential" else f"polynomial O(n^{self.degree})"
+
+    def attack(self, n: int) -> str:
+        return self.prefix + self.pump * n + self.suffix
+
+    def attack_text(self, n: int) -> str:
+        parts = [repr(self.prefix)] if self.prefix else []
+        parts.append(f"{self.pump!r} * {n}")
+        if self.suffix:
+            parts.append(repr(self.suffix))
+        return " + ".join(parts)
+
+
+# Runs in a child process: a catastrophic match cannot be interrupted in-process
+_PROBE = """
+import json, re, sys, time
+spec = json.loads(sys.stdin.read())
+run = getattr(re.compile(spec["pattern"], spec["flags"]), spec["mode"])
+for n in spec["sizes"]:
+    text = spec["prefix"] + spec["pump"] * n + spec["suffix"]
+    start = time.perf_counter()
+    run(text)
+    print(json.dumps([n, time.perf_counter() - start]), flush=True)
+"""
+
+
+class RegexBacktrackingRule(PerformanceRule):
+    name = "redos"
+    description = "Regexes with exponential or polynomial backtracking"
+
+    TIME_BUDGET = 2.0           # seconds per confirmation subprocess
+    MAX_CONFIRMATIONS = 25      # subprocess checks per audit; later candidates stay unconfirmed
+    LARGE_REPEAT = 16           # bounded repeats at least this wide backtrack like unbounded ones
+    EXP_SIZES = [8, 12, 16, 20, 24, 28, 32]
+    POLY_SIZES = [500, 1000, 2000, 4000, 8000, 16000]
+    EXP_GROWTH = 4.0            # time factor per +4 pump repetitions
+    POLY_GROWTH = 3.0           # time factor per doubling (quadratic ~ 4)
+    MIN_SECONDS = 0.01          # timings below this are noise
+
+    PY_MODULES = {"re", "regex"}
+    PY_FUNCTIONS = {   # function -> (flags argument position, mode)
+        "compile": (1, "search"), "search": (2, "search"), "match": (2, "match"),
+        "fullmatch": (2, "fullmatch"), "findall": (2, "search"), "finditer": (2, "search"),
+        "split": (3, "search"), "sub": (4, "search"), "subn": (4, "search"),
+    }
+    PROBE_CHARS = "aA0_ \t\n-./:,;@!\"'{}[]()<>=#\\"
+    SUFFIXES = ["", "!", "\x00", "\n", " ", "\"", "a", "0"]
+
+    _C_STRING = r'(?:u8|u|U|L)?(?:R"(?P<delim>[^(\s]*)\((?P<raw>.*?)\)(?P=delim)"|"(?P<text>(?:[^"\\\n]|\\.)*)")'
+    CPP_REGEX = re.compile(
+        r'\b(?:std::)?(?:w?regex|basic_regex\s*<[^>]*>)\s*(?:[A-Za-z_]\w*\s*)?[({]\s*(?P<lit>' + _C_STRING +
+        r'(?:\s*' + _C_STRING.replace('?P<delim>', '?:').replace('?P=delim', '').replace('?P<raw>', '?:')
+        .replace('?P<text>', '?:') + r')*)(?P<rest>[^;]{0,120})', re.DOTALL)
+    JAVA_REGEX = re.compile(
+        r'(?P<api>Pattern\s*\.\s*(?:compile|matches)|\.\s*(?:matches|replaceAll|replaceFirst|split))\s*\(\s*'
+        r'(?P<lit>"(?:[^"\\\n]|\\.)*"(?:\s*\+\s*"(?:[^"\\\n]|\\.)*")*)(?P<rest>[^;]{0,120})', re.DOTALL)
+    JAVA_FLAGS = {"CASE_INSENSITIVE": re.IGNORECASE, "DOTALL": re.DOTALL, "MULTILINE": re.MULTILINE,
+                  "COMMENTS": re.VERBOSE}
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        self._confirmations = 0
+        findings = []
+        for path in ctx.files(('.py',)):
+            findings.extend(self._report(path, self._python_literals(path)))
+        for path in ctx.files(('.c', '.cc', '.cpp', '.cxx', '.h', '.hpp')):
+            findings.extend(self._report(path, self._cpp_literals(path)))
+        for path in ctx.files(('.java',)):
+            findings.extend(self._report(path, self._java_literals(path)))
+        return findings
+
+    # ── Extraction ───────────────────────────────────────────────────
+
+    def _python_literals(self, path: str) -> List[RegexLiteral]:
+        tree = self.ctx.module(path)
+        if tree is None:
+            return []
+        modules, functions = set(), {}
+        for node in ast.walk(tree):
+            if isinstance(node, ast.Import):
+                modules |= {a.asname or a.name for a in node.names if a.name in self.PY_MODULES}
+            elif isinstance(node, ast.ImportFrom) and node.module in self.PY_MODULES:
+                functions.update({a.asname or a.name: a.name for a in node.names if a.name in self.PY_FUNCTIONS})
+        if not modules and not functions:
+            return []
+        constants = {t.id: n.value.value for n in tree.body if isinstance(n, ast.Assign)
+                     and isinstance(n.value, ast.Constant) and isinstance(n.value.value, str)
+                     for t in n.targets if isinstance(t, ast.Name)}
+        enclosing = {}
+        for qname, func, _ in self.ctx.functions(path):
+            for node in PerformanceContext.walk_body(func):
+                enclosing[id(node)] = qname
+
+        literals = []
+        for node in ast.walk(tree):
+            if not isinstance(node, ast.Call) or not node.args:
+                continue
+            name, receiver = PerformanceContext.call_name(node)
+            if receiver in modules and name in self.PY_FUNCTIONS:
+                api = name
+            elif receiver is None and name in functions:
+                api = functions[name]
+            else:
+                continue
+            first = node.args[0]
+            if isinstance(first, ast.Constant) and isinstance(first.value, str):
+                pattern = first.value
+            elif isinstance(first, ast.Name) and first.id in constants:
+                pattern = constants[first.id]
+            else:
+                continue
+            flag_pos, mode = self.PY_FUNCTIONS[api]
+            flag_expr = next((k.value for k in node.keywords if k.arg == "flags"), None)
+            if flag_expr is None and len(node.args) > flag_pos:
+                flag_expr = node.args[flag_pos]
+            literals.append(RegexLiteral(pattern, self._python_flags(flag_expr), mode, node.lineno,
+                                         enclosing.get(id(node), ""), f"{receiver or 're'}.{api}"))
+        return literals
+
+    def _python_flags(self, node: Optional[ast.AST]) -> int:
+        if isinstance(node, ast.BinOp) and isinstance(node.op, ast.BitOr):
+            return self._python_flags(node.left) | self._python_flags(node.right)
+        name = node.attr if isinstance(node, ast.Attribute) else node.id if isinstance(node, ast.Name) else None
+        flag = getattr(re, name, None) if name and name.isupper() else None
+        return int(flag) if isinstance(flag, re.RegexFlag) else 0
+
+    def _cpp_literals(self, path: str) -> List[RegexLiteral]:
+        source = self.ctx.source(path)
+        literals = []
+        for match in self.CPP_REGEX.finditer(source):
+            pattern = "".join(self._c_literal(m) for m in re.finditer(self._C_STRING, match.group("lit")))
+            flags = re.IGNORECASE if "icase" in match.group("rest").split(")")[0] else 0
+            literals.append(self._native_literal(path, source, match.start(), pattern, flags, "search", "std::regex"))
+        return literals
+
+    def _java_literals(self, path: str) -> List[RegexLiteral]:
+        source = self.ctx.source(path)
+        literals = []
+        for match in self.JAVA_REGEX.finditer(source):
+            api = re.sub(r"\s+", "", match.group("api")).lstrip(".")
+            pattern = "".join(self._c_unescape(m.group(1)) for m in re.finditer(r'"((?:[^"\\\n]|\\.)*)"', match.group("lit")))
+            flags = 0
+            if api == "Pattern.compile":
+                for flag in re.findall(r"Pattern\s*\.\s*([A-Z_]+)", match.group("rest").split(";")[0]):
+                    flags |= self.JAVA_FLAGS.get(flag, 0)
+            mode = "fullmatch" if api.endswith("matches") else "search"
+            literals.append(self._native_literal(path, source, match.start(), pattern, flags, mode, api))
+        return literals
+
+    def _native_literal(self, path, source, offset, pattern, flags, mode, api) -> RegexLiteral:
+        line = source.count("\n", 0, offset) + 1
+        return RegexLiteral(pattern, flags, mode, line, self._enclosing_native(path, line), api)
+
+    def _enclosing_native(self, path: str, line: int) -> str:
+        """Qualified name of the C++/Java function whose body spans `line`."""
+        data = self.ctx.structural.file_data_map.get(path) or {}
+        stem = Path(path).stem
+        best = None
+        for func in data.get("functions", []):
+            start = func.get("line", 0)
+            end = start + len(func.get("body_code", "").splitlines())
+            if start <= line <= end and (best is None or start > best.get("line", 0)):
+                best = func
+        if not best:
+            return ""
+        parent = best.get("parent_class")
+        return f"{stem}.{parent}.{best['name']}" if parent else f"{stem}.{best['name']}"
+
+    @classmethod
+    def _c_literal(cls, match: "re.Match") -> str:
+        if match.group("raw") is not None:
+            return match.group("raw")
+        return cls._c_unescape(match.group("text") or "")
+
+    @staticmethod
+    def _c_unescape(text: str) -> str:
+        """C/Java string escapes; unknown escapes keep their backslash like regex escapes do."""
+        simple = {"\\": "\\", '"': '"', "'": "'", "n": "\n", "t": "\t", "r": "\r", "0": "\0"}
+        out, i = [], 0
+        while i < len(text):
+            ch = text[i]
+            if ch == "\\" and i + 1 < len(text):
+                nxt = text[i + 1]
+                out.append(simple.get(nxt, "\\" + nxt))
+                i += 2
+            else:
+                out.append(ch)
+                i += 1
+        return "".join(out)
+
+    # ── Reporting ────────────────────────────────────────────────────
+
+    def _report(self, path: str, literals: List[RegexLiteral]) -> List[PerformanceFinding]:
+        findings = []
+        for literal in literals:
+            issue = RegexAnalysis(literal, self.PROBE_CHARS, self.LARGE_REPEAT).worst()
+            if issue is None or not self._choose_suffix(literal, issue):
+                continue
+            status, timings = self._confirm(literal, issue)
+            exponential = issue.complexity == "exponential"
+            n = self.EXP_SIZES[-1] if exponential else self.POLY_SIZES[-1]
+            confirmed = status in ("timeout", "growth")
+            if status == "timeout":
+                check = f"confirmed locally: matching exceeded the {self.TIME_BUDGET:.0f}s budget"
+            elif status == "growth":
+                n = timings[-1][0]
+                check = f"confirmed locally: n={n} took {timings[-1][1]:.2f}s"
+            elif status == "linear":
+                check = "not reproduced within the time budget"
+            else:
+                check = "not checked (confirmation limit reached)"
+            severity = ("high" if exponential else "medium") if confirmed else "low"
+            findings.append(PerformanceFinding(
+                rule=self.name, file=path, line=literal.line, function=literal.function,
+                message=f"{literal.api} pattern {self._short(literal.pattern)} backtracks in {issue.label} "
+                        f"time ({issue.construct}); attack input {issue.attack_text(n)}: {check}",
+                suggestion=self._suggestion(issue),
+                severity=severity,
+                details={"pattern": literal.pattern, "complexity": issue.complexity, "degree": issue.degree,
+                         "attack": issue.attack_text(n), "confirmed": confirmed, "timings": timings},
+            ))
+        return findings
+
+    @staticmethod
+    def _suggestion(issue: Backtracking) -> str:
+        if issue.complexity == "exponential":
+            return ("Make the repetition unambiguous: remove the inner quantifier or overlapping alternative, "
+                    "or use an atomic group / possessive quantifier (`(?>...)`, `++`); bound input length")
+        return ("Anchor the pattern or make adjacent repeats disjoint (e.g. `[^\"]*` instead of `.*?`), "
+                "parse the structure instead of scanning, or bound the input length")
+
+    @staticmethod
+    def _short(pattern: str, limit: int = 60) -> str:
+        text = repr(pattern)
+        return text if len(text) <= limit else text[:limit - 4] + "...'"
+
+    def _choose_suffix(self, literal: RegexLiteral, issue: Backtracking) -> bool:
+        """
+        Pick a suffix that makes matching fail across the pumped text on a short
+        attack (a search may still succeed afterwards, e.g. empty at the end).
+        False if no suffix does.
+        """
+        try:
+            run = getattr(re.compile(literal.pattern, literal.flags), literal.mode)
+        except (re.error, OverflowError, RecursionError):
+            return False
+        n = 6 if issue.complexity == "exponential" else 20
+        for suffix in self.SUFFIXES:
+            issue.suffix = suffix
+            text = issue.attack(n)
+            found = run(text)
+            if found is None or found.start() >= len(text) - len(suffix):
+                return True
+        return False
+
+    def _confirm(self, literal: RegexLiteral, issue: Backtracking) -> Tuple[str, List[List[float]]]:
+        """
+        Time the attack at growing sizes in a child process. Status: "timeout" or
+        "growth" (confirmed), "linear" (not reproduced) or "skipped".
+        """
+        if self._confirmations >= self.MAX_CONFIRMATIONS:
+            return "skipped", []
+        self._confirmations += 1
+        exponential = issue.complexity == "exponential"
+        spec = {"pattern": literal.pattern, "flags": literal.flags, "mode": literal.mode,
+                "prefix": issue.prefix, "pump": issue.pump, "suffix": issue.suffix,
+                "sizes": self.EXP_SIZES if exponential else self.POLY_SIZES}
+        timed_out = False
+        try:
+            proc = subprocess.run([sys.executable, "-c", _PROBE], input=json.dumps(spec),
+                                  capture_output=True, text=True, timeout=self.TIME_BUDGET)
+            output = proc.stdout
+        except subprocess.TimeoutExpired as e:
+            timed_out = True
+            output = e.stdout.decode() if isinstance(e.stdout, bytes) else (e.stdout or "")
+        except OSError:
+            return "skipped", []
+        timings = [json.loads(line) for line in output.splitlines() if line.startswith("[")]
+        if timed_out:
+            return "timeout", timings
+
+        growth = self.EXP_GROWTH if exponential else self.POLY_GROWTH
+        for (_, before), (_, after) in zip(timings, timings[1:]):
+            if after >= self.MIN_SECONDS and before > 0 and after / before >= growth:
+                return "growth", timings
+        return "linear", timings
+
+
+class RegexAnalysis:
+    """Static backtracking analysis of one parsed pattern."""
+
+    def __init__(self, literal: RegexLiteral, probe_chars: str, large_repeat: int):
+        self.literal = literal
+        self.large_repeat = large_repeat
+        self.candidates: List[Backtracking] = []
+        try:
+            self.tree = sre_parse.parse(literal.pattern, literal.flags)
+        except (re.error, OverflowError, RecursionError):
+            self.tree = None
+            return
+        self.flags = self.tree.state.flags
+        literals = {chr(av) for op, av in self._atoms(self.tree) if op == sre_parse.LITERAL and av < 0x110000}
+        self.alphabet: FrozenSet[str] = frozenset(probe_chars) | frozenset(literals)
+        self._set_cache: Dict[int, FrozenSet[str]] = {}
+
+    def worst(self) -> Optional[Backtracking]:
+        if self.tree is None:
+            return None
+        self._walk(self.tree, self.literal.mode == "fullmatch", "", top=True)
+        if not self.candidates:
+            return None
+        return max(self.candidates, key=lambda c: (c.complexity == "exponential", c.degree))
+
+    # ── Walk ─────────────────────────────────────────────────────────
+
+    def _walk(self, seq, tail_fails: bool, prefix: str, top: bool = False):
+        items = list(seq)
+        self._chains(items, tail_fails, prefix, top)
+        for i, (op, av) in enumerate(items):
+            item_tail = tail_fails or any(self._can_fail(x) for x in items[i + 1:])
+            item_prefix = prefix + "".join(self._sample(x) for x in items[:i])
+            if op == sre_parse.SUBPATTERN:
+                self._walk(av[3], item_tail, item_prefix)
+            elif op == sre_parse.BRANCH:
+                for alt in av[1]:
+                    self._walk(alt, item_tail, item_prefix)
+            elif op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT):
+                if item_tail and self._unbounded(av):
+                    self._exponential(av[2], item_prefix)
+                self._walk(av[2], item_tail, item_prefix)
+            # Possessive repeats, atomic groups and lookarounds do not backtrack into their body
+
+    def _exponential(self, body, prefix: str):
+        """Body matching both s and ss (or two alternatives matching the same s) repeats ambiguously."""
+        matcher = self._compile(body)
+        if matcher is None:
+            return
+        sample = self._sample_seq(body) or next(iter(sorted(self._first(body))), "")
+        if sample and matcher.fullmatch(sample) and matcher.fullmatch(sample * 2):
+            nested = any(op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT) for op, _ in self._atoms(body))
+            construct = "nested quantifiers" if nested else "repeated body matches its own repetition"
+            self.candidates.append(Backtracking("exponential", 0, construct, prefix, sample))
+            return
+        for branch in (av for op, av in self._atoms(body) if op == sre_parse.BRANCH):
+            alts = branch[1]
+            for i, left in enumerate(alts):
+                for right in alts[i + 1:]:
+                    shared = self._shared_sample(left, right)
+                    if shared is not None:
+                        pump = self._sample_seq(body, {id(branch): shared})
+                        if pump:
+                            self.candidates.append(Backtracking(
+                                "exponential", 0, "alternatives matching the same text inside a repeat",
+                                prefix, pump))
+                            return
+
+    def _chains(self, items, tail_fails: bool, prefix: str, top: bool):
+        """Adjacent unbounded repeats over overlapping characters (nullable items in between)."""
+        flat = self._flatten(items) if top else list(items)
+        for start, (op, av) in enumerate(flat):
+            if not self._is_repeat(op, av):
+                continue
+            chain, common = [start], self._chars(av[2])
+            j = start + 1
+            while j < len(flat):
+                op2, av2 = flat[j]
+                if self._is_repeat(op2, av2) and common & self._chars(av2[2]):
+                    chain.append(j)
+                    common &= self._chars(av2[2])
+                elif not self._nullable((op2, av2)):
+                    break
+                j += 1
+            last = chain[-1]
+            if not (tail_fails or any(self._can_fail(x) for x in flat[last + 1:])) or not common:
+                continue
+            pump = sorted(common)[0]
+            before = prefix + "".join(self._sample(x) for x in flat[:start])
+            degree = len(chain)
+            # Unanchored search restarts at every position the repeat could also consume
+            if top and self.literal.mode == "search" and not self._anchored(flat[:start]) \
+                    and set(before) <= self._chars(av[2]):
+                degree += 1
+                if degree >= 2:
+                    self.candidates.append(Backtracking(
+                        "polynomial", degree, "unanchored search re-scans the repeat from every start",
+                        "", before + pump))
+                    continue
+            if degree >= 2:
+                self.candidates.append(Backtracking(
+                    "polynomial", degree, f"{degree} adjacent repeats over the same characters", before, pump))
+
+    def _anchored(self, items) -> bool:
+        """True if the items pin the match to the start of the string."""
+        for op, av in items:
+            if op == sre_parse.AT and (av == sre_parse.AT_BEGINNING_STRING or
+                                       (av == sre_parse.AT_BEGINNING and not self.flags & re.MULTILINE)):
+                return True
+        return False
+
+    def _flatten(self, items) -> list:
+        """Top-level sequence with capturing/non-capturing groups inlined."""
+        flat = []
+        for op, av in items:
+            if op == sre_parse.SUBPATTERN:
+                flat.extend(self._flatten(av[3]))
+            else:
+                flat.append((op, av))
+        return flat
+
+    # ── Tree properties ──────────────────────────────────────────────
+
+    def _is_repeat(self, op, av) -> bool:
+        return op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT) and self._unbounded(av)
+
+    def _unbounded(self, av) -> bool:
+        low, high = av[0], av[1]
+        return high == sre_parse.MAXREPEAT or high - low >= self.large_repeat
+
+    def _nullable(self, item) -> bool:
+        op, av = item
+        if op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT, getattr(sre_parse, "POSSESSIVE_REPEAT", None)):
+            return av[0] == 0 or all(self._nullable(x) for x in av[2])
+        if op == sre_parse.SUBPATTERN:
+            return all(self._nullable(x) for x in av[3])
+        if op == getattr(sre_parse, "ATOMIC_GROUP", None):
+            return all(self._nullable(x) for x in av)
+        if op == sre_parse.BRANCH:
+            return any(all(self._nullable(x) for x in alt) for alt in av[1])
+        return op in (sre_parse.AT, sre_parse.ASSERT, sre_parse.ASSERT_NOT, sre_parse.GROUPREF,
+                      sre_parse.GROUPREF_EXISTS)
+
+    def _can_fail(self, item) -> bool:
+        op, _ = item
+        return not self._nullable(item) or op in (sre_parse.AT, sre_parse.ASSERT, sre_parse.ASSERT_NOT,
+                                                  sre_parse.GROUPREF, sre_parse.GROUPREF_EXISTS)
+
+    def _atoms(self, seq) -> Iterator[tuple]:
+        """Every (op, av) in the tree, depth first."""
+        for op, av in seq:
+            yield op, av
+            if op == sre_parse.SUBPATTERN:
+                yield from self._atoms(av[3])
+            elif op == sre_parse.BRANCH:
+                for alt in av[1]:
+                    yield from self._atoms(alt)
+            elif op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT, getattr(sre_parse, "POSSESSIVE_REPEAT", None)):
+                yield from self._atoms(av[2])
+            elif op == getattr(sre_parse, "ATOMIC_GROUP", None):
+                yield from self._atoms(av)
+            elif op in (sre_parse.ASSERT, sre_parse.ASSERT_NOT):
+                yield from self._atoms(av[1])
+
+    # ── Character sets (over a finite probe alphabet) ────────────────
+
+    def _char_set(self, op, av) -> FrozenSet[str]:
+        key = id(av) if isinstance(av, list) else hash((op, av))
+        if key not in self._set_cache:
+            self._set_cache[key] = frozenset(c for c in self.alphabet if self._accepts(op, av, c))
+        return self._set_cache[key]
+
+    def _accepts(self, op, av, ch: str) -> bool:
+        variants = {ch, ch.lower(), ch.upper()} if self.flags & re.IGNORECASE else {ch}
+        if op == sre_parse.LITERAL:
+            return chr(av) in variants
+        if op == sre_parse.NOT_LITERAL:
+            return chr(av) not in variants
+        if op == sre_parse.ANY:
+            return ch != "\n" or bool(self.flags & re.DOTALL)
+        if op == sre_parse.IN:
+            negate = bool(av) and av[0][0] == sre_parse.NEGATE
+            hit = any(self._in_item(item_op, item_av, v) for item_op, item_av in av for v in variants)
+            return hit != negate
+        return False
+
+    @staticmethod
+    def _in_item(op, av, ch: str) -> bool:
+        if op == sre_parse.LITERAL:
+            return ord(ch) == av
+        if op == sre_parse.RANGE:
+            return av[0] <= ord(ch) <= av[1]
+        if op == sre_parse.CATEGORY:
+            name = getattr(av, "name", str(av)).replace("UNI_", "").replace("LOC_", "")
+            tests = {"CATEGORY_DIGIT": ch.isdigit(), "CATEGORY_SPACE": ch.isspace(),
+                     "CATEGORY_WORD": ch.isalnum() or ch == "_", "CATEGORY_LINEBREAK": ch == "\n"}
+            for category, result in tests.items():
+                if name == category:
+                    return result
+                if name == category.replace("CATEGORY_", "CATEGORY_NOT_"):
+                    return not result
+        return False
+
+    def _chars(self, seq) -> FrozenSet[str]:
+        """Characters any part of `seq` can consume."""
+        chars = frozenset()
+        for op, av in self._atoms(seq):
+            if op in (sre_parse.LITERAL, sre_parse.NOT_LITERAL, sre_parse.ANY, sre_parse.IN):
+                chars |= self._char_set(op, av)
+        return chars
+
+    def _first(self, seq) -> FrozenSet[str]:
+        """Characters a non-empty match of `seq` can start with."""
+        first = frozenset()
+        for item in seq:
+            op, av = item
+            if op in (sre_parse.LITERAL, sre_parse.NOT_LITERAL, sre_parse.ANY, sre_parse.IN):
+                first |= self._char_set(op, av)
+            elif op == sre_parse.SUBPATTERN:
+                first |= self._first(av[3])
+            elif op == sre_parse.BRANCH:
+                for alt in av[1]:
+                    first |= self._first(alt)
+            elif op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT, getattr(sre_parse, "POSSESSIVE_REPEAT", None)):
+                first |= self._first(av[2])
+            if not self._nullable(item):
+                break
+        return first
+
+    # ── Samples ──────────────────────────────────────────────────────
+
+    def _sample(self, item, overrides: Optional[Dict[int, str]] = None) -> str:
+        """A short string the item matches (shortest alternative, minimum repeats)."""
+        op, av = item
+        if overrides and op == sre_parse.BRANCH and id(av) in overrides:
+            return overrides[id(av)]
+        if op == sre_parse.LITERAL:
+            return chr(av)
+        if op in (sre_parse.NOT_LITERAL, sre_parse.ANY, sre_parse.IN):
+            chars = self._char_set(op, av)
+            return min(chars, key=lambda c: (not c.isalnum(), c)) if chars else ""
+        if op in (sre_parse.MAX_REPEAT, sre_parse.MIN_REPEAT, getattr(sre_parse, "POSSESSIVE_REPEAT", None)):
+            return self._sample_seq(av[2], overrides) * av[0]
+        if op == sre_parse.SUBPATTERN:
+            return self._sample_seq(av[3], overrides)
+        if op == getattr(sre_parse, "ATOMIC_GROUP", None):
+            return self._sample_seq(av, overrides)
+        if op == sre_parse.BRANCH:
+            return min((self._sample_seq(alt, overrides) for alt in av[1]), key=len, default="")
+        return ""
+
+    def _sample_seq(self, seq, overrides: Optional[Dict[int, str]] = None) -> str:
+        return "".join(self._sample(item, overrides) for item in seq)
+
+    def _shared_sample(self, left, right) -> Optional[str]:
+        """A string both alternatives match, tried from each side's sample."""
+        left_rx, right_rx = self._compile(left), self._compile(right)
+        if left_rx is None or right_rx is None:
+            return None
+        for candidate in (self._sample_seq(left), self._sample_seq(right)):
+            if left_rx.fullmatch(candidate) and right_rx.fullmatch(candidate):
+                return candidate
+        return None
+
+    def _compile(self, seq):
+        """Compile a parsed sub-tree on its own (None if it references groups it cannot see)."""
+        sub = sre_parse.SubPattern(self.tree.state, list(seq))
+        try:
+            return sre_compile.compile(sub, self.flags)
+        except Exception:
+            return None
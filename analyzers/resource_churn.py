@@ -0,0 +1,264 @@
+"""
+Resource Churn Rule
+Finds expensive resources built inside frequently run code and dropped
+after use: database connections, HTTP/API clients, worker pools, compiled
+regexes and tree-sitter parsers.
+
+Python constructions are matched against a table of (module, factory) pairs
+through the file's imports, and project classes whose `__init__` (or its
+callees) builds such a resource count as resources themselves. A
+construction is churn when its site runs often (inside a loop, or in a
+function the hotness index estimates is called many times) and the object
+is neither returned nor built in a lifecycle hook such as `__init__`. Each
+finding carries the call chain that makes its function hot.
+"""
+
+import ast
+import re
+from typing import Dict, List, Optional, Set
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class ResourceChurnRule(PerformanceRule):
+    name = "resource-churn"
+    description = "Expensive resources constructed per call"
+
+    HOT_HEAT = 1.0        # log10 of estimated constructions per run from which churn is reported
+    HOTTER_HEAT = 2.0     # ... and from which it is high severity
+
+    # (module, factory) -> category; the module may be imported whole or the factory imported from it
+    PY_RESOURCES = {
+        **{(m, "connect"): "database connection" for m in (
+            "sqlite3", "psycopg2", "psycopg", "pymysql", "MySQLdb", "mysql.connector", "asyncpg", "aiosqlite",
+            "cx_Oracle", "oracledb", "pyodbc", "duckdb", "pymssql")},
+        ("sqlalchemy", "create_engine"): "database engine",
+        ("pymongo", "MongoClient"): "database client",
+        ("redis", "Redis"): "database client",
+        ("redis", "StrictRedis"): "database client",
+        ("requests", "Session"): "HTTP client",
+        ("httpx", "Client"): "HTTP client",
+        ("httpx", "AsyncClient"): "HTTP client",
+        ("aiohttp", "ClientSession"): "HTTP client",
+        ("urllib3", "PoolManager"): "HTTP client",
+        ("openai", "OpenAI"): "API client",
+        ("openai", "AsyncOpenAI"): "API client",
+        ("boto3", "client"): "API client",
+        ("boto3", "resource"): "API client",
+        ("grpc", "insecure_channel"): "RPC channel",
+        ("grpc", "secure_channel"): "RPC channel",
+        ("concurrent.futures", "ThreadPoolExecutor"): "worker pool",
+        ("concurrent.futures", "ProcessPoolExecutor"): "worker pool",
+        ("multiprocessing", "Pool"): "worker pool",
+        ("multiprocessing.pool", "ThreadPool"): "worker pool",
+        ("re", "compile"): "compiled regex",
+        ("regex", "compile"): "compiled regex",
+        ("tree_sitter", "Parser"): "tree-sitter parser",
+        ("tree_sitter", "Language"): "tree-sitter parser",
+        ("tree_sitter_languages", "get_parser"): "tree-sitter parser",
+        ("tree_sitter_languages", "get_language"): "tree-sitter parser",
+    }
+    JAVA_RESOURCES = {
+        ("DriverManager", "getConnection"): "database connection",
+        ("HttpClient", "newHttpClient"): "HTTP client",
+        ("HttpClients", "createDefault"): "HTTP client",
+        ("Executors", "newFixedThreadPool"): "worker pool",
+        ("Executors", "newCachedThreadPool"): "worker pool",
+        ("Executors", "newWorkStealingPool"): "worker pool",
+        ("Pattern", "compile"): "compiled regex",
+    }
+    # Cached by the library already (re keeps recent patterns): cheaper to rebuild, so one step lower
+    CHEAP = {"compiled regex"}
+    SUGGESTIONS = {
+        "database connection": "Open it once (module/app start-up or a connection pool) and pass it in; per-call "
+                               "connects pay TCP/TLS/auth handshakes every time",
+        "database engine": "Create the engine once per process; it owns the connection pool",
+        "database client": "Create one client per process and share it; it pools connections internally",
+        "HTTP client": "Create one session/client and reuse it so connections (and TLS) are kept alive",
+        "API client": "Create the client once and reuse it; each instance builds its own HTTP pool",
+        "RPC channel": "Create the channel once and reuse it; channels multiplex calls",
+        "worker pool": "Create the pool once (or pass one in) and submit to it; spawning workers per call "
+                       "costs more than small tasks save",
+        "compiled regex": "Compile it once at module level (a constant) and reuse the pattern object",
+        "tree-sitter parser": "Create parsers once per language and cache them (e.g. a dict on the instance "
+                              "or module)",
+    }
+    LIFECYCLE = re.compile(r"^(?:__init__|__post_init__|__enter__|__aenter__|setup\w*|set_up\w*|start\w*|"
+                           r"open\w*|connect\w*|create\w*|make\w*|build\w*|new\w*|init\w*|_?get_\w*(?:client|"
+                           r"connection|session|pool|parser)\w*|main)$")
+    CACHED = {"lru_cache", "cache", "cached_property", "cached", "memoize"}
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        self._nodes = {qname: (path, node, owner) for path in ctx.files(('.py',))
+                       for qname, node, owner in ctx.functions(path)}
+        self._direct: Dict[str, str] = {}          # function -> category of a resource it builds itself
+        for qname, (path, node, _) in self._nodes.items():
+            for call, _, _ in self._calls(node):
+                category = self._py_category(path, call)
+                if category:
+                    self._direct[qname] = category
+                    break
+
+        findings = []
+        for qname, (path, node, owner) in self._nodes.items():
+            if self._exempt(node):
+                continue
+            returned = self._returned_names(node)
+            for call, depth, parent in self._calls(node):
+                category = self._py_category(path, call) or self._wrapper_category(path, call)
+                if not category or self._kept(parent, returned):
+                    continue
+                finding = self._finding(path, qname, call.lineno, depth, category,
+                                        ast.unparse(call.func))
+                if finding:
+                    findings.append(finding)
+
+        for path in ctx.files(('.java',)):
+            for qname, func, call in ctx.call_sites(path):
+                category = self.JAVA_RESOURCES.get((call.get("receiver"), call["name"]))
+                if not category or func["name"] == func.get("parent_class") or self.LIFECYCLE.match(func["name"]):
+                    continue
+                if category == "compiled regex" and not (call.get("args") or [""])[0].startswith('"'):
+                    continue
+                finding = self._finding(path, qname, call.get("line", 0), call.get("loop_depth", 0), category,
+                                        f"{call['receiver']}.{call['name']}")
+                if finding:
+                    findings.append(finding)
+        return findings
+
+    # ── Matching ─────────────────────────────────────────────────────
+
+    def _py_category(self, path: str, call: ast.Call) -> Optional[str]:
+        name, receiver = self.ctx.call_name(call)
+        if not name:
+            return None
+        imports = self._imports(path)
+        for (module, factory), category in self.PY_RESOURCES.items():
+            if factory != name:
+                continue
+            if receiver is None and (module, name) in imports["from"]:
+                pass
+            elif receiver is not None and (receiver == module or receiver == module.split(".")[-1]) and \
+                    module.split(".")[0] in imports["modules"] | {m for m, _ in imports["from"]}:
+                pass
+            else:
+                continue
+            if category == "compiled regex" and not (call.args and isinstance(call.args[0], ast.Constant)):
+                return None  # dynamic patterns have to be compiled where they are known
+            return category
+        return None
+
+    def _wrapper_category(self, path: str, call: ast.Call) -> Optional[str]:
+        """Project class whose constructor builds a resource, e.g. a client wrapper around `AsyncOpenAI`."""
+        name, receiver = self.ctx.call_name(call)
+        if not name or (receiver is not None and not receiver.isidentifier()):
+            return None
+        init = self.ctx.hierarchy.lookup(name, "__init__") if self.ctx.hierarchy.has_class(name) else None
+        if init is None:
+            return None
+        for qname in {init.qualified_name} | self.ctx.callees(init.qualified_name):
+            if qname in self._direct:
+                return f"{name} (builds {self._article(self._direct[qname])})"
+        return None
+
+    def _imports(self, path: str) -> Dict[str, Set]:
+        if not hasattr(self, "_import_cache"):
+            self._import_cache = {}
+        if path not in self._import_cache:
+            data = self.ctx.structural.file_data_map.get(path) or {}
+            modules, names = set(), set()
+            for imp in data.get("imports", []):
+                if imp.get("module") is None:
+                    modules.update(n.split(".")[0] for n in imp.get("names", []))
+                    modules.update(imp.get("names", []))
+                else:
+                    names.update((imp["module"], n) for n in imp.get("names", []))
+            self._import_cache[path] = {"modules": modules, "from": names}
+        return self._import_cache[path]
+
+    # ── Fate of the object ───────────────────────────────────────────
+
+    def _exempt(self, node: ast.AST) -> bool:
+        """Lifecycle hooks and cached factories build resources on purpose."""
+        if self.LIFECYCLE.match(node.name):
+            return True
+        for dec in node.decorator_list:
+            target = dec.func if isinstance(dec, ast.Call) else dec
+            name = target.attr if isinstance(target, ast.Attribute) else getattr(target, "id", None)
+            if name in self.CACHED:
+                return True
+        return False
+
+    def _returned_names(self, node: ast.AST) -> Set[str]:
+        """Names handed to the caller as they are: `return conn`, `return conn, cur`, `return {"db": conn}`.
+        `return conn.execute(q).fetchone()` only returns a result, so `conn` is still dropped."""
+        names = set()
+        for child in self.ctx.walk_body(node):
+            if isinstance(child, (ast.Return, ast.Yield, ast.YieldFrom)) and child.value is not None:
+                value = child.value
+                elements = value.elts if isinstance(value, (ast.Tuple, ast.List)) else \
+                    value.values if isinstance(value, ast.Dict) else [value]
+                names |= {e.id for e in elements if isinstance(e, ast.Name)}
+        return names
+
+    @staticmethod
+    def _kept(parent: Optional[ast.AST], returned: Set[str]) -> bool:
+        """Returned to the caller or stored on an object (a lazily filled cache): not churn."""
+        if isinstance(parent, (ast.Return, ast.Yield, ast.YieldFrom)):
+            return True
+        if isinstance(parent, ast.Assign):
+            return any(isinstance(t, (ast.Attribute, ast.Subscript)) or
+                       (isinstance(t, ast.Name) and t.id in returned) for t in parent.targets)
+        if isinstance(parent, ast.withitem) and isinstance(parent.optional_vars, ast.Name):
+            return parent.optional_vars.id in returned
+        return False
+
+    def _calls(self, func: ast.AST):
+        """(call, loop depth, parent) for every call in a function body, nested defs excluded."""
+        loops = (ast.For, ast.AsyncFor, ast.While, ast.ListComp, ast.SetComp, ast.DictComp, ast.GeneratorExp)
+
+        def visit(node, depth):
+            for child in ast.iter_child_nodes(node):
+                if isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef, ast.Lambda)):
+                    continue
+                inner = depth + 1 if isinstance(child, loops) else depth
+                if isinstance(child, ast.Call):
+                    yield child, depth, node
+                yield from visit(child, inner)
+
+        yield from visit(func, 0)
+
+    # ── Findings ─────────────────────────────────────────────────────
+
+    def _finding(self, path, qname, line, depth, category, text) -> Optional[PerformanceFinding]:
+        heat = self.ctx.hotness.heat(qname, depth)
+        if heat < self.HOT_HEAT:
+            return None
+        base = self._direct_category(category)
+        severity = "high" if heat >= self.HOTTER_HEAT else "medium"
+        if base in self.CHEAP:
+            severity = "medium" if severity == "high" else "low"
+        chain = self.ctx.hotness.hot_chain(qname)
+        where = f"inside a loop (depth {depth})" if depth else "on every call"
+        estimated = round(10 ** heat)
+        return PerformanceFinding(
+            rule=self.name, file=path, line=line, function=qname,
+            message=f"`{text}(...)` creates {self._article(category)} {where} and drops it afterwards; ~{estimated:,} "
+                    f"constructions per run via {' → '.join(c.split('.')[-1] for c in chain)}",
+            suggestion=self.SUGGESTIONS.get(base, "Hoist the construction out of the hot path and reuse it"),
+            severity=severity,
+            priority=self.ctx.priority(severity, qname, depth),
+            details={"category": base, "loop_depth": depth, "estimated_constructions": estimated,
+                     "hot_chain": chain, "fan_in": self.ctx.hotness.fan_in(qname)},
+        )
+
+    @staticmethod
+    def _article(noun: str) -> str:
+        return f"{'an' if noun.startswith(('a', 'e', 'i', 'o', 'u', 'A', 'E', 'I', 'O', 'U', 'HTTP', 'RPC')) else 'a'} {noun}"
+
+    @staticmethod
+    def _direct_category(category: str) -> str:
+        """Resource category behind a wrapper description such as `Client (builds an HTTP client)`."""
+        match = re.search(r"\(builds an? (.*)\)$", category)
+        return match.group(1) if match else category
@@ -0,0 +1,338 @@
+"""
+Sequential Await Rule
+Finds `await` inside loops whose iterations do not depend on each other.
+
+Each awaited call in a `for` loop (or an `await` in a comprehension) makes
+the loop's latency the sum of every call. The loop body is scanned in
+evaluation order for names and `self.x`-style attributes that are read
+before they are written in an iteration and written later in it: such a
+value is carried into the next iteration, and if it feeds an awaited call
+(directly or through local assignments) the calls are really sequential.
+Loops that can exit early (`break`/`return`), prompt the user, or await
+inherently ordered operations (sleep, queues, stream reads, locks) are
+left alone, and so are awaits made under `async with` over a Lock or
+Condition: the lock serialises them whatever the loop does. Findings are ranked by the iteration-count hint of the loop and
+the function's position in the call graph.
+"""
+
+import ast
+import re
+from typing import Dict, List, Optional, Set
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+class _OrderScan(ast.NodeVisitor):
+    """Names/attributes read before being written, in evaluation order, for one loop body."""
+
+    def __init__(self, written: Set[str]):
+        self.written = set(written)
+        self.read_first: Set[str] = set()
+        self.sources: Dict[str, Set[str]] = {}   # assigned name -> names its value reads
+
+    def read(self, key: Optional[str]):
+        if key and key not in self.written:
+            self.read_first.add(key)
+
+    def visit_Name(self, node):
+        if isinstance(node.ctx, ast.Load):
+            self.read(node.id)
+        else:
+            self.written.add(node.id)
+
+    def visit_Attribute(self, node):
+        key = SequentialAwaitRule.dotted(node)
+        if key is None:
+            self.generic_visit(node)
+        elif isinstance(node.ctx, ast.Load):
+            self.read(key)
+            self.read(key.split(".")[0])
+        else:
+            self.read(key.split(".")[0])
+            self.written.add(key)
+
+    def _assign(self, targets, value):
+        if value is not None:
+            self.visit(value)
+        reads = SequentialAwaitRule.reads(value) if value is not None else set()
+        for target in targets:
+            for node in ast.walk(target):
+                key = SequentialAwaitRule.dotted(node) if isinstance(node, ast.Attribute) else \
+                    node.id if isinstance(node, ast.Name) else None
+                if key:
+                    self.sources.setdefault(key, set()).update(reads)
+            self.visit(target)
+
+    def visit_Assign(self, node):
+        self._assign(node.targets, node.value)
+
+    def visit_AnnAssign(self, node):
+        self._assign([node.target], node.value)
+
+    def visit_AugAssign(self, node):
+        key = SequentialAwaitRule.dotted(node.target) if isinstance(node.target, ast.Attribute) else \
+            getattr(node.target, "id", None)
+        self.read(key)
+        self._assign([node.target], node.value)
+
+    def visit_NamedExpr(self, node):
+        self._assign([node.target], node.value)
+
+    def visit_FunctionDef(self, node):
+        pass
+
+    visit_AsyncFunctionDef = visit_ClassDef = visit_Lambda = visit_FunctionDef
+
+
+class SequentialAwaitRule(PerformanceRule):
+    name = "sequential-await"
+    description = "Independent awaits serialised by a loop"
+
+    HIGH_ITEMS = 10          # size hint from which a loop is high severity
+    LOW_ITEMS = 2            # at or below this it is low
+    # Awaits whose order is the point (pacing, queues, streams, locks, user input)
+    ORDERED_AWAITS = {'sleep', 'get', 'put', 'join', 'wait', 'wait_for', 'acquire', 'recv', 'send', 'read',
+                      'readline', 'readexactly', 'readuntil', 'write', 'drain', 'receive', 'send_json',
+                      'receive_json', 'commit', 'rollback', 'input', 'ask', 'prompt'}
+    # Methods on one connection run one statement at a time: concurrency needs a pool, so only low severity
+    CONNECTION_AWAITS = {'execute', 'executemany', 'fetch', 'fetchrow', 'fetchval', 'fetchone', 'fetchall'}
+    INTERACTIVE = {'input', 'ask', 'prompt', 'confirm'}
+    # `async with` targets that admit one holder at a time (asyncio or threading)
+    LOCK_TYPES = {'Lock', 'RLock', 'Condition'}
+    LOCK_NAME = re.compile(r"(?:^|_)(?:lock|mutex|cond|condition)$|[a-z](?:Lock|Mutex|Cond|Condition)$")
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        findings = []
+        for path in ctx.files(('.py',)):
+            tree = ctx.module(path)
+            self._locks = self._lock_names(tree) if tree is not None else set()
+            for qname, node, owner in ctx.functions(path):
+                if isinstance(node, ast.AsyncFunctionDef):
+                    findings.extend(self._function(path, qname, node))
+        return findings
+
+    # ── Loops ────────────────────────────────────────────────────────
+
+    def _function(self, path: str, qname: str, func: ast.AsyncFunctionDef) -> List[PerformanceFinding]:
+        findings = []
+        literals = self._literal_sizes(func)
+
+        def visit(node, depth):
+            for child in ast.iter_child_nodes(node):
+                if isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef, ast.Lambda)):
+                    continue
+                if self._holds_lock(child):
+                    continue  # every await under the lock runs one at a time anyway
+                if isinstance(child, ast.For):
+                    finding = self._loop(path, qname, child, depth + 1, literals)
+                    if finding:
+                        findings.append(finding)
+                    visit(child, depth + 1)
+                elif isinstance(child, (ast.ListComp, ast.SetComp, ast.DictComp, ast.GeneratorExp)):
+                    finding = self._comprehension(path, qname, child, depth + 1, literals)
+                    if finding:
+                        findings.append(finding)
+                    visit(child, depth + 1)
+                elif isinstance(child, (ast.AsyncFor, ast.While)):
+                    visit(child, depth + 1)   # iterations are driven by an async source / a condition
+                else:
+                    visit(child, depth)
+
+        visit(func, 0)
+        return findings
+
+    def _loop(self, path, qname, loop: ast.For, depth, literals) -> Optional[PerformanceFinding]:
+        awaits = self._direct_awaits(loop.body)
+        if not awaits:
+            return None
+        for stmt in loop.body:
+            for node in self._walk_local(stmt):
+                if isinstance(node, (ast.Break, ast.Return)):
+                    return None  # early exit: later calls depend on earlier results
+                if isinstance(node, ast.Call) and self.ctx.call_name(node)[0] in self.INTERACTIVE:
+                    return None
+
+        targets = self.reads(loop.target)
+        scan = _OrderScan(targets)
+        for stmt in loop.body:
+            scan.visit(stmt)
+        carried = (scan.read_first & scan.written) - targets
+        for aw in awaits:
+            if self._feeds(aw, scan.sources) & carried:
+                return None
+        return self._finding(path, qname, loop, loop.iter, awaits, depth, literals)
+
+    def _comprehension(self, path, qname, comp, depth, literals) -> Optional[PerformanceFinding]:
+        if isinstance(comp, ast.GeneratorExp) or any(gen.is_async for gen in comp.generators):
+            return None
+        parts = [comp.key, comp.value] if isinstance(comp, ast.DictComp) else [comp.elt]
+        awaits = [n for part in parts for n in self._walk_local(part) if isinstance(n, ast.Await)]
+        if not awaits:
+            return None
+        return self._finding(path, qname, comp, comp.generators[0].iter, awaits, depth, literals)
+
+    # ── Findings ─────────────────────────────────────────────────────
+
+    def _finding(self, path, qname, loop, iterable, awaits, depth, literals) -> Optional[PerformanceFinding]:
+        calls = [aw.value for aw in awaits if isinstance(aw.value, ast.Call)]
+        named = [self.ctx.call_name(c) for c in calls]
+        if not calls or any(name in self.ORDERED_AWAITS for name, _ in named):
+            return None
+        shared_connection = any(name in self.CONNECTION_AWAITS and receiver for name, receiver in named)
+
+        size = self._size_hint(iterable, literals)
+        if shared_connection or (size is not None and size <= self.LOW_ITEMS):
+            severity = "low"
+        elif (size is not None and size >= self.HIGH_ITEMS) or depth > 1:
+            severity = "high"
+        else:
+            severity = "medium"
+
+        text = ast.unparse(calls[0])
+        if len(text) > 60:
+            text = text[:57] + "..."
+        source = ast.unparse(iterable)
+        if len(source) > 40:
+            source = source[:37] + "..."
+        count = f"{size} items" if size is not None else "size unknown"
+        fan_in = self.ctx.hotness.fan_in(qname)
+        scale = size / self.ctx.hotness.LOOP_FACTOR if size else 1.0
+        more = f" (+{len(calls) - 1} more awaited call(s))" if len(calls) > 1 else ""
+        suggestion = ("Start the iterations together: `await asyncio.gather(*(work(x) for x in items))`, or "
+                      "`async with asyncio.TaskGroup() as tg:` (3.11+) creating one task per item; bound "
+                      "concurrency with an `asyncio.Semaphore` when the input is large")
+        if shared_connection:
+            suggestion += "; statements on one DB connection run one at a time, so take connections from a pool"
+        return PerformanceFinding(
+            rule=self.name, file=path, line=calls[0].lineno, function=qname,
+            message=f"`await {text}`{more} runs once per item of `{source}` ({count}) and no iteration "
+                    f"depends on another; the loop's latency is the sum of every call "
+                    f"(loop depth {depth}, fan-in {fan_in})",
+            suggestion=suggestion,
+            severity=severity,
+            priority=self.ctx.priority(severity, qname, depth, scale),
+            details={"loop_line": loop.lineno, "awaits": [ast.unparse(c)[:80] for c in calls],
+                     "size_hint": size, "loop_depth": depth, "fan_in": fan_in},
+        )
+
+    # ── Helpers ──────────────────────────────────────────────────────
+
+    def _direct_awaits(self, body: List[ast.stmt]) -> List[ast.Await]:
+        """Awaits of this loop's own iterations; awaits in nested loops belong to those loops."""
+        found = []
+        stack = list(reversed(body))
+        while stack:
+            node = stack.pop()
+            if isinstance(node, ast.Await):
+                found.append(node)
+            if isinstance(node, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef, ast.Lambda, ast.For,
+                                 ast.AsyncFor, ast.While, ast.ListComp, ast.SetComp, ast.DictComp,
+                                 ast.GeneratorExp)) or self._holds_lock(node):
+                continue
+            stack.extend(reversed(list(ast.iter_child_nodes(node))))
+        return found
+
+    def _lock_names(self, tree: ast.Module) -> Set[str]:
+        """Names and attributes bound to a Lock/Condition in this file (`self._lock = asyncio.Lock()`)."""
+        names = set()
+        for node in ast.walk(tree):
+            if isinstance(node, ast.Assign):
+                targets, value, annotation = node.targets, node.value, None
+            elif isinstance(node, ast.AnnAssign):
+                targets, value, annotation = [node.target], node.value, node.annotation
+            else:
+                continue
+            constructed = isinstance(value, ast.Call) and self.ctx.call_name(value)[0] in self.LOCK_TYPES
+            declared = annotation is not None and \
+                getattr(annotation, "attr", getattr(annotation, "id", None)) in self.LOCK_TYPES
+            if constructed or declared:
+                names |= {t.attr if isinstance(t, ast.Attribute) else t.id for t in targets
+                          if isinstance(t, (ast.Attribute, ast.Name))}
+        return names
+
+    def _holds_lock(self, node: ast.AST) -> bool:
+        """`async with lock:` / `async with self._cond:` / `async with asyncio.Lock():`."""
+        if not isinstance(node, ast.AsyncWith):
+            return False
+        for item in node.items:
+            expr = item.context_expr
+            if isinstance(expr, ast.Call):
+                if self.ctx.call_name(expr)[0] in self.LOCK_TYPES:
+                    return True
+                continue
+            key = expr.attr if isinstance(expr, ast.Attribute) else expr.id if isinstance(expr, ast.Name) else None
+            if key and (key in self._locks or self.LOCK_NAME.search(key)):
+                return True
+        return False
+
+    def _walk_local(self, node: ast.AST):
+        """ast.walk without entering nested function or class definitions."""
+        yield node
+        yield from self.ctx.walk_body(node)
+
+    def _feeds(self, aw: ast.Await, sources: Dict[str, Set[str]]) -> Set[str]:
+        """Names an awaited expression reads, closed over local assignments in the loop body."""
+        feeds = self.reads(aw.value)
+        frontier = list(feeds)
+        while frontier:
+            for src in sources.get(frontier.pop(), ()):
+                if src not in feeds:
+                    feeds.add(src)
+                    frontier.append(src)
+        return feeds
+
+    @staticmethod
+    def dotted(node: ast.AST) -> Optional[str]:
+        """`self.a.b` -> "self.a.b"; None for attributes of calls or subscripts."""
+        parts = []
+        while isinstance(node, ast.Attribute):
+            parts.append(node.attr)
+            node = node.value
+        if not isinstance(node, ast.Name):
+            return None
+        parts.append(node.id)
+        return ".".join(reversed(parts))
+
+    @classmethod
+    def reads(cls, node: Optional[ast.AST]) -> Set[str]:
+        """Names and dotted attributes appearing in an expression."""
+        found = set()
+        for child in ast.walk(node) if node is not None else ():
+            if isinstance(child, ast.Name):
+                found.add(child.id)
+            elif isinstance(child, ast.Attribute):
+                key = cls.dotted(child)
+                if key:
+                    found.add(key)
+        return found
+
+    @staticmethod
+    def _literal_sizes(func: ast.AST) -> Dict[str, int]:
+        """Locals bound once to a list/tuple/set literal."""
+        sizes: Dict[str, Optional[int]] = {}
+        for node in ast.walk(func):
+            if isinstance(node, ast.Assign) and len(node.targets) == 1 and isinstance(node.targets[0], ast.Name):
+                name = node.targets[0].id
+                size = len(node.value.elts) if isinstance(node.value, (ast.List, ast.Tuple, ast.Set)) else None
+                sizes[name] = size if name not in sizes else None
+        return {name: size for name, size in sizes.items() if size is not None}
+
+    @staticmethod
+    def _size_hint(iterable: ast.AST, literals: Dict[str, int]) -> Optional[int]:
+        if isinstance(iterable, (ast.List, ast.Tuple, ast.Set)):
+            return len(iterable.elts)
+        if isinstance(iterable, ast.Name):
+            return literals.get(iterable.id)
+        if isinstance(iterable, ast.Call) and isinstance(iterable.func, ast.Name) and \
+                iterable.func.id == "range" and not iterable.keywords:
+            bounds = [a.value for a in iterable.args if isinstance(a, ast.Constant) and isinstance(a.value, int)]
+            if len(bounds) == len(iterable.args) == 1:
+                return max(bounds[0], 0)
+            if len(bounds) == len(iterable.args) >= 2:
+                step = bounds[2] if len(bounds) > 2 and bounds[2] else 1
+                return max(0, -(-(bounds[1] - bounds[0]) // step))
+        if isinstance(iterable, ast.Call) and isinstance(iterable.func, ast.Name) and \
+                iterable.func.id in ("enumerate", "sorted", "reversed", "list") and iterable.args:
+            return SequentialAwaitRule._size_hint(iterable.args[0], literals)
+        return None
@@ -0,0 +1,418 @@
+"""
+Slots Memory Rule
+Estimates per-instance memory of Python classes that are instantiated at
+scale and flags the ones that still carry a per-instance `__dict__`.
+
+A class counts as instantiated at scale when a constructor call sits inside
+a loop or comprehension and the instance outlives the iteration: stored in
+a collection or attribute, returned, or produced by a comprehension. The
+hotness index turns that site's loop nesting and call-graph position into an
+estimated instance count; a `return` or `break` right after the allocation
+caps the loops it multiplies by. Classes only built as loop temporaries are
+reported at low severity, since their instances never pile up. Instance sizes are
+measured once per attribute count on the running interpreter (tracemalloc
+over a batch of probe objects with and without `__slots__`), so the
+reported savings per million instances match the Python version that runs
+the workers. Attributes that `__init__` derives from other fields are
+reported as well: each one is a stored pointer plus its value per instance.
+"""
+
+import ast
+import sys
+import tracemalloc
+from functools import lru_cache
+from pathlib import Path
+from typing import Dict, List, Optional, Set, Tuple
+
+from analyzers.performance_rules import PerformanceContext, PerformanceFinding, PerformanceRule
+
+
+@lru_cache(maxsize=None)
+def measure_instance(attributes: int, slotted: bool) -> int:
+    """Bytes per instance with `attributes` fields set in __init__, measured on this interpreter."""
+    names = tuple(f"a{i}" for i in range(attributes))
+
+    def __init__(self):
+        for name in names:
+            setattr(self, name, None)
+
+    namespace = {"__init__": __init__}
+    if slotted:
+        namespace["__slots__"] = names
+    probe = type("Probe", (), namespace)
+    count = SlotsMemoryRule.PROBE_INSTANCES
+
+    started = not tracemalloc.is_tracing()
+    if started:
+        tracemalloc.start()
+    try:
+        probe()  # first instance builds shared key tables; not per-instance cost
+        before = tracemalloc.get_traced_memory()[0]
+        objs = [probe() for _ in range(count)]
+        after = tracemalloc.get_traced_memory()[0]
+    finally:
+        if started:
+            tracemalloc.stop()
+    return max(0, round((after - before - sys.getsizeof(objs)) / count))
+
+
+class SlotsMemoryRule(PerformanceRule):
+    name = "slots"
+    description = "Classes allocated at scale without __slots__"
+
+    PROBE_INSTANCES = 2000
+    MAX_MEASURED_ATTRIBUTES = 64     # larger classes are measured at this size
+    HOT_INSTANCES = 1000             # estimated instances per run at which a finding becomes high severity
+    # Bases whose instances have no __dict__ of their own to remove
+    SAFE_BASES = {"object", "ABC", "Generic", "Protocol"}
+    # Pure builtins that keep an expression "derived" rather than fresh state
+    PURE_CALLS = {"len", "str", "int", "float", "bool", "tuple", "frozenset", "sorted", "sum", "min", "max",
+                  "abs", "round", "hash", "repr"}
+    # Calls that keep their argument alive after the iteration (list/set/deque/queue/heap insertion)
+    STORE_CALLS = {"append", "appendleft", "add", "insert", "setdefault", "put", "put_nowait", "push",
+                   "heappush", "heappushpop", "heapreplace"}
+    LOOPS = (ast.For, ast.AsyncFor, ast.While, ast.ListComp, ast.SetComp, ast.DictComp, ast.GeneratorExp)
+
+    def analyze(self, ctx: PerformanceContext) -> List[PerformanceFinding]:
+        self.ctx = ctx
+        self._classes: Dict[str, List[Tuple[str, str, ast.ClassDef]]] = {}  # name -> [(path, qname, node)]
+        for path in ctx.files(('.py',)):
+            tree = ctx.module(path)
+            if tree is not None:
+                self._collect_classes(path, tree)
+
+        sites = self._allocation_sites()
+        findings = []
+        for (path, qname, node), allocs in sites.items():
+            finding = self._slots_finding(path, qname, node, allocs)
+            if finding:
+                findings.append(finding)
+            findings.extend(self._derived_findings(path, qname, node, allocs))
+        return findings
+
+    # ── Classes and allocation sites ─────────────────────────────────
+
+    def _collect_classes(self, path: str, tree: ast.Module):
+        stem = Path(path).stem
+        for node in ast.walk(tree):
+            if isinstance(node, ast.ClassDef):
+                self._classes.setdefault(node.name, []).append((path, f"{stem}.{node.name}", node))
+
+    def _allocation_sites(self) -> Dict[Tuple[str, str, ast.ClassDef], List[Tuple[str, str, dict]]]:
+        """
+        Class -> [(file, calling function, site)] for constructor calls inside
+        loops/comprehensions. A site is {"line", "loop_depth", "kept"}, with
+        loop_depth counting only the loops that repeat the allocation.
+        """
+        sites: Dict[Tuple[str, str, ast.ClassDef], List[Tuple[str, str, dict]]] = {}
+        for path in self.ctx.files(('.py',)):
+            for qname, func, _ in self.ctx.functions(path):
+                stored = self._stored_names(func)
+                for call, depth, parents in self._loop_calls(func):
+                    name, receiver = self.ctx.call_name(call)
+                    if name not in self._classes:
+                        continue
+                    if receiver is not None and (receiver in ("self", "super") or not receiver.isidentifier()):
+                        continue
+                    depth = self._repeated_depth(call, depth, parents)
+                    if not depth:
+                        continue
+                    candidates = self._classes[name]
+                    # Same-file class first, like bare-call resolution in the call graph
+                    chosen = [c for c in candidates if c[0] == path] or candidates
+                    site = {"line": call.lineno, "loop_depth": depth, "kept": self._kept(call, parents, stored)}
+                    sites.setdefault(chosen[0], []).append((path, qname, site))
+        return sites
+
+    def _loop_calls(self, func: ast.AST):
+        """
+        (call, loop depth, ancestors) for calls under at least one loop, nested
+        defs excluded. `ancestors` is the live path from `func`: use it before
+        advancing the generator.
+        """
+        parents = [func]
+
+        def visit(node, depth):
+            once = self._evaluated_once(node, parents[-2] if len(parents) > 1 else None)
+            for child in ast.iter_child_nodes(node):
+                if isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef, ast.Lambda)):
+                    continue
+                here = depth - 1 if child is once else depth
+                if isinstance(child, ast.Call) and here:
+                    yield child, here, parents
+                parents.append(child)
+                yield from visit(child, here + 1 if isinstance(child, self.LOOPS) else here)
+                parents.pop()
+
+        yield from visit(func, 0)
+
+    @staticmethod
+    def _evaluated_once(node: ast.AST, parent: Optional[ast.AST]) -> Optional[ast.AST]:
+        """The iterable a loop evaluates before its first iteration (`for x in make():`)."""
+        if isinstance(node, (ast.For, ast.AsyncFor)):
+            return node.iter
+        if isinstance(node, ast.comprehension) and getattr(parent, "generators", [None])[0] is node:
+            return node.iter
+        return None
+
+    @staticmethod
+    def _repeated_depth(call: ast.Call, depth: int, parents: List[ast.AST]) -> int:
+        """Loop depth minus the loops a `return` (all) or `break` (innermost) right after the site exits."""
+        stmt_at = next((i for i in range(len(parents) - 1, -1, -1) if isinstance(parents[i], ast.stmt)), None)
+        if stmt_at is None:
+            return depth
+        stmt = parents[stmt_at]
+        if isinstance(stmt, ast.Return):
+            return 0
+        owner = parents[stmt_at - 1] if stmt_at else None
+        for field in ("body", "orelse", "finalbody"):
+            block = getattr(owner, field, None)
+            if not isinstance(block, list) or stmt not in block:
+                continue
+            for following in block[block.index(stmt) + 1:]:
+                if isinstance(following, (ast.Return, ast.Raise)):
+                    return 0
+                if isinstance(following, ast.Break):
+                    return depth - 1
+            break
+        return depth
+
+    def _kept(self, call: ast.Call, parents: List[ast.AST], stored: Set[str]) -> bool:
+        """True if the instance outlives its iteration: stored, returned, or a comprehension's element."""
+        child = call
+        for parent in reversed(parents):
+            if isinstance(parent, (ast.Tuple, ast.List, ast.Set, ast.Dict, ast.Starred)):
+                child = parent  # an element of a literal goes wherever the literal goes
+                continue
+            if isinstance(parent, (ast.ListComp, ast.SetComp, ast.DictComp)):
+                return child is not parent and all(child is not gen for gen in parent.generators)
+            if isinstance(parent, ast.Call):
+                return child in parent.args and self.ctx.call_name(parent)[0] in self.STORE_CALLS
+            if isinstance(parent, (ast.Assign, ast.AnnAssign)):
+                targets = parent.targets if isinstance(parent, ast.Assign) else [parent.target]
+                return any(isinstance(t, (ast.Attribute, ast.Subscript)) or
+                           (isinstance(t, ast.Name) and t.id in stored) for t in targets)
+            return isinstance(parent, (ast.Return, ast.Yield, ast.YieldFrom))
+        return False
+
+    def _stored_names(self, func: ast.AST) -> Set[str]:
+        """Locals that escape: passed to a store call, assigned to an attribute/item, returned or yielded."""
+        names = set()
+        for node in self.ctx.walk_body(func):
+            if isinstance(node, ast.Call) and self.ctx.call_name(node)[0] in self.STORE_CALLS:
+                values = node.args
+            elif isinstance(node, ast.Assign) and \
+                    any(isinstance(t, (ast.Attribute, ast.Subscript)) for t in node.targets):
+                values = [node.value]
+            elif isinstance(node, (ast.Return, ast.Yield, ast.YieldFrom)) and node.value is not None:
+                values = [node.value]
+            else:
+                continue
+            for value in values:
+                elements = value.elts if isinstance(value, (ast.Tuple, ast.List)) else [value]
+                names |= {e.id for e in elements if isinstance(e, ast.Name)}
+        return names
+
+    def _hottest(self, allocs) -> Tuple[str, str, dict, float]:
+        """Hottest retained site; temporaries only when the class is never kept."""
+        pool = [a for a in allocs if a[2]["kept"]] or allocs
+        scored = [(path, qname, site, self.ctx.hotness.heat(qname, site["loop_depth"]))
+                  for path, qname, site in pool]
+        return max(scored, key=lambda s: s[3])
+
+    # ── __slots__ ────────────────────────────────────────────────────
+
+    def _slots_finding(self, path, qname, node, allocs) -> Optional[PerformanceFinding]:
+        chain = self._dict_carriers(node, set())
+        if chain is None or not chain:
+            return None  # unknown external base, or already slotted all the way up
+        attributes = sorted(self._instance_attributes(node, set()))
+        if not attributes:
+            return None
+
+        measured = min(len(attributes), self.MAX_MEASURED_ATTRIBUTES)
+        with_dict = measure_instance(measured, False)
+        slotted = measure_instance(measured, True)
+        saved = with_dict - slotted
+        if saved <= 0:
+            return None
+
+        site_path, site_func, site_call, heat = self._hottest(allocs)
+        depth = site_call["loop_depth"]
+        estimated = round(10 ** heat)
+        kept = site_call["kept"]
+        if not kept:
+            severity = "low"
+        else:
+            severity = "high" if estimated >= self.HOT_INSTANCES else "medium"
+        dataclass = self._dataclass_decorator(node)
+        if dataclass is not None:
+            fix = "Use `@dataclass(slots=True)` (Python 3.10+)"
+        else:
+            fix = f"Add `__slots__ = ({', '.join(repr(a) for a in attributes[:6])}{', ...' if len(attributes) > 6 else ''})`"
+        if chain != [node.name]:
+            fix += f" to {', '.join(chain)}: every class in the hierarchy needs it for the __dict__ to go away"
+        return PerformanceFinding(
+            rule=self.name, file=path, line=node.lineno, function="",
+            message=f"`{node.name}` ({len(attributes)} attributes) is allocated in a loop at "
+                    f"{site_path}:{site_call['line']} (loop depth {depth}, ~{estimated:,} "
+                    f"{'instances' if kept else 'short-lived instances, none stored'}) and "
+                    f"carries a per-instance __dict__: ~{with_dict} bytes each vs ~{slotted} with __slots__, "
+                    f"{saved * 1_000_000 / 2**20:.0f} MiB saved per million instances",
+            suggestion=f"{fix}; slotted instances reject attributes that are not listed, so include every "
+                       f"field set outside __init__ too",
+            severity=severity,
+            priority=self.ctx.priority(severity, site_func, depth),
+            details={"class": qname, "attributes": len(attributes), "instance_bytes": with_dict,
+                     "slotted_bytes": slotted, "savings_per_million_bytes": saved * 1_000_000,
+                     "allocation_sites": len(allocs), "retained_sites": sum(a[2]["kept"] for a in allocs),
+                     "estimated_instances": estimated,
+                     "measured_on": sys.version.split()[0]},
+        )
+
+    def _dict_carriers(self, node: ast.ClassDef, seen: Set[str]) -> Optional[List[str]]:
+        """Classes in the project hierarchy that still give instances a __dict__; None if a base is unknown."""
+        if node.name in seen:
+            return []
+        seen.add(node.name)
+        carriers = [] if self._has_slots(node) else [node.name]
+        for base in node.bases:
+            name = base.attr if isinstance(base, ast.Attribute) else \
+                base.value.id if isinstance(base, ast.Subscript) and isinstance(base.value, ast.Name) else \
+                base.id if isinstance(base, ast.Name) else None
+            if name in self.SAFE_BASES:
+                continue
+            if name not in self._classes:
+                return None  # NamedTuple, Enum, Exception, ORM models, ...: layout not ours to change
+            inherited = self._dict_carriers(self._classes[name][0][2], seen)
+            if inherited is None:
+                return None
+            carriers.extend(c for c in inherited if c not in carriers)
+        return carriers
+
+    def _has_slots(self, node: ast.ClassDef) -> bool:
+        for stmt in node.body:
+            targets = stmt.targets if isinstance(stmt, ast.Assign) else \
+                [stmt.target] if isinstance(stmt, ast.AnnAssign) else []
+            if any(isinstance(t, ast.Name) and t.id == "__slots__" for t in targets):
+                return True
+        decorator = self._dataclass_decorator(node)
+        if isinstance(decorator, ast.Call):
+            return any(kw.arg == "slots" and isinstance(kw.value, ast.Constant) and kw.value.value is True
+                       for kw in decorator.keywords)
+        return False
+
+    @staticmethod
+    def _dataclass_decorator(node: ast.ClassDef) -> Optional[ast.AST]:
+        for dec in node.decorator_list:
+            target = dec.func if isinstance(dec, ast.Call) else dec
+            name = target.attr if isinstance(target, ast.Attribute) else getattr(target, "id", None)
+            if name in ("dataclass", "define", "attrs"):
+                return dec
+        return None
+
+    def _instance_attributes(self, node: ast.ClassDef, seen: Set[str]) -> Set[str]:
+        """`self.x = ...` in any method, dataclass fields, and the same for project base classes."""
+        if node.name in seen:
+            return set()
+        seen.add(node.name)
+        attrs = set()
+        if self._dataclass_decorator(node) is not None:
+            for stmt in node.body:
+                if isinstance(stmt, ast.AnnAssign) and isinstance(stmt.target, ast.Name) and \
+                        "ClassVar" not in ast.unparse(stmt.annotation):
+                    attrs.add(stmt.target.id)
+        for child in ast.walk(node):
+            targets = child.targets if isinstance(child, ast.Assign) else \
+                [child.target] if isinstance(child, (ast.AnnAssign, ast.AugAssign)) else []
+            for target in targets:
+                if isinstance(target, ast.Attribute) and isinstance(target.value, ast.Name) and \
+                        target.value.id == "self":
+                    attrs.add(target.attr)
+        for base in node.bases:
+            if isinstance(base, ast.Name) and base.id in self._classes:
+                attrs |= self._instance_attributes(self._classes[base.id][0][2], seen)
+        return attrs
+
+    # ── Derived attributes ───────────────────────────────────────────
+
+    def _derived_findings(self, path, qname, node, allocs) -> List[PerformanceFinding]:
+        init = next((s for s in node.body if isinstance(s, ast.FunctionDef) and s.name == "__init__"), None)
+        if init is None:
+            return []
+        derived = self._derived_attributes(node, init)
+        if not derived:
+            return []
+        _, site_func, site_call, heat = self._hottest(allocs)
+        depth = site_call["loop_depth"]
+        names = ", ".join(f"{attr} (from {', '.join(sorted(sources))})" for attr, sources in derived.items())
+        pointer = measure_instance(1, True) - measure_instance(0, True)
+        return [PerformanceFinding(
+            rule=self.name, file=path, line=init.lineno, function=f"{qname}.__init__",
+            message=f"`{node.name}.__init__` stores {len(derived)} attribute(s) computable from other fields: "
+                    f"{names}; each costs {pointer} bytes for its slot plus its value object per instance "
+                    f"(≥ {len(derived) * pointer * 1_000_000 / 2**20:.0f} MiB per million instances)",
+            suggestion="Compute them on access with `@property` (works with __slots__), or cache lazily only "
+                       "where the computation is expensive",
+            severity="low",
+            priority=self.ctx.priority("low", site_func, depth),
+            details={"class": qname, "derived": {a: sorted(s) for a, s in derived.items()},
+                     "estimated_instances": round(10 ** heat)},
+        )]
+
+    def _derived_attributes(self, node: ast.ClassDef, init: ast.FunctionDef) -> Dict[str, Set[str]]:
+        """self.x = <pure expression over other stored fields>, where x is never reassigned elsewhere."""
+        params = {a.arg for a in init.args.args[1:] + init.args.kwonlyargs}
+        stored_params: Dict[str, str] = {}     # parameter -> attribute holding it unchanged
+        assigned: Set[str] = set()
+        derived: Dict[str, Set[str]] = {}
+        for stmt in init.body:
+            if not (isinstance(stmt, ast.Assign) and len(stmt.targets) == 1 and
+                    self._self_attr(stmt.targets[0])):
+                continue
+            attr, value = stmt.targets[0].attr, stmt.value
+            if isinstance(value, ast.Name) and value.id in params:
+                stored_params[value.id] = attr
+            else:
+                sources = self._pure_sources(value, stored_params, assigned)
+                if sources:
+                    derived[attr] = sources
+            assigned.add(attr)
+
+        # Reassigned outside __init__: it is state, not a derived value
+        for method in node.body:
+            if isinstance(method, (ast.FunctionDef, ast.AsyncFunctionDef)) and method is not init:
+                for child in ast.walk(method):
+                    targets = child.targets if isinstance(child, ast.Assign) else \
+                        [child.target] if isinstance(child, (ast.AnnAssign, ast.AugAssign)) else []
+                    for target in targets:
+                        if self._self_attr(target):
+                            derived.pop(target.attr, None)
+        return derived
+
+    def _pure_sources(self, value: ast.AST, stored_params: Dict[str, str], assigned: Set[str]) -> Set[str]:
+        """Fields a side-effect-free expression reads, or empty if it reads anything else."""
+        if isinstance(value, (ast.Name, ast.Attribute, ast.Constant)):
+            return set()  # plain copies and constants are not derived values
+        sources = set()
+        for child in ast.walk(value):
+            if isinstance(child, ast.Call):
+                if not (isinstance(child.func, ast.Name) and child.func.id in self.PURE_CALLS) and \
+                        not (isinstance(child.func, ast.Attribute) and isinstance(child.func.value, ast.Constant)):
+                    return set()  # str.join etc. on literals are fine; anything else may be fresh state
+            elif isinstance(child, (ast.Lambda, ast.NamedExpr, ast.Await, ast.Yield, ast.YieldFrom)):
+                return set()
+            elif self._self_attr(child):
+                if child.attr not in assigned:
+                    return set()
+                sources.add(child.attr)
+            elif isinstance(child, ast.Name) and isinstance(child.ctx, ast.Load) and \
+                    child.id not in self.PURE_CALLS and child.id != "self":
+                if child.id not in stored_params:
+                    return set()
+                sources.add(stored_params[child.id])
+        return sources
+
+    @staticmethod
+    def _self_attr(node: ast.AST) -> bool:
+        return isinstance(node, ast.Attribute) and isinstance(node.value, ast.Name) and node.value.id == "self"
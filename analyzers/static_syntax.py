@@ -29,8 +29,9 @@ class FileSyntaxError:
 class StaticSyntaxAnalyzer:
     """Analyze source files for syntax errors using native AST (Python) or Tree-sitter (C/C++/Java)."""
     
-    def __init__(self, llm_client=None):
+    def __init__(self, llm_client=None, compile_db=None):
         self.llm_client = llm_client
+        self.compile_db = compile_db  # Optional CompilationDatabase deciding C vs C++
         self.lang_map = {
             '.py': 'python',
             '.c': 'c',
@@ -76,6 +77,8 @@ class StaticSyntaxAnalyzer:
         
         elif ext in self.lang_map:
             language = self.lang_map[ext]
+            if self.compile_db and language in ('c', 'cpp'):
+                language = self.compile_db.language_for(file_path) or language
             if language in self.ts_parsers:
                 return self._check_treesitter_syntax(source, language)
             else:
@@ -128,7 +131,11 @@ class StaticSyntaxAnalyzer:
         """
         parser = self.ts_parsers[language]
         tree = parser.parse(bytes(source, 'utf-8'))
-        
+        errors = self.tree_errors(tree, source, language)
+        return (len(errors) == 0), errors
+
+    def tree_errors(self, tree, source: str, language: str) -> List[FileSyntaxError]:
+        """ERROR/MISSING nodes of an already parsed tree (e.g. one kept up to date by edits)."""
         source_lines = source.splitlines()
         errors = []
         
@@ -175,5 +182,5 @@ class StaticSyntaxAnalyzer:
                 walk(child, parent_is_error=(is_error or parent_is_error))
         
         walk(tree.root_node)
-        return (len(errors) == 0), errors
+        return errors
 
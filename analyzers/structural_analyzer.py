@@ -1,8 +1,13 @@
+import re
 import networkx as nx
+from collections import Counter
 from pathlib import Path
-from typing import List, Dict, Any, Set
+from typing import List, Dict, Any, Set, Tuple
 from core.symbol_table import SymbolTableBuilder, Symbol as STSymbol, SymbolType as STSymbolType
 from core.ast_parser import StructuralParser
+from core.reachability import ReachabilityIndex
+from core.class_hierarchy import ClassHierarchy
+from core.parse_store import ParseStore
 
 class StructuralAnalyzer:
     """
@@ -13,94 +18,261 @@ class StructuralAnalyzer:
     - Dependency Graph (Import cycles)
     """
     
-    def __init__(self):
-        self.parser = StructuralParser()
+    def __init__(self, compile_db=None, parse_store=None):
+        self.parser = StructuralParser(compile_db=compile_db)
         self.symbol_table = SymbolTableBuilder()
         self.call_graph = nx.DiGraph()
+        self.reachability = ReachabilityIndex(self.call_graph)  # kept in sync with call_graph edges
         self.dependency_graph = nx.DiGraph()
-        self.file_data_map = {} # path -> parser output
+        # path -> parser output; a core.parse_store.ParseStore spills it to disk
+        self.file_data_map = parse_store if parse_store is not None else {}
+        self.file_symbols = {}  # path -> qualified names it contributed
+        # Maintained by index_file/remove_file so per-file checks need no workspace scan:
+        # name -> number of indexed files that call / decorate / import it
+        self.call_counts = Counter()
+        self.decorated_counts = Counter()
+        self.imported_counts = Counter()
+        self.flipped_names: Set[str] = set()  # names whose count crossed zero since last cleared
+        # Call resolution inputs, also maintained per file so update_call_graph can re-resolve a delta
+        self.standalone: Dict[str, Dict[str, STSymbol]] = {}      # name -> path -> free function
+        self.namespace_of: Dict[Tuple[str, str], str] = {}        # (path, name) -> C++ namespace
+        self.functions_named: Dict[str, Set[str]] = {}            # name -> function qualified names
+        self.callers_of: Dict[str, Set[str]] = {}                 # called/receiver name -> caller qualified names
+        self.call_names_of: Dict[str, Set[str]] = {}              # caller qualified name -> those names
+        self.hierarchy = None                                     # ClassHierarchy; None = resolve everything
+        self.stale_callers: Set[str] = set()
+        self.stale_names: Set[str] = set()
+        self._removed_shapes: Dict[str, tuple] = {}               # path -> hierarchy shape before removal
+        self._shape_changes: List[Tuple[tuple, tuple]] = []       # (old, new) shapes since last update
 
-    def analyze_codebase(self, files: List[Path]) -> Dict[str, Any]:
-        """Run full structural analysis on a list of files."""
-        print(f"Analysing {len(files)} files structurally...")
-        
-        all_identifiers_global = [] 
+    def analyze_codebase(self, files: List[Path], progress=None) -> Dict[str, Any]:
+        """
+        Run full structural analysis on a list of files.
+        With a utils.progress.ProgressDashboard, per-file counts go to the
+        dashboard, and parse errors are counted there and printed when the
+        phase ends instead of interleaving with it.
+        """
+        report = progress.error if progress else print
+        if progress is None:
+            print(f"Analysing {len(files)} files structurally...")
         
         # 1. Parse all files and collect definitions
         for file_path in files:
+            symbols = 0
             try:
                 with open(file_path, 'r', encoding='utf-8') as f:
                     code = f.read()
                 
-                ext = file_path.suffix.lower()
-                lang = "python" if ext == ".py" else ("java" if ext == ".java" else "c/cpp")
-                
                 data = self.parser.parse(code, file_path)
-                self.file_data_map[str(file_path)] = data
-                module_name = file_path.stem
-                
-                # Extract symbols and populate SymbolTableBuilder
-                for func in data.get("functions", []):
-                    sym = STSymbol(
-                        name=func["name"],
-                        symbol_type=STSymbolType.FUNCTION,
-                        file_path=file_path,
-                        line=func["line"],
-                        signature=func.get("signature", ""),
-                        body_code=func.get("body_code", ""),
-                        parent_name=func.get("parent_class", "")
-                    )
-                    self.symbol_table.add_symbol(sym, module_name)
-                    # Register nodes in call graph
-                    self.call_graph.add_node(sym.qualified_name)
-                    
-                for cls in data.get("classes", []):
-                    sym = STSymbol(
-                        name=cls["name"],
-                        symbol_type=STSymbolType.CLASS,
-                        file_path=file_path,
-                        line=cls["line"],
-                        signature=f"class {cls['name']}"
-                    )
-                    self.symbol_table.add_symbol(sym, module_name)
-                
-                for var in data.get("variables", []):
-                    # We don't have a special type for globals in STSymbolType, use VARIABLE
-                    sym = STSymbol(
-                        name=var["name"],
-                        symbol_type=STSymbolType.VARIABLE, # Assuming it exists in core.symbol_table
-                        file_path=file_path,
-                        line=var["line"],
-                        signature=var["name"]
-                    )
-                    self.symbol_table.add_symbol(sym, module_name)
-
-                # Track usage identifiers for cross-file variable analysis
-                for id_name in data.get("identifiers", []):
-                    all_identifiers_global.append(id_name)
-                
-                # Track imports for dependency graph
-                for imp in data.get("imports", []):
-                    module_name_imp = imp.get("module") or (imp["names"][0] if imp.get("names") else "")
-                    if module_name_imp:
-                        self.dependency_graph.add_edge(file_path.name, module_name_imp)
+                self.index_file(file_path, data)
+                symbols = len(data.get("functions", [])) + len(data.get("classes", []))
 
             except Exception as e:
-                print(f"Error parsing {file_path}: {e}")
+                report(f"Error parsing {file_path}: {e}")
+            if progress:
+                progress.advance(files=1, symbols=symbols)
+        
+        # 2. Run Structural Checks (using the fully populated symbol table)
+        return self.run_checks()
+
+    def index_file(self, file_path: Path, data: Dict[str, Any]):
+        """Register one file's parser output in the symbol table and graphs."""
+        key = str(file_path)
+        if key in self.file_data_map:
+            self.remove_file(file_path)
+        self.file_data_map[key] = data
+        self._count_names(data, 1)
+        old_shape, new_shape = self._removed_shapes.pop(key, self.EMPTY_SHAPE), self._hierarchy_shape(data)
+        if old_shape != new_shape:
+            self._shape_changes.append((old_shape, new_shape))
+        module_name = file_path.stem
+        owned = self.file_symbols.setdefault(key, [])
+        
+        # With a spill store, bodies stay on disk and are read back when a check needs them
+        spilled = isinstance(self.file_data_map, ParseStore)
+
+        # Extract symbols and populate SymbolTableBuilder
+        for index, func in enumerate(data.get("functions", [])):
+            sym = STSymbol(
+                name=func["name"],
+                symbol_type=STSymbolType.FUNCTION,
+                file_path=file_path,
+                line=func["line"],
+                signature=func.get("signature", ""),
+                body_code="" if spilled else func.get("body_code", ""),
+                parent_name=func.get("parent_class", ""),
+                body_loader=(lambda i=index: self._load_body(key, i)) if spilled else None
+            )
+            self.symbol_table.add_symbol(sym, module_name)
+            qname = sym.qualified_name
+            owned.append(qname)
+            # Register nodes in call graph
+            self.reachability.add_node(qname)
+
+            if not sym.parent_name:
+                self.standalone.setdefault(sym.name, {})[key] = sym
+                if func.get("namespace"):
+                    self.namespace_of[(key, sym.name)] = func["namespace"]
+            elif self.hierarchy is not None and self.hierarchy.has_class(sym.parent_name):
+                self.hierarchy.add_method(sym.parent_name, sym)
+            self.functions_named.setdefault(sym.name, set()).add(qname)
+            call_names = set()
+            for call in func.get("calls_detailed", []):
+                # The receiver's words too: its type may hinge on a field or return annotation
+                call_names.add(call["name"])
+                call_names.update(re.findall(r"\w+", f"{call.get('receiver') or ''} {call.get('receiver_type') or ''}"))
+            self.call_names_of.setdefault(qname, set()).update(call_names)
+            for name in call_names:
+                self.callers_of.setdefault(name, set()).add(qname)
+            self.stale_callers.add(qname)
+            self.stale_names.add(sym.name)
+            
+        for cls in data.get("classes", []):
+            sym = STSymbol(
+                name=cls["name"],
+                symbol_type=STSymbolType.CLASS,
+                file_path=file_path,
+                line=cls["line"],
+                signature=f"class {cls['name']}"
+            )
+            self.symbol_table.add_symbol(sym, module_name)
+            owned.append(sym.qualified_name)
+        
+        for var in data.get("variables", []):
+            # We don't have a special type for globals in STSymbolType, use VARIABLE
+            sym = STSymbol(
+                name=var["name"],
+                symbol_type=STSymbolType.VARIABLE, # Assuming it exists in core.symbol_table
+                file_path=file_path,
+                line=var["line"],
+                signature=var["name"]
+            )
+            self.symbol_table.add_symbol(sym, module_name)
+            owned.append(sym.qualified_name)
         
+        # Track imports for dependency graph
+        for imp in data.get("imports", []):
+            module_name_imp = imp.get("module") or (imp["names"][0] if imp.get("names") else "")
+            if imp.get("resolved"):
+                # #include resolved through compile_commands.json search paths
+                module_name_imp = Path(imp["resolved"]).name
+            if module_name_imp:
+                self.dependency_graph.add_edge(file_path.name, module_name_imp)
+
+    def _load_body(self, key: str, index: int) -> str:
+        """Body of the index-th function of a spilled file."""
+        data = self.file_data_map.get(key)
+        functions = data["functions"] if data else []
+        return functions[index].get("body_code", "") if index < len(functions) else ""
+
+    def remove_file(self, file_path: Path):
+        """Drop a previously indexed file (used for incremental re-analysis)."""
+        key = str(file_path)
+        data = self.file_data_map.get(key)
+        if data is not None:
+            self._count_names(data, -1)
+            self._removed_shapes.setdefault(key, self._hierarchy_shape(data))
+        self.file_data_map.pop(key, None)
+        for qname in self.file_symbols.pop(key, []):
+            sym = self.symbol_table.symbols.get(qname)
+            # Another file with the same module stem may have claimed this name since
+            if sym and str(sym.file) == key:
+                del self.symbol_table.symbols[qname]
+                self.reachability.remove_node(qname)
+                if sym.type == STSymbolType.FUNCTION:
+                    self._forget_function(key, sym)
+        if self.dependency_graph.has_node(file_path.name):
+            self.dependency_graph.remove_edges_from(list(self.dependency_graph.out_edges(file_path.name)))
+
+    def _forget_function(self, key: str, sym: STSymbol):
+        """Undo index_file's call-resolution bookkeeping for one removed function."""
+        qname = sym.qualified_name
+        by_path = self.standalone.get(sym.name, {})
+        if by_path.get(key) is sym:
+            del by_path[key]
+            if not by_path:
+                del self.standalone[sym.name]
+            self.namespace_of.pop((key, sym.name), None)
+        self.functions_named.get(sym.name, set()).discard(qname)
+        if not self.functions_named.get(sym.name, True):
+            del self.functions_named[sym.name]
+        for name in self.call_names_of.pop(qname, set()):
+            callers = self.callers_of.get(name)
+            if callers is not None:
+                callers.discard(qname)
+                if not callers:
+                    del self.callers_of[name]
+        self.stale_callers.discard(qname)
+        self.stale_names.add(sym.name)  # its callers may now bind to a same-named function elsewhere
+
+    EMPTY_SHAPE = ((), ())
+
+    @staticmethod
+    def _hierarchy_delta(changes: List[Tuple[tuple, tuple]], old: ClassHierarchy, new: ClassHierarchy) -> Set[str]:
+        """Names whose method calls or receiver types may resolve differently after these shape changes."""
+        names, classes = set(), set()
+        for before, after in changes:
+            for name, _, fields in set(before[0]) ^ set(after[0]):
+                classes.add(name)
+                names.add(name)
+                names.update(field for field, _ in fields)
+            for parent, name, _ in set(before[1]) ^ set(after[1]):
+                names.add(name)
+                if parent:
+                    names.add(parent)
+        for cls in classes:
+            if old.bases.get(cls) != new.bases.get(cls) or old.has_class(cls) != new.has_class(cls):
+                # Inherited lookups and dispatch sets shift for the whole family
+                for hierarchy in (old, new):
+                    for related in set(hierarchy.supertypes(cls)) | hierarchy.subtypes(cls):
+                        names.update(hierarchy.methods.get(related, {}))
+            if old.has_class(cls) != new.has_class(cls):
+                # Fields and returns typed with a class that appeared or vanished
+                for hierarchy in (old, new):
+                    for fields in hierarchy.fields.values():
+                        names.update(field for field, type_name in fields.items() if cls in re.findall(r"\w+", type_name or ""))
+                    names.update(func for (_, func), type_name in hierarchy.returns.items()
+                                 if cls in re.findall(r"\w+", type_name or ""))
+        return names
+
+    @staticmethod
+    def _hierarchy_shape(data) -> tuple:
+        """What ClassHierarchy.build reads from one file: classes, bases, fields, methods and return types."""
+        classes = tuple((c["name"], tuple(c.get("bases", [])), tuple(sorted((c.get("fields") or {}).items())))
+                        for c in data.get("classes", []))
+        functions = tuple((f.get("parent_class") or "", f["name"], f.get("returns") or "")
+                          for f in data.get("functions", []) if f.get("parent_class") or f.get("returns"))
+        return classes, functions
+
+    def _count_names(self, data, step: int):
+        """Add (step=1) or withdraw (step=-1) one file's calls, decorated functions and imported names."""
+        groups = (
+            (self.call_counts, set(data.get("calls", []))),
+            (self.decorated_counts, {f["name"] for f in data.get("functions", []) if f.get("decorators")}),
+            (self.imported_counts, {n for imp in data.get("imports", []) for n in imp.get("names", [])}),
+        )
+        for counts, names in groups:
+            for name in names:
+                counts[name] += step
+                if counts[name] <= 0:
+                    del counts[name]
+                    self.flipped_names.add(name)
+                elif counts[name] == step:
+                    self.flipped_names.add(name)  # first file to use it
+
+    def run_checks(self, unused_variables: bool = True) -> Dict[str, Any]:
+        """Run the graph-level checks over everything indexed so far."""
         # Sync raw_data alias for detection methods
         self.raw_data = self.file_data_map
         
-        # 2. Run Structural Checks (using the fully populated symbol table)
-        
         # Cycle Detection
         function_cycles = self._detect_function_cycles(self.symbol_table)
         
         # Dead Code
         dead_code = self._detect_dead_code(self.symbol_table)
         
-        # Unused Variables
-        unused_vars = self._detect_unused_variables(self.symbol_table)
+        # Unused Variables (re-reads sources from disk)
+        unused_vars = self._detect_unused_variables(self.symbol_table) if unused_variables else []
         
         return {
             "symbol_table_object": self.symbol_table,
@@ -111,6 +283,27 @@ class StructuralAnalyzer:
             "raw_data": self.file_data_map
         }
 
+    def check_file(self, file_path: Path, code: str) -> Dict[str, Any]:
+        """
+        Dead code and unused variables of one file against everything indexed,
+        using `code` instead of the file on disk (an editor's unsaved buffer).
+        """
+        import ast
+
+        self.raw_data = self.file_data_map
+        key = str(file_path)
+        symbols = (self.symbol_table.symbols.get(qname) for qname in self.file_symbols.get(key, []))
+        dead_code = [sym for sym in symbols if sym is not None and str(sym.file) == key and self._is_dead(sym)]
+        unused_vars = []
+        if file_path.suffix == '.py':
+            try:
+                tree = ast.parse(code)
+            except SyntaxError:
+                tree = None
+            if tree is not None:
+                unused_vars = self._unused_in_tree(key, tree, self.imported_counts.keys())
+        return {"dead_code": dead_code, "unused_variables": unused_vars}
+
     def _build_import_graph(self) -> Dict[str, Set[str]]:
         """Map file paths to the modules/files they import."""
         graph = {} # {str(file_path): set(imported_names)}
@@ -199,95 +392,30 @@ class StructuralAnalyzer:
         Find circular function dependencies (recursion/mutual recursion).
         Uses dependency-based call resolution instead of name-based matching.
         """
-        # Build class hierarchy: class_name -> [base_class_names]
-        class_bases = {}  # class_name -> list of base class names
-        class_methods = {}  # class_name -> {method_name: Symbol}
-        
-        for data in self.raw_data.values():
-            for cls in data.get("classes", []):
-                class_bases[cls["name"]] = cls.get("bases", [])
-                class_methods[cls["name"]] = {}
-        
-        # Populate class_methods from symbols
-        for qname, sym in symbol_builder.symbols.items():
-            if sym.type == STSymbolType.FUNCTION and sym.parent_name:
-                if sym.parent_name not in class_methods:
-                    class_methods[sym.parent_name] = {}
-                class_methods[sym.parent_name][sym.name] = sym
-        
-        # Build standalone functions map: (file, name) -> Symbol
-        standalone_map = {}
-        for qname, sym in symbol_builder.symbols.items():
-            if sym.type == STSymbolType.FUNCTION and not sym.parent_name:
-                key = (str(sym.file), sym.name)
-                standalone_map[key] = sym
-        
-        def resolve_call(call_info, caller_sym):
-            """Resolve a call to its target Symbol(s) based on receiver context."""
-            call_name = call_info["name"]
-            receiver = call_info.get("receiver")
-            
-            if receiver == "self":
-                # self.method() -> method in the same class
-                if caller_sym.parent_name and caller_sym.parent_name in class_methods:
-                    target = class_methods[caller_sym.parent_name].get(call_name)
-                    return [target] if target else []
-            
-            elif receiver == "super":
-                # super().method() -> method in parent class
-                if caller_sym.parent_name and caller_sym.parent_name in class_bases:
-                    for base_name in class_bases[caller_sym.parent_name]:
-                        if base_name in class_methods:
-                            target = class_methods[base_name].get(call_name)
-                            if target:
-                                return [target]
-                return []
-            
-            elif receiver is not None:
-                # ClassName.method() -> method in that specific class
-                if receiver in class_methods:
-                    target = class_methods[receiver].get(call_name)
-                    return [target] if target else []
-                return []
-            
-            else:
-                # Bare call: foo() -> same-file standalone function first
-                key = (str(caller_sym.file), call_name)
-                target = standalone_map.get(key)
-                if target:
-                    return [target]
-                # Fallback: any standalone function with that name (cross-file)
-                results = []
-                for (fpath, name), sym in standalone_map.items():
-                    if name == call_name:
-                        results.append(sym)
-                return results
+        # Class hierarchy: base lists, subtype sets, methods and member types
+        hierarchy = ClassHierarchy.build(self.raw_data, symbol_builder)
+        resolve_call = self._call_resolver(hierarchy)
         
         # Build graph: Symbol -> [Symbol]
         graph = {}
+        loop_depth = {}  # (caller, callee) -> deepest loop nesting of any call site on that edge
         for qname, sym in symbol_builder.symbols.items():
             if sym.type != STSymbolType.FUNCTION:
                 continue
             
             graph[sym] = []
-            
-            file_data = self.raw_data.get(str(sym.file))
-            if not file_data:
-                continue
-            
-            func_data = next(
-                (f for f in file_data["functions"]
-                 if f["name"] == sym.name and f["line"] == sym.line),
-                None
-            )
-            if not func_data:
-                continue
-            
-            for call_info in func_data.get("calls_detailed", []):
-                targets = resolve_call(call_info, sym)
-                for target in targets:
-                    if target and target != sym or (target == sym and call_info.get("receiver") != "super"):
-                        graph[sym].append(target)
+            for target, depth in self._call_targets(sym, resolve_call):
+                graph[sym].append(target)
+                edge = (sym.qualified_name, target.qualified_name)
+                loop_depth[edge] = max(loop_depth.get(edge, 0), depth)
+        self._sync_call_graph(graph)
+        nx.set_edge_attributes(self.call_graph, loop_depth, "loop_depth")
+        # Every call is resolved now: later update_call_graph calls start from here
+        self.hierarchy = hierarchy
+        self.stale_callers.clear()
+        self.stale_names.clear()
+        self._removed_shapes.clear()
+        self._shape_changes.clear()
         
         # Find Cycles (DFS)
         cycles = []
@@ -324,44 +452,137 @@ class StructuralAnalyzer:
         
         return unique_cycles
 
+    def _call_resolver(self, hierarchy: ClassHierarchy):
+        """resolve_call(call_info, caller_sym) -> target Symbols, over the current index."""
+        def resolve_call(call_info, caller_sym):
+            """Resolve a call to its target Symbol(s) based on receiver context."""
+            # C++/Java methods may call members without `this`
+            implicit_this = Path(str(caller_sym.file)).suffix != ".py"
+            targets = hierarchy.resolve_method_call(call_info, caller_sym.parent_name or None, implicit_this)
+            if targets is not None:
+                return targets
+
+            call_name = call_info["name"]
+            by_path = self.standalone.get(call_name, {})
+            if call_info.get("scoped"):
+                # ns::foo(): only free functions declared in that namespace (std::sort finds none),
+                # including out-of-line `ns::foo() {}` definitions whose `ns` is not a parsed class
+                namespace = call_info.get("receiver")
+                targets = [sym for fpath, sym in by_path.items()
+                           if self.namespace_of.get((fpath, call_name)) == namespace]
+                for qname in self.functions_named.get(call_name, ()):
+                    sym = self.symbol_table.symbols.get(qname)
+                    if sym is not None and sym.parent_name == namespace and sym not in targets:
+                        targets.append(sym)
+                return targets
+            
+            # Bare call: foo() -> same-file standalone function first
+            target = by_path.get(str(caller_sym.file))
+            if target:
+                return [target]
+            # Fallback: any standalone function with that name (cross-file)
+            return list(by_path.values())
+        return resolve_call
+
+    def _call_targets(self, sym: STSymbol, resolve_call) -> List[Tuple[STSymbol, int]]:
+        """(callee, loop depth) for every resolved call site in one function."""
+        file_data = self.file_data_map.get(str(sym.file))
+        if not file_data:
+            return []
+        func_data = next(
+            (f for f in file_data["functions"]
+             if f["name"] == sym.name and f["line"] == sym.line),
+            None
+        )
+        if not func_data:
+            return []
+        targets = []
+        for call_info in func_data.get("calls_detailed", []):
+            for target in resolve_call(call_info, sym):
+                if target and target != sym or (target == sym and call_info.get("receiver") != "super"):
+                    targets.append((target, call_info.get("loop_depth", 0)))
+        return targets
+
+    def update_call_graph(self):
+        """
+        Bring call_graph up to date after index_file/remove_file without resolving every call
+        again: only functions of changed files and callers naming something that changed (a
+        function, method, field, return type or class, in the call or its receiver) are
+        re-resolved, and the edge delta goes through the reachability index.
+        """
+        changes = self._shape_changes + [(shape, self.EMPTY_SHAPE) for shape in self._removed_shapes.values()
+                                         if shape != self.EMPTY_SHAPE]
+        if self.hierarchy is None:
+            self.hierarchy = ClassHierarchy.build(self.file_data_map, self.symbol_table)
+            callers = set(self.call_names_of)
+        else:
+            names = set(self.stale_names)
+            if changes:
+                old = self.hierarchy
+                self.hierarchy = ClassHierarchy.build(self.file_data_map, self.symbol_table)
+                names |= self._hierarchy_delta(changes, old, self.hierarchy)
+            callers = set(self.stale_callers)
+            for name in names:
+                callers |= self.callers_of.get(name, set())
+        self.stale_callers.clear()
+        self.stale_names.clear()
+        self._removed_shapes.clear()
+        self._shape_changes.clear()
+
+        resolve_call = self._call_resolver(self.hierarchy)
+        for qname in callers:
+            sym = self.symbol_table.symbols.get(qname)
+            if sym is None or sym.type != STSymbolType.FUNCTION:
+                continue
+            depth = {}
+            for target, loop_depth in self._call_targets(sym, resolve_call):
+                callee = target.qualified_name
+                depth[callee] = max(depth.get(callee, 0), loop_depth)
+            old = set(self.call_graph.successors(qname)) if self.call_graph.has_node(qname) else set()
+            for callee in old - depth.keys():
+                self.reachability.remove_edge(qname, callee)
+            for callee in depth.keys() - old:
+                self.reachability.add_edge(qname, callee)
+            for callee, loop_depth in depth.items():
+                self.call_graph.edges[qname, callee]["loop_depth"] = loop_depth
+
+    def _sync_call_graph(self, graph: Dict[STSymbol, List[STSymbol]]):
+        """
+        Mirror resolved calls into call_graph. Only the edge delta goes through
+        the reachability index, so re-checks after small edits stay incremental.
+        """
+        edges = {(sym.qualified_name, target.qualified_name)
+                 for sym, targets in graph.items() for target in targets}
+        current = set(self.call_graph.edges())
+        for u, v in current - edges:
+            self.reachability.remove_edge(u, v)
+        for u, v in edges - current:
+            self.reachability.add_edge(u, v)
+
     def _detect_dead_code(self, symbol_builder: SymbolTableBuilder) -> List[Dict]:
         """Find functions that are never called anywhere across all files."""
-        # Collect ALL calls from ALL files
-        all_calls = set()
-        for data in self.raw_data.values():
-            for call in data.get("calls", []):
-                all_calls.add(call)
+        return [symbol for symbol in symbol_builder.symbols.values() if self._is_dead(symbol)]
+
+    def _is_dead(self, symbol: STSymbol) -> bool:
+        """A function no indexed file calls (by name), excluding entry points and framework hooks."""
+        # Only check functions and methods
+        if symbol.type != STSymbolType.FUNCTION:
+            return False
         
-        # Collect decorated function names — these are called by frameworks implicitly
-        decorated_funcs = set()
-        for data in self.raw_data.values():
-            for func in data.get("functions", []):
-                if func.get("decorators"):
-                    decorated_funcs.add(func["name"])
+        # Skip ALL dunder methods (__init__, __del__, __str__, __repr__, etc.)
+        if symbol.name.startswith("__") and symbol.name.endswith("__"):
+            return False
         
-        dead = []
-        for qname, symbol in symbol_builder.symbols.items():
-            # Only check functions and methods
-            if symbol.type != STSymbolType.FUNCTION:
-                continue
-            
-            # Skip ALL dunder methods (__init__, __del__, __str__, __repr__, etc.)
-            if symbol.name.startswith("__") and symbol.name.endswith("__"):
-                continue
-            
-            # Skip main/test functions
-            if "test" in symbol.name.lower() or "main" in symbol.name.lower():
-                continue
-            
-            # Skip decorated functions (called by frameworks: @property, @route, etc.)
-            if symbol.name in decorated_funcs:
-                continue
-            
-            # Check if this function name appears in ANY call across ALL files
-            if symbol.name not in all_calls:
-                dead.append(symbol)
+        # Skip main/test functions
+        if "test" in symbol.name.lower() or "main" in symbol.name.lower():
+            return False
         
-        return dead
+        # Skip decorated functions (called by frameworks: @property, @route, etc.)
+        if symbol.name in self.decorated_counts:
+            return False
+        
+        # Check if this function name appears in ANY call across ALL files
+        return symbol.name not in self.call_counts
 
     def _detect_unused_variables(self, symbol_builder: SymbolTableBuilder) -> List[Dict]:
         """
@@ -380,115 +601,124 @@ class StructuralAnalyzer:
                 for name in imp.get("names", []):
                     cross_file_used.add(name)
         
-        for file_path_str, data in self.raw_data.items():
-            fpath = Path(file_path_str)
-            mod_name = fpath.stem
-            
+        for file_path_str in self.raw_data:
             try:
-                with open(fpath, 'r', encoding='utf-8') as f:
+                with open(file_path_str, 'r', encoding='utf-8') as f:
                     code = f.read()
                 tree = ast.parse(code)
             except:
                 continue
+            unused.extend(self._unused_in_tree(file_path_str, tree, cross_file_used))
+        
+        return unused
+
+    def _unused_in_tree(self, file_path_str: str, tree, cross_file_used: Set[str]) -> List[Dict]:
+        """Unused globals and locals of one parsed Python file."""
+        import ast
+        
+        fpath = Path(file_path_str)
+        unused = []
+        
+        # Track assignments with line numbers and all usages per scope
+        class UsageVisitor(ast.NodeVisitor):
+            def __init__(self):
+                self.scope_stack = ["global"]
+                # scope -> {name: line_number}
+                self.assigns = {"global": {}}
+                # scope -> set of used names
+                self.usages = {"global": set()}
+                # Track function parameter names to exclude them
+                self.params = {"global": set()}
             
-            # Track assignments with line numbers and all usages per scope
-            class UsageVisitor(ast.NodeVisitor):
-                def __init__(self):
-                    self.scope_stack = ["global"]
-                    # scope -> {name: line_number}
-                    self.assigns = {"global": {}}
-                    # scope -> set of used names
-                    self.usages = {"global": set()}
-                    # Track function parameter names to exclude them
-                    self.params = {"global": set()}
-                
-                @property
-                def scope(self):
-                    return self.scope_stack[-1]
-                
-                def visit_FunctionDef(self, node):
-                    scope_name = node.name
-                    self.scope_stack.append(scope_name)
-                    self.assigns[scope_name] = {}
-                    self.usages[scope_name] = set()
-                    self.params[scope_name] = set()
-                    
-                    # Mark function parameters as params (not unused variables)
-                    for arg in node.args.args:
-                        self.params[scope_name].add(arg.arg)
-                    if node.args.vararg:
-                        self.params[scope_name].add(node.args.vararg.arg)
-                    if node.args.kwarg:
-                        self.params[scope_name].add(node.args.kwarg.arg)
-                    
-                    self.generic_visit(node)
-                    self.scope_stack.pop()
+            @property
+            def scope(self):
+                return self.scope_stack[-1]
+            
+            def visit_FunctionDef(self, node):
+                scope_name = node.name
+                self.scope_stack.append(scope_name)
+                self.assigns[scope_name] = {}
+                self.usages[scope_name] = set()
+                self.params[scope_name] = set()
                 
-                visit_AsyncFunctionDef = visit_FunctionDef
+                # Mark function parameters as params (not unused variables)
+                for arg in node.args.args:
+                    self.params[scope_name].add(arg.arg)
+                if node.args.vararg:
+                    self.params[scope_name].add(node.args.vararg.arg)
+                if node.args.kwarg:
+                    self.params[scope_name].add(node.args.kwarg.arg)
                 
-                def visit_Name(self, node):
-                    if isinstance(node.ctx, ast.Store):
-                        self.assigns[self.scope][node.id] = node.lineno
-                    elif isinstance(node.ctx, (ast.Load, ast.Del)):
-                        self.usages[self.scope].add(node.id)
-                    self.generic_visit(node)
+                self.generic_visit(node)
+                self.scope_stack.pop()
             
-            visitor = UsageVisitor()
-            visitor.visit(tree)
+            visit_AsyncFunctionDef = visit_FunctionDef
             
-            # Check globals: unused if not used in same file AND not imported by other files
-            for name, line in visitor.assigns["global"].items():
-                # Skip dunder names
-                if name.startswith("__") and name.endswith("__"):
+            def visit_Name(self, node):
+                if isinstance(node.ctx, ast.Store):
+                    self.assigns[self.scope][node.id] = node.lineno
+                elif isinstance(node.ctx, (ast.Load, ast.Del)):
+                    self.usages[self.scope].add(node.id)
+                self.generic_visit(node)
+        
+        visitor = UsageVisitor()
+        visitor.visit(tree)
+        
+        # Check globals: unused if not used in same file AND not imported by other files
+        for name, line in visitor.assigns["global"].items():
+            # Skip dunder names
+            if name.startswith("__") and name.endswith("__"):
+                continue
+            # Skip _ prefix (deliberately unused)
+            if name.startswith("_"):
+                continue
+            # Check usage in global scope
+            if name in visitor.usages["global"]:
+                continue
+            # Check usage in any local scope within same file
+            used_locally = False
+            for scope, usage_set in visitor.usages.items():
+                if scope != "global" and name in usage_set:
+                    used_locally = True
+                    break
+            if used_locally:
+                continue
+            # Check cross-file usage (imported by other files)
+            if name in cross_file_used:
+                continue
+            
+            unused.append({
+                "file": fpath.name,
+                "path": file_path_str,
+                "line": line,
+                "name": name,
+                "type": "global_variable"
+            })
+        
+        # Check locals: unused if assigned but never loaded in same scope
+        for scope, assigns in visitor.assigns.items():
+            if scope == "global":
+                continue
+            usages = visitor.usages.get(scope, set())
+            params = visitor.params.get(scope, set())
+            for name, line in assigns.items():
+                # Skip parameters
+                if name in params:
                     continue
-                # Skip _ prefix (deliberately unused)
+                # Skip _ prefix
                 if name.startswith("_"):
                     continue
-                # Check usage in global scope
-                if name in visitor.usages["global"]:
-                    continue
-                # Check usage in any local scope within same file
-                used_locally = False
-                for scope, usage_set in visitor.usages.items():
-                    if scope != "global" and name in usage_set:
-                        used_locally = True
-                        break
-                if used_locally:
-                    continue
-                # Check cross-file usage (imported by other files)
-                if name in cross_file_used:
-                    continue
-                
-                unused.append({
-                    "file": fpath.name,
-                    "line": line,
-                    "name": name,
-                    "type": "global_variable"
-                })
-            
-            # Check locals: unused if assigned but never loaded in same scope
-            for scope, assigns in visitor.assigns.items():
-                if scope == "global":
+                # Skip dunder
+                if name.startswith("__") and name.endswith("__"):
                     continue
-                usages = visitor.usages.get(scope, set())
-                params = visitor.params.get(scope, set())
-                for name, line in assigns.items():
-                    # Skip parameters
-                    if name in params:
-                        continue
-                    # Skip _ prefix
-                    if name.startswith("_"):
-                        continue
-                    # Skip dunder
-                    if name.startswith("__") and name.endswith("__"):
-                        continue
-                    if name not in usages:
-                        unused.append({
-                            "file": fpath.name,
-                            "line": line,
-                            "name": f"{scope}.{name}",
-                            "type": "local_variable"
-                        })
-        
+                if name not in usages:
+                    unused.append({
+                        "file": fpath.name,
+                        "path": file_path_str,
+                        "line": line,
+                        "name": f"{scope}.{name}",
+                        "type": "local_variable"
+                    })
+    
         return unused
 
@@ -0,0 +1,120 @@
+"""
+Syntax Fix Cache
+Reuses LLM syntax-fix suggestions for error shapes that were already fixed.
+
+Entries are keyed on (language, normalised error message, hash of the
+normalised focus lines and surrounding window), so the same broken snippet
+copied across generated or vendored files costs one LLM round-trip. Only
+fixes that made the error go away on reparse are stored, and every hit is
+re-applied to the current code and reparsed again before it is reused.
+"""
+
+import hashlib
+import json
+import re
+from collections import OrderedDict
+from pathlib import Path
+from typing import Callable, List, Optional, Tuple
+
+# (code, extension) -> (is_valid, errors); StaticSyntaxAnalyzer.analyze_code
+Validator = Callable[[str, str], Tuple[bool, list]]
+
+
+class SyntaxFixCache:
+    """LRU map from error context to the replacement lines the LLM proposed."""
+
+    MAX_ENTRIES = 4096
+
+    # Positions differ between copies of the same error; the message shape does not
+    _PY_LOCATION = re.compile(r"\s*\(<[^>]*>, line \d+\)")
+    _LINE_NUMBER = re.compile(r"\bline \d+")
+
+    def __init__(self, validator: Validator, path: Optional[Path] = None):
+        self.validator = validator
+        self.path = path
+        self.entries: "OrderedDict[str, dict]" = OrderedDict()
+        self.stats = {"hits": 0, "misses": 0, "rejected": 0, "stored": 0}
+        self.dirty = False  # changed since load/save; written once by save() after the syntax phase
+        if path and path.exists():
+            try:
+                data = json.loads(path.read_text(encoding='utf-8'))
+                self.entries.update((k, v) for k, v in data.items() if isinstance(v, dict))
+            except (OSError, ValueError) as e:
+                print(f"Warning: Could not read syntax fix cache {path}: {e}")
+
+    # ── Keys ─────────────────────────────────────────────────────────
+
+    @classmethod
+    def normalize_message(cls, message: str) -> str:
+        message = cls._PY_LOCATION.sub("", message)
+        message = cls._LINE_NUMBER.sub("line N", message)
+        return " ".join(message.split())
+
+    @staticmethod
+    def normalize_code(code: str) -> str:
+        """Whitespace-insensitive form: indentation is re-applied when a fix is reused."""
+        return "\n".join(" ".join(line.split()) for line in code.splitlines())
+
+    def key(self, language: str, message: str, focus_code: str, window_code: str) -> str:
+        digest = hashlib.sha256(
+            f"{self.normalize_code(focus_code)}\0{self.normalize_code(window_code)}".encode()
+        ).hexdigest()
+        return f"{language}\0{self.normalize_message(message)}\0{digest}"
+
+    # ── Lookup / store ───────────────────────────────────────────────
+
+    def get(self, key: str) -> Optional[dict]:
+        entry = self.entries.get(key)
+        if entry is None:
+            self.stats["misses"] += 1
+            return None
+        self.stats["hits"] += 1
+        self.entries.move_to_end(key)
+        self.dirty = True  # recency decides what is evicted next run
+        return entry
+
+    def put(self, key: str, fixed_lines: List[str], explanation: str):
+        self.entries[key] = {"lines": [line.strip() for line in fixed_lines], "explanation": explanation}
+        self.entries.move_to_end(key)
+        while len(self.entries) > self.MAX_ENTRIES:
+            self.entries.popitem(last=False)
+        self.stats["stored"] += 1
+        self.dirty = True
+
+    def discard(self, key: str):
+        """Drop an entry whose fix no longer reparses cleanly."""
+        if self.entries.pop(key, None) is not None:
+            self.stats["rejected"] += 1
+            self.dirty = True
+
+    def save(self):
+        """Write the entries if anything changed since the last save."""
+        if not self.path or not self.dirty:
+            return
+        try:
+            self.path.write_text(json.dumps(self.entries), encoding='utf-8')
+            self.dirty = False
+        except OSError as e:
+            print(f"Warning: Could not write syntax fix cache {self.path}: {e}")
+
+    # ── Revalidation ─────────────────────────────────────────────────
+
+    def fixes_error(self, original_code: str, patched_code: str, extension: str,
+                    patch_start: int, patch_end: int) -> bool:
+        """
+        True if reparsing `patched_code` shows no error inside the patched lines
+        (1-based, inclusive) and no error that was not there before the patch.
+        """
+        valid, after = self.validator(patched_code, extension)
+        if valid:
+            return True
+        _, before = self.validator(original_code, extension)
+        if len(after) > len(before):
+            return False
+        known_lines = {e.line for e in before}
+        for err in after:
+            if patch_start - 1 <= err.line <= patch_end:
+                return False
+            if err.line < patch_start and err.line not in known_lines:
+                return False
+        return True
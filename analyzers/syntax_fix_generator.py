@@ -12,9 +12,10 @@ class SyntaxFixGenerator:
     CONTEXT_LINES_AFTER = 10   # Lines after error
     MAX_LINES_FOR_WHOLE_FILE = 100  # Threshold for whole-file vs regional
     
-    def __init__(self, llm_client):
+    def __init__(self, llm_client, fix_cache=None):
         self.llm_client = llm_client
         self.diff_analyzer = DiffAnalyzer()
+        self.fix_cache = fix_cache  # Optional SyntaxFixCache reused across errors and files
     
     async def generate_fix(
         self, 
@@ -280,6 +281,19 @@ Explanation: Added missing colon.
 Now fix the broken line.
 """
         
+        # Same error shape seen before: reuse the fix if it still reparses cleanly
+        cache_key = None
+        if self.fix_cache is not None:
+            cache_key = self.fix_cache.key(language, error.message, focus_code, code_window)
+            cached = self.fix_cache.get(cache_key)
+            if cached:
+                result = self._patch_window(window_lines, error_in_window, start_line, region, cached["lines"])
+                if self._fix_reparses(code, file_path, result):
+                    result['explanation'] = cached.get("explanation", "Fixed syntax error.") + " (cached fix)"
+                    result['cached'] = True
+                    return result
+                self.fix_cache.discard(cache_key)
+        
         if verbose:
             print(f"\n[VERBOSE] Generating fix with prompt:\n{'-'*40}\n{prompt}\n{'-'*40}")
         
@@ -298,73 +312,14 @@ Now fix the broken line.
                 if not fixed_code or self._is_placeholder_text(fixed_code, 1):
                     raise ValueError("LLM returned placeholder text instead of actual code")
             
-            # --- START SMARTER REPLACEMENT LOGIC ---
             fixed_lines = fixed_code.strip().splitlines()
-            # Match indentation of the focus line
-            error_line_original = window_lines[error_in_window]
-            error_indent_len = len(error_line_original) - len(error_line_original.lstrip())
-            error_indent = error_line_original[:error_indent_len]
-            
-            # Apply error line's base indent to all LLM lines
-            # This ensures that even if LLM returns 0-indent code, it's correctly placed
-            fixed_lines = [(error_indent + line.lstrip()) for line in fixed_lines]
-            
-            # Reconstruct the window while checking for overlaps
-            reconstructed = list(window_lines)
-            
-            # If the LLM returned multiple lines, it might have included lines that exist below
-            replace_count = 1
-            if len(fixed_lines) > 1:
-                for i in range(1, len(fixed_lines)):
-                    window_idx = error_in_window + i
-                    if window_idx < len(window_lines):
-                        if fixed_lines[i].strip() == window_lines[window_idx].strip():
-                            replace_count = i + 1
-            
-            # Replace the appropriate range
-            reconstructed[error_in_window:error_in_window + replace_count] = fixed_lines
-            
-            # --- START MINIMAL PATCH CALCULATION ---
-            # Instead of returning the whole window, find the actual changed range
-            import difflib
-            matcher = difflib.SequenceMatcher(None, window_lines, reconstructed)
-            
-            # Find the cluster of changes
-            has_changes = False
-            first_op = None
-            last_op = None
+            result = self._patch_window(window_lines, error_in_window, start_line, region, fixed_lines)
+            result['explanation'] = explanation
             
-            for op in matcher.get_opcodes():
-                if op[0] != 'equal':
-                    if first_op is None: first_op = op
-                    last_op = op
-                    has_changes = True
-            
-            if has_changes:
-                # Range in Original (window_lines)
-                start_change_orig = first_op[1]
-                end_change_orig = last_op[2] # Exclusive
-                # Range in New (reconstructed)
-                start_change_new = first_op[3]
-                end_change_new = last_op[4] # Exclusive
-                
-                # Update region to reflect only the changed block
-                region['start_line'] = start_line + start_change_orig + 1
-                region['end_line'] = start_line + end_change_orig
-                
-                # Grab the fixed code segment
-                final_fixed_lines = reconstructed[start_change_new:end_change_new]
-                fixed_code = '\n'.join(final_fixed_lines)
-            else:
-                # Fallback
-                fixed_code = '\n'.join(reconstructed)
-
-            return {
-                'success': True,
-                'fixed_code': fixed_code,
-                'region': region,
-                'explanation': explanation
-            }
+            # Only fixes that actually clear the error are worth reusing
+            if cache_key and self._fix_reparses(code, file_path, result):
+                self.fix_cache.put(cache_key, fixed_lines, explanation)
+            return result
             
         except Exception as e:
             return {
@@ -373,6 +328,83 @@ Now fix the broken line.
                 'region': region
             }
     
+    def _patch_window(self, window_lines: List[str], error_in_window: int, start_line: int,
+                      region: Dict, fixed_lines: List[str]) -> Dict:
+        """Place the LLM's replacement lines at the error and reduce the window to the changed block."""
+        # --- START SMARTER REPLACEMENT LOGIC ---
+        # Match indentation of the focus line
+        error_line_original = window_lines[error_in_window]
+        error_indent_len = len(error_line_original) - len(error_line_original.lstrip())
+        error_indent = error_line_original[:error_indent_len]
+        
+        # Apply error line's base indent to all LLM lines
+        # This ensures that even if LLM returns 0-indent code, it's correctly placed
+        fixed_lines = [(error_indent + line.lstrip()) for line in fixed_lines]
+        
+        # Reconstruct the window while checking for overlaps
+        reconstructed = list(window_lines)
+        
+        # If the LLM returned multiple lines, it might have included lines that exist below
+        replace_count = 1
+        if len(fixed_lines) > 1:
+            for i in range(1, len(fixed_lines)):
+                window_idx = error_in_window + i
+                if window_idx < len(window_lines):
+                    if fixed_lines[i].strip() == window_lines[window_idx].strip():
+                        replace_count = i + 1
+        
+        # Replace the appropriate range
+        reconstructed[error_in_window:error_in_window + replace_count] = fixed_lines
+        
+        # --- START MINIMAL PATCH CALCULATION ---
+        # Instead of returning the whole window, find the actual changed range
+        import difflib
+        matcher = difflib.SequenceMatcher(None, window_lines, reconstructed)
+        
+        # Find the cluster of changes
+        has_changes = False
+        first_op = None
+        last_op = None
+        
+        for op in matcher.get_opcodes():
+            if op[0] != 'equal':
+                if first_op is None: first_op = op
+                last_op = op
+                has_changes = True
+        
+        region = dict(region)
+        if has_changes:
+            # Range in Original (window_lines)
+            start_change_orig = first_op[1]
+            end_change_orig = last_op[2] # Exclusive
+            # Range in New (reconstructed)
+            start_change_new = first_op[3]
+            end_change_new = last_op[4] # Exclusive
+            
+            # Update region to reflect only the changed block
+            region['start_line'] = start_line + start_change_orig + 1
+            region['end_line'] = start_line + end_change_orig
+            
+            # Grab the fixed code segment
+            final_fixed_lines = reconstructed[start_change_new:end_change_new]
+            fixed_code = '\n'.join(final_fixed_lines)
+        else:
+            # Fallback
+            fixed_code = '\n'.join(reconstructed)
+
+        return {
+            'success': True,
+            'fixed_code': fixed_code,
+            'region': region
+        }
+    
+    def _fix_reparses(self, code: str, file_path: Path, result: Dict) -> bool:
+        """Apply a proposed fix to the full code and check the error is gone on reparse."""
+        region = result['region']
+        patched = self.apply_patch_to_code(code, region, result['fixed_code'])
+        patch_end = region['start_line'] + len(result['fixed_code'].split('\n')) - 1
+        return self.fix_cache.fixes_error(code, patched, file_path.suffix.lower(), region['start_line'], patch_end)
+    
     def _parse_fix_response(self, response: str, original_code: str = None):
         """Parse LLM response into fixed_code and explanation."""
         import difflib
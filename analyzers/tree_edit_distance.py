@@ -0,0 +1,254 @@
+"""
+Tree Edit Distance Verifier
+Local structural check for clone candidates in the mid-similarity band.
+
+Builds normalised trees (Python AST or Tree-sitter, identifiers and literal
+values erased) and computes Zhang–Shasha tree edit distance. Cheap lower
+bounds (size and label-histogram difference) reject obvious non-clones
+before the quadratic DP runs; oversized trees are escalated instead.
+"""
+
+import ast
+import textwrap
+from collections import Counter
+from typing import List, Optional, Tuple
+
+try:
+    import tree_sitter_languages
+    TREESITTER_AVAILABLE = True
+except ImportError:
+    TREESITTER_AVAILABLE = False
+
+
+class TreeNode:
+    __slots__ = ("label", "children")
+
+    def __init__(self, label: str, children: List["TreeNode"] = None):
+        self.label = label
+        self.children = children or []
+
+
+class TreeEditVerifier:
+    """
+    Decides "duplicate" / "distinct" / "ambiguous" for a candidate pair.
+    Only "ambiguous" pairs need to go to the LLM.
+    """
+
+    ACCEPT_SIMILARITY = 0.85   # TED similarity at or above → duplicate
+    REJECT_SIMILARITY = 0.45   # TED similarity at or below → distinct
+    MAX_NODES = 600            # larger trees are escalated rather than compared
+    SEMANTIC_RELABEL_COST = 4  # changing an operator or callee is not a rename
+
+    SEMANTIC_PREFIXES = ("BinOp_", "BoolOp_", "Compare_", "AugAssign_", "UnaryOp_", "Call:", "op")
+    TS_OPERATORS = {'+', '-', '*', '/', '%', '<', '>', '<=', '>=', '==', '!=', '&&', '||',
+                    '+=', '-=', '*=', '/=', '<<', '>>', '&', '|', '^', '!'}
+
+    TS_LANGS = {'.c': 'c', '.h': 'cpp', '.cpp': 'cpp', '.cc': 'cpp', '.hpp': 'cpp', '.java': 'java'}
+
+    def __init__(self):
+        self._ts_parsers = {}
+
+    def verify(self, code1: str, ext1: str, code2: str, ext2: str) -> Tuple[str, Optional[float]]:
+        """Return (decision, similarity); similarity is None when no tree could be built."""
+        t1 = self.build_tree(code1, ext1)
+        t2 = self.build_tree(code2, ext2)
+        if t1 is None or t2 is None:
+            return "ambiguous", None
+
+        nodes1, nodes2 = self._postorder(t1), self._postorder(t2)
+        n1, n2 = len(nodes1), len(nodes2)
+        largest = max(n1, n2)
+
+        # Size pruning: TED ≥ |n1 - n2| and ≥ half the label-histogram L1 distance
+        hist1 = Counter(n.label for n in nodes1)
+        hist2 = Counter(n.label for n in nodes2)
+        l1 = sum(((hist1 - hist2) + (hist2 - hist1)).values())
+        lower_bound = max(abs(n1 - n2), (l1 + 1) // 2)
+        upper_sim = 1.0 - lower_bound / largest
+        if upper_sim <= self.REJECT_SIMILARITY:
+            return "distinct", upper_sim
+        if largest > self.MAX_NODES:
+            return "ambiguous", upper_sim
+
+        similarity = 1.0 - self.distance(t1, t2) / largest
+        # "Same tree up to renaming" requires identical operators and callees
+        same_semantics = (
+            {k: v for k, v in hist1.items() if k.startswith(self.SEMANTIC_PREFIXES)}
+            == {k: v for k, v in hist2.items() if k.startswith(self.SEMANTIC_PREFIXES)}
+        )
+        if similarity >= self.ACCEPT_SIMILARITY and same_semantics:
+            return "duplicate", similarity
+        if similarity <= self.REJECT_SIMILARITY:
+            return "distinct", similarity
+        return "ambiguous", similarity
+
+    # ── Tree construction ────────────────────────────────────────────
+
+    def build_tree(self, code: str, extension: str) -> Optional[TreeNode]:
+        code = code.strip()
+        if not code:
+            return None
+        if extension == '.py':
+            return self._python_tree(code)
+        if extension in self.TS_LANGS:
+            return self._treesitter_tree(code, self.TS_LANGS[extension])
+        return None
+
+    def _python_tree(self, code: str) -> Optional[TreeNode]:
+        try:
+            tree = ast.parse(textwrap.dedent(code))
+        except SyntaxError:
+            return None
+        if tree.body and isinstance(tree.body[0], (ast.FunctionDef, ast.AsyncFunctionDef)):
+            # Compare bodies, not the def line (names/decorators differ by design)
+            func = tree.body[0]
+            root = TreeNode("FunctionDef", [self._py_node(stmt, func.name) for stmt in func.body])
+            return root
+        return self._py_node(tree)
+
+    def _py_node(self, node: ast.AST, own_name: str = "") -> TreeNode:
+        # Same token scheme as the structural fingerprint
+        if isinstance(node, ast.BinOp):
+            label = f"BinOp_{type(node.op).__name__}"
+        elif isinstance(node, ast.AugAssign):
+            label = f"AugAssign_{type(node.op).__name__}"
+        elif isinstance(node, ast.UnaryOp):
+            label = f"UnaryOp_{type(node.op).__name__}"
+        elif isinstance(node, ast.Call):
+            # Keep the callee: eval(x) and pickle.loads(x) must not look alike
+            if isinstance(node.func, ast.Name) and node.func.id == own_name:
+                label = "Call:<self>"  # recursion is a rename, not a different callee
+            elif isinstance(node.func, ast.Name):
+                label = f"Call:{node.func.id}"
+            elif isinstance(node.func, ast.Attribute):
+                label = f"Call:.{node.func.attr}"
+            else:
+                label = "Call"
+        elif isinstance(node, ast.BoolOp):
+            label = f"BoolOp_{type(node.op).__name__}"
+        elif isinstance(node, ast.Compare):
+            label = "Compare_" + "_".join(type(op).__name__ for op in node.ops)
+        elif isinstance(node, ast.JoinedStr):
+            label = "FStr"
+        elif isinstance(node, ast.Constant):
+            if isinstance(node.value, str):
+                label = "ConstStr"
+            elif isinstance(node.value, (int, float)):
+                label = "ConstNum"
+            else:
+                label = "Const"
+        else:
+            label = type(node).__name__
+
+        children = [
+            self._py_node(child, own_name) for child in ast.iter_child_nodes(node)
+            if not isinstance(child, (ast.expr_context, ast.operator, ast.boolop, ast.cmpop, ast.unaryop))
+        ]
+        return TreeNode(label, children)
+
+    def _treesitter_tree(self, code: str, lang_id: str) -> Optional[TreeNode]:
+        parser = self._get_ts_parser(lang_id)
+        if parser is None:
+            return None
+        try:
+            root = parser.parse(bytes(code, "utf8")).root_node
+        except Exception:
+            return None
+
+        def convert(node) -> TreeNode:
+            # Named nodes only; identifier/literal text is dropped, operators and callees kept
+            label = node.type
+            if node.type in ('call_expression', 'method_invocation'):
+                callee = node.child_by_field_name('name') or node.child_by_field_name('function')
+                if callee is not None:
+                    text = callee.text.decode('utf8', errors='replace')
+                    label = "Call:" + text.replace('::', '.').replace('->', '.').split('.')[-1]
+            children = []
+            for child in node.children:
+                if child.is_named:
+                    children.append(convert(child))
+                elif child.type in self.TS_OPERATORS:
+                    children.append(TreeNode(f"op{child.type}"))
+            return TreeNode(label, children)
+
+        return convert(root)
+
+    def _get_ts_parser(self, lang_id: str):
+        if not TREESITTER_AVAILABLE:
+            return None
+        if lang_id not in self._ts_parsers:
+            try:
+                self._ts_parsers[lang_id] = tree_sitter_languages.get_parser(lang_id)
+            except Exception:
+                self._ts_parsers[lang_id] = None
+        return self._ts_parsers[lang_id]
+
+    # ── Zhang–Shasha ─────────────────────────────────────────────────
+
+    @staticmethod
+    def _postorder(root: TreeNode) -> List[TreeNode]:
+        out, stack = [], [(root, False)]
+        while stack:
+            node, expanded = stack.pop()
+            if expanded:
+                out.append(node)
+            else:
+                stack.append((node, True))
+                for child in reversed(node.children):
+                    stack.append((child, False))
+        return out
+
+    @classmethod
+    def _annotate(cls, root: TreeNode):
+        """Postorder labels, leftmost-leaf indices and keyroots (1-based)."""
+        nodes = cls._postorder(root)
+        index = {id(n): i + 1 for i, n in enumerate(nodes)}
+        leftmost = [0] * (len(nodes) + 1)
+        for i, node in enumerate(nodes, 1):
+            leftmost[i] = leftmost[index[id(node.children[0])]] if node.children else i
+        labels = [None] + [n.label for n in nodes]
+
+        seen = {}
+        for i in range(1, len(nodes) + 1):
+            seen[leftmost[i]] = i  # highest node for each leftmost leaf
+        keyroots = sorted(seen.values())
+        return labels, leftmost, keyroots
+
+    @classmethod
+    def _relabel_cost(cls, a: str, b: str) -> int:
+        if a == b:
+            return 0
+        if a.startswith(cls.SEMANTIC_PREFIXES) and b.startswith(cls.SEMANTIC_PREFIXES):
+            return cls.SEMANTIC_RELABEL_COST
+        return 1
+
+    @classmethod
+    def distance(cls, t1: TreeNode, t2: TreeNode) -> int:
+        """Tree edit distance: unit insert/delete, relabel weighted by _relabel_cost."""
+        labels1, l1, keyroots1 = cls._annotate(t1)
+        labels2, l2, keyroots2 = cls._annotate(t2)
+        n1, n2 = len(labels1) - 1, len(labels2) - 1
+        treedist = [[0] * (n2 + 1) for _ in range(n1 + 1)]
+
+        for i in keyroots1:
+            for j in keyroots2:
+                li, lj = l1[i], l2[j]
+                rows, cols = i - li + 2, j - lj + 2
+                fd = [[0] * cols for _ in range(rows)]
+                for x in range(1, rows):
+                    fd[x][0] = fd[x - 1][0] + 1
+                for y in range(1, cols):
+                    fd[0][y] = fd[0][y - 1] + 1
+                for x in range(1, rows):
+                    di = li + x - 1
+                    for y in range(1, cols):
+                        dj = lj + y - 1
+                        if l1[di] == li and l2[dj] == lj:
+                            cost = cls._relabel_cost(labels1[di], labels2[dj])
+                            fd[x][y] = min(fd[x - 1][y] + 1, fd[x][y - 1] + 1, fd[x - 1][y - 1] + cost)
+                            treedist[di][dj] = fd[x][y]
+                        else:
+                            px = l1[di] - li
+                            py = l2[dj] - lj
+                            fd[x][y] = min(fd[x - 1][y] + 1, fd[x][y - 1] + 1, fd[px][py] + treedist[di][dj])
+        return treedist[n1][n2]
@@ -0,0 +1,414 @@
+"""
+Programmatic API
+Console-free entry point for embedding the analyzer in other services.
+
+    analyzer = Analyzer(AnalyzerConfig(llm_url="http://127.0.0.1:8000/v1"))
+    run = analyzer.run([Path("src")])
+    async for finding in run.phase("structural"):
+        ...
+
+Each phase is an async iterator of typed findings, fed as results are
+produced. The Analyzer instance keeps the LLM client (and its prompt
+cache), compilation databases and parse results (keyed by path and
+content hash) between runs.
+"""
+
+import asyncio
+import hashlib
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, AsyncIterator, Dict, List, Optional, Tuple
+
+from core.scanner import FileScanner
+from core.compile_db import CompilationDatabase
+from analyzers.static_syntax import StaticSyntaxAnalyzer
+from analyzers.static_bug_detector import StaticBugDetector
+from analyzers.structural_analyzer import StructuralAnalyzer
+from analyzers.cross_file_redundancy import CrossFileRedundancyDetector
+from analyzers.llm_bug_detector import LLMBugDetector
+from utils.context_builder import ContextBuilder
+
+
+PHASES = ("syntax", "structural", "static", "semantic", "redundancy", "performance")
+
+
+@dataclass
+class AnalyzerConfig:
+    """Options mirroring the `analyze` CLI flags (no interactive prompts)."""
+    llm_url: Optional[str] = None            # None → LLM-backed stages are skipped
+    model: str = "Qwen/Qwen2.5-Coder-7B-Instruct"
+    phases: Tuple[str, ...] = PHASES
+    compile_commands: Optional[Path] = None  # auto-discovered per directory when None
+    clone_index: Optional[Path] = None
+    repo_name: Optional[str] = None
+    redundancy_thresholds: Optional[Path] = None
+    severities: Tuple[str, ...] = ("critical", "high", "medium", "low")
+    llm_concurrency: int = 4                 # in-flight semantic audits (across all files)
+    max_memory_mb: Optional[int] = None      # spill parse results to disk (ParseStore) under this budget
+
+
+# ── Findings ─────────────────────────────────────────────────────────
+
+@dataclass
+class Finding:
+    phase = ""
+    file: str
+    line: int
+
+
+@dataclass
+class SyntaxFinding(Finding):
+    phase = "syntax"
+    column: int = 0
+    message: str = ""
+    parser: str = ""
+
+
+@dataclass
+class DeadCodeFinding(Finding):
+    phase = "structural"
+    name: str = ""
+    parent: str = ""
+
+
+@dataclass
+class UnusedVariableFinding(Finding):
+    phase = "structural"
+    name: str = ""
+    scope: str = "local"   # "global" or "local"
+
+
+@dataclass
+class CallCycleFinding(Finding):
+    phase = "structural"
+    members: List[str] = field(default_factory=list)   # qualified names, cycle order
+
+
+@dataclass
+class StaticFinding(Finding):
+    phase = "static"
+    message: str = ""
+
+
+@dataclass
+class SemanticFinding(Finding):
+    phase = "semantic"
+    symbol: str = ""
+    bug_type: str = ""
+    severity: str = ""
+    description: str = ""
+    suggestion: str = ""
+    corrected_code: str = ""
+
+
+@dataclass
+class DuplicateFinding(Finding):
+    phase = "redundancy"
+    name: str = ""
+    other_file: str = ""
+    other_line: int = 0
+    other_name: str = ""
+    similarity: float = 0.0
+    reason: str = ""
+    suggestion: str = ""
+
+
+@dataclass
+class PerformanceFinding(Finding):
+    phase = "performance"
+    rule: str = ""
+    function: str = ""
+    severity: str = ""
+    message: str = ""
+    suggestion: str = ""
+    priority: float = 0.0
+
+
+class _Done:
+    """End-of-phase marker; carries the producer's exception, if any."""
+    def __init__(self, error: Optional[BaseException] = None):
+        self.error = error
+
+
+# ── Streaming run ────────────────────────────────────────────────────
+
+class AnalysisRun:
+    """
+    One analysis over a set of paths. Phases run in order in a background
+    task; every phase (and the combined stream) can be consumed independently.
+    Unconsumed phases simply buffer.
+    """
+
+    def __init__(self, analyzer: "Analyzer", paths: List[Path]):
+        self.analyzer = analyzer
+        self.paths = paths
+        self.phases = tuple(p for p in PHASES if p in analyzer.config.phases)
+        self._queues: Dict[str, asyncio.Queue] = {}
+        self._closed = set()
+        self._all: Optional[asyncio.Queue] = None
+        self._task: Optional[asyncio.Task] = None
+
+    def _start(self):
+        if self._task is None:
+            self._queues = {p: asyncio.Queue() for p in self.phases}
+            self._all = asyncio.Queue()
+            self._task = asyncio.get_running_loop().create_task(self._produce())
+
+    async def _produce(self):
+        error = None
+        try:
+            async for finding in self.analyzer._run_phases(self.paths, self.phases, self._close_phase):
+                self._queues[finding.phase].put_nowait(finding)
+                self._all.put_nowait(finding)
+        except Exception as e:
+            error = e
+        finally:
+            for phase in self.phases:
+                self._close_phase(phase, error)
+            self._all.put_nowait(_Done(error))
+
+    def _close_phase(self, phase: str, error: Optional[BaseException] = None):
+        if phase in self._queues and phase not in self._closed:
+            self._closed.add(phase)
+            self._queues[phase].put_nowait(_Done(error))
+
+    @staticmethod
+    async def _drain(queue: asyncio.Queue) -> AsyncIterator[Finding]:
+        while True:
+            item = await queue.get()
+            if isinstance(item, _Done):
+                queue.put_nowait(item)  # later iterators end too
+                if item.error:
+                    raise item.error
+                return
+            yield item
+
+    async def phase(self, name: str) -> AsyncIterator[Finding]:
+        """Findings of one phase, as they are produced (consume each stream once)."""
+        if name not in self.phases:
+            raise ValueError(f"Phase {name!r} is not enabled (enabled: {', '.join(self.phases)})")
+        self._start()
+        async for finding in self._drain(self._queues[name]):
+            yield finding
+
+    def __aiter__(self) -> AsyncIterator[Finding]:
+        """All findings in production order."""
+        self._start()
+        return self._drain(self._all)
+
+    async def collect(self) -> Dict[str, List[Finding]]:
+        """Wait for the whole run; findings grouped by phase."""
+        grouped = {p: [] for p in self.phases}
+        async for finding in self:
+            grouped[finding.phase].append(finding)
+        return grouped
+
+    def cancel(self):
+        if self._task is not None:
+            self._task.cancel()
+
+
+class Analyzer:
+    """Reusable analyzer; state shared across runs lives here."""
+
+    def __init__(self, config: Optional[AnalyzerConfig] = None):
+        self.config = config or AnalyzerConfig()
+        unknown = set(self.config.phases) - set(PHASES)
+        if unknown:
+            raise ValueError(f"Unknown phase(s): {', '.join(sorted(unknown))}")
+
+        self.llm_client = None
+        if self.config.llm_url:
+            from llm.vllm_client import VLLMClient
+            self.llm_client = VLLMClient(base_url=self.config.llm_url, model=self.config.model)
+        self.static_detector = StaticBugDetector()
+        self.parse_cache: Dict[Tuple[str, str], Dict[str, Any]] = {}  # (path, content md5) -> parser output
+        self._compile_dbs: Dict[str, Optional[CompilationDatabase]] = {}
+        self.context_builder = ContextBuilder(self.llm_client)
+
+    def run(self, paths: List[Path]) -> AnalysisRun:
+        """Start lazily: nothing happens until one of the streams is iterated."""
+        return AnalysisRun(self, [Path(p) for p in paths])
+
+    # ── Phase driver ─────────────────────────────────────────────────
+
+    def _compile_db_for(self, root: Path) -> Optional[CompilationDatabase]:
+        if self.config.compile_commands:
+            key = str(self.config.compile_commands)
+            if key not in self._compile_dbs:
+                self._compile_dbs[key] = CompilationDatabase(self.config.compile_commands, project_root=root)
+            return self._compile_dbs[key]
+        key = str(root.resolve())
+        if key not in self._compile_dbs:
+            self._compile_dbs[key] = CompilationDatabase.discover(root)
+        return self._compile_dbs[key]
+
+    def _collect_files(self, paths: List[Path]) -> Tuple[List[Path], Optional[CompilationDatabase]]:
+        files, compile_db = [], None
+        for path in paths:
+            if path.is_dir():
+                db = self._compile_db_for(path)
+                compile_db = compile_db or db
+                files.extend(FileScanner(path, compile_db=db).scan())
+            elif path.is_file():
+                files.append(path)
+        return files, compile_db
+
+    def _parse(self, struct: StructuralAnalyzer, file_path: Path, code: str) -> Dict[str, Any]:
+        # Path is part of the key: #include resolution depends on the including file
+        key = (str(file_path), hashlib.md5(code.encode('utf-8', errors='replace')).hexdigest())
+        data = self.parse_cache.get(key)
+        if data is None:
+            data = struct.parser.parse(code, file_path)
+            if not self.config.max_memory_mb:  # bounded runs keep results only in the spill store
+                self.parse_cache[key] = data
+        return data
+
+    async def _run_phases(self, paths: List[Path], phases: Tuple[str, ...], close_phase) -> AsyncIterator[Finding]:
+        files, compile_db = self._collect_files(paths)
+        syntax = StaticSyntaxAnalyzer(compile_db=compile_db)
+
+        valid_files = []
+        for file_path in files:
+            is_valid, errors = syntax.analyze_file(file_path)
+            if is_valid:
+                valid_files.append(file_path)
+            elif "syntax" in phases:
+                for err in errors:
+                    yield SyntaxFinding(str(file_path), err.line, err.column, err.message, err.parser)
+            await asyncio.sleep(0)  # let consumers run between files
+        close_phase("syntax")
+
+        sources: Dict[Path, str] = {}
+        for file_path in valid_files:
+            try:
+                sources[file_path] = file_path.read_text(encoding='utf-8')
+            except (OSError, UnicodeDecodeError):
+                continue
+
+        struct = None
+        if {"structural", "semantic", "redundancy", "performance"} & set(phases):
+            store = None
+            if self.config.max_memory_mb:
+                from core.parse_store import ParseStore
+                store = ParseStore(self.config.max_memory_mb * 1024 * 1024)
+            struct = StructuralAnalyzer(compile_db=compile_db, parse_store=store)
+            for file_path, code in sources.items():
+                struct.index_file(file_path, self._parse(struct, file_path, code))
+            if "structural" in phases:
+                checks = struct.run_checks()
+                for sym in checks["dead_code"]:
+                    yield DeadCodeFinding(str(sym.file), sym.line, sym.name, sym.parent_name or "")
+                for var in checks["unused_variables"]:
+                    scope = "global" if var["type"] == "global_variable" else "local"
+                    yield UnusedVariableFinding(var.get("path", var["file"]), var["line"], var["name"], scope)
+                for cycle in checks["function_cycles"]:
+                    yield CallCycleFinding(str(cycle[0].file), cycle[0].line,
+                                           [s.qualified_name for s in cycle])
+        close_phase("structural")
+
+        if "static" in phases:
+            for file_path, code in sources.items():
+                if file_path.suffix != ".py":
+                    continue
+                for issue in self.static_detector.analyze_code(code):
+                    yield StaticFinding(str(file_path), issue.get("line", 0), issue.get("message", ""))
+        close_phase("static")
+
+        if "semantic" in phases and self.llm_client:
+            async for finding in self._semantic(struct, sources, compile_db):
+                yield finding
+            await self.llm_client.close()
+        close_phase("semantic")
+
+        if "redundancy" in phases and struct:
+            async for finding in self._redundancy(struct, paths):
+                yield finding
+        close_phase("redundancy")
+
+        if "performance" in phases and struct:
+            from analyzers.performance_audit import PerformanceAudit
+            if "structural" not in phases:
+                struct.run_checks(unused_variables=False)  # resolves the call graph the rules walk
+            for f in PerformanceAudit(struct).run():
+                yield PerformanceFinding(f.file, f.line, rule=f.rule, function=f.function, severity=f.severity,
+                                         message=f.message, suggestion=f.suggestion, priority=f.priority)
+        close_phase("performance")
+
+        if struct and hasattr(struct.file_data_map, "close"):
+            struct.file_data_map.close()
+
+    # ── Semantic phase ───────────────────────────────────────────────
+
+    async def _semantic(self, struct, sources: Dict[Path, str], compile_db) -> AsyncIterator[Finding]:
+        detector = LLMBugDetector(self.llm_client)
+        lang_map = {'.py': 'python', '.c': 'c', '.cpp': 'cpp', '.cc': 'cpp', '.h': 'c', '.hpp': 'cpp', '.java': 'java'}
+        semaphore = asyncio.Semaphore(max(1, self.config.llm_concurrency))
+
+        async def audit(file_path, language, context, name, code, func=None, hints=""):
+            file_ctx = await context
+            async with semaphore:
+                bugs, corrected = await detector.analyze_symbol(
+                    name, code, language, file_path,
+                    class_context=file_ctx.class_context(func) if func else "", dependency_hints=hints,
+                    **file_ctx.module_context(ContextBuilder.MODULE_TOKEN_BUDGET))
+            return file_path, name, bugs, corrected
+
+        # Every file's context is built concurrently; a symbol waits only for its own file's
+        jobs = []
+        for file_path, code in sources.items():
+            data = struct.file_data_map.get(str(file_path)) or self._parse(struct, file_path, code)
+            language = lang_map.get(file_path.suffix, 'python')
+            if compile_db and language in ('c', 'cpp'):
+                language = compile_db.language_for(file_path) or language
+            classes = [cls for cls in data.get("classes", []) if not cls.get("methods")]  # methods are functions
+            if not data.get("functions") and not classes:
+                continue
+            context = asyncio.ensure_future(self.context_builder.build(file_path, data, language))
+
+            for func in data.get("functions", []):
+                deps = "Functions this calls: " + ", ".join(func["calls"]) + "\n" if func.get("calls") else ""
+                jobs.append(audit(file_path, language, context, func["name"], func["body_code"],
+                                  func=func, hints=deps))
+            for cls in classes:
+                bases = f"Inherits from: {', '.join(cls['bases'])}\n" if cls.get("bases") else ""
+                jobs.append(audit(file_path, language, context, cls["name"], cls.get("body_code", ""),
+                                  hints=bases))
+
+        for done in asyncio.as_completed(jobs):
+            path, name, bugs, corrected = await done
+            for bug in bugs:
+                if bug.severity.lower() not in self.config.severities:
+                    continue
+                yield SemanticFinding(str(path), bug.line, symbol=name, bug_type=bug.type,
+                                      severity=bug.severity, description=bug.description,
+                                      suggestion=bug.suggestion, corrected_code=corrected)
+
+    # ── Redundancy phase ─────────────────────────────────────────────
+
+    async def _redundancy(self, struct, paths: List[Path]) -> AsyncIterator[Finding]:
+        index = None
+        if self.config.clone_index:
+            from analyzers.clone_index import CloneIndex
+            index = CloneIndex(self.config.clone_index)
+        thresholds = None
+        if self.config.redundancy_thresholds:
+            thresholds = CrossFileRedundancyDetector.load_thresholds(self.config.redundancy_thresholds)
+
+        repo_name = self.config.repo_name or (paths[0].resolve().name if paths else "")
+        detector = CrossFileRedundancyDetector(
+            struct.symbol_table, self.llm_client,
+            clone_index=index, repo_name=repo_name, thresholds=thresholds
+        )
+        try:
+            # Each pair is yielded once verified, not after every candidate has been compared
+            async for dup in detector.iter_duplicates():
+                f1, f2 = dup.functions[0], dup.functions[1]
+                yield DuplicateFinding(
+                    str(f1.file), f1.line, name=f1.name,
+                    other_file=str(f2.file), other_line=f2.line, other_name=f2.name,
+                    similarity=dup.similarity, reason=dup.reason, suggestion=dup.suggestion,
+                )
+        finally:
+            if index:
+                index.close()
@@ -5,15 +5,24 @@ Uses native AST for Python and Tree-sitter for C, C++, and Java.
 """
 
 import ast
+import re
 from pathlib import Path
 from typing import List, Dict, Any, Optional
 import tree_sitter_languages
 from tree_sitter import Parser, Language, Query
+from core.compile_db import INCLUDE_RE
 
 class StructuralParser:
     """Extracts structural information from source files using AST or Tree-sitter."""
 
-    def __init__(self):
+    # Tree-sitter node types used for class-hierarchy extraction (C++ and Java)
+    TS_CLASS_NODES = {'class_specifier', 'struct_specifier', 'class_declaration', 'interface_declaration'}
+    TS_TYPE_NODES = {'type_identifier', 'qualified_type_identifier', 'scoped_type_identifier',
+                     'template_type', 'generic_type'}
+    SMART_POINTERS = {'unique_ptr', 'shared_ptr', 'weak_ptr', 'optional', 'Optional'}
+
+    def __init__(self, compile_db=None):
+        self.compile_db = compile_db  # Optional CompilationDatabase (language, include paths)
         self.parsers = {}
         self.languages = {}
         self.queries = {}
@@ -42,6 +51,11 @@ class StructuralParser:
                       name: (type_identifier) @name
                     ) @class
                     
+                    (struct_specifier
+                      name: (type_identifier) @name
+                      body: (field_declaration_list)
+                    ) @class
+                    
                     (declaration) @var
                     (field_declaration) @var
                     """
@@ -56,6 +70,10 @@ class StructuralParser:
                       name: (identifier) @name
                     ) @class
                     
+                    (interface_declaration
+                      name: (identifier) @name
+                    ) @class
+                    
                     (declaration) @var
                     (field_declaration) @var
                     """
@@ -79,12 +97,26 @@ class StructuralParser:
             except Exception as e:
                 print(f"Warning: Failed to initialize Tree-sitter for {lang_id}: {e}")
 
-    def parse(self, code: str, file_path: Path) -> Dict[str, Any]:
-        """Unified entry point for parsing any supported file."""
-        ext = file_path.suffix.lower()
-        if ext == '.py':
+    def parse(self, code: str, file_path: Path, tree=None) -> Dict[str, Any]:
+        """
+        Unified entry point for parsing any supported file.
+        `tree` is an existing Tree-sitter tree for `code` (kept current by
+        incremental edits) to extract from instead of parsing again.
+        """
+        if file_path.suffix.lower() == '.py':
             return self._parse_python_ast(code, file_path)
         
+        lang_id = self.language_for(file_path)
+        if lang_id and lang_id in self.parsers:
+            results = self._parse_with_treesitter(code, lang_id, tree)
+            if self.compile_db and lang_id in ('c', 'cpp'):
+                self._resolve_includes(results, file_path)
+            return results
+        
+        return {"functions": [], "classes": [], "imports": [], "calls": []}
+
+    def language_for(self, file_path: Path) -> Optional[str]:
+        """Tree-sitter language id used for a non-Python file, or None if unsupported."""
         lang_map = {
             '.c': 'c',
             '.cpp': 'cpp',
@@ -94,11 +126,27 @@ class StructuralParser:
             '.java': 'java'
         }
         
-        lang_id = lang_map.get(ext)
-        if lang_id and lang_id in self.parsers:
-            return self._parse_with_treesitter(code, lang_id)
-        
-        return {"functions": [], "classes": [], "imports": [], "calls": []}
+        lang_id = lang_map.get(file_path.suffix.lower())
+        if self.compile_db and lang_id in ('c', 'cpp'):
+            # The build knows whether a .h is compiled as C or C++
+            lang_id = self.compile_db.language_for(file_path) or lang_id
+        return lang_id
+
+    def _resolve_includes(self, results: Dict[str, Any], file_path: Path):
+        """Attach the on-disk header path to each #include using the build's search paths."""
+        defines = self.compile_db.defines_for(file_path)
+        for imp in results.get("imports", []):
+            match = INCLUDE_RE.match(imp.get("module") or "")
+            if not match:
+                continue
+            delim, spec, macro = match.groups()
+            if macro:
+                spec, delim = self.compile_db.expand_include_macro(macro, defines)
+                if not spec:
+                    continue
+            resolved = self.compile_db.resolve_include(spec, file_path, angled=(delim == "<"))
+            if resolved:
+                imp["resolved"] = str(resolved)
 
     def _parse_python_ast(self, code: str, file_path: Path) -> Dict[str, Any]:
         """Parse Python code using native AST module."""
@@ -112,6 +160,7 @@ class StructuralParser:
         class Analyzer(ast.NodeVisitor):
             def __init__(self, source_code):
                 self.source_code = source_code
+                self.source_lines = source_code.encode('utf-8').splitlines(keepends=True)  # ast offsets are UTF-8 bytes
                 self.current_function = None
                 self.current_class = None
                 self.functions = []
@@ -119,6 +168,8 @@ class StructuralParser:
                 self.imports = []
                 self.calls_in_current = []
                 self.calls_detailed_in_current = []
+                self.loop_depth = 0  # enclosing loops/comprehensions within the current function
+                self.current_class_data = None
                 self.variables = []
                 self.identifiers = []
 
@@ -172,6 +223,7 @@ class StructuralParser:
                     "methods": [],
                     "attributes": [],
                     "bases": bases,
+                    "fields": {},
                     "body_code": body_code
                 }
                 
@@ -180,18 +232,32 @@ class StructuralParser:
                         for target in item.targets:
                             if isinstance(target, ast.Name):
                                 class_data["attributes"].append(target.id)
+                    elif isinstance(item, ast.AnnAssign) and isinstance(item.target, ast.Name):
+                        # Declared attribute types (dataclasses, typed class bodies)
+                        attr_type = StructuralParser._py_annotation_type(item.annotation)
+                        if attr_type:
+                            class_data["fields"][item.target.id] = attr_type
                 
                 self.classes.append(class_data)
+                prev_class_data = self.current_class_data
+                self.current_class_data = class_data
                 self.generic_visit(node)
                 self.current_class = prev_class
+                self.current_class_data = prev_class_data
 
             def visit_FunctionDef(self, node):
                 prev_func = self.current_function
                 prev_calls = self.calls_in_current
+                prev_detailed = self.calls_detailed_in_current
+                prev_depth = self.loop_depth
                 
                 self.current_function = node.name
                 self.calls_in_current = []
                 self.calls_detailed_in_current = []
+                self.loop_depth = 0
+                local_types = StructuralParser._py_local_types(node)
+                if node.name == "__init__" and self.current_class_data is not None:
+                    self.current_class_data["fields"].update(StructuralParser._py_self_attributes(node, local_types))
                 
                 args = [arg.arg for arg in node.args.args]
                 signature = f"{node.name}({', '.join(args)})"
@@ -216,6 +282,12 @@ class StructuralParser:
 
                 self.generic_visit(node)
                 
+                # Flow-insensitive: a local's inferred type applies to every call through it
+                for call in self.calls_detailed_in_current:
+                    root = (call["receiver"] or "").split(".")[0]
+                    if root in local_types and call["receiver"] not in ("self", "super"):
+                        call["receiver_type"] = local_types[root]
+                
                 func_data = {
                     "name": node.name,
                     "line": node.lineno,
@@ -224,7 +296,8 @@ class StructuralParser:
                     "calls": [c["name"] for c in self.calls_detailed_in_current],
                     "calls_detailed": self.calls_detailed_in_current,
                     "parent_class": self.current_class,
-                    "decorators": decorators
+                    "decorators": decorators,
+                    "returns": StructuralParser._py_annotation_type(node.returns)
                 }
                 self.functions.append(func_data)
                 
@@ -236,12 +309,52 @@ class StructuralParser:
                 
                 self.current_function = prev_func
                 self.calls_in_current = prev_calls
+                self.calls_detailed_in_current = prev_detailed
+                self.loop_depth = prev_depth
 
             visit_AsyncFunctionDef = visit_FunctionDef
 
+            def visit_For(self, node):
+                # The iterable is evaluated once; target and body run per iteration
+                self.visit(node.iter)
+                self.loop_depth += 1
+                for child in [node.target] + node.body:
+                    self.visit(child)
+                self.loop_depth -= 1
+                for child in node.orelse:
+                    self.visit(child)
+
+            visit_AsyncFor = visit_For
+
+            def visit_While(self, node):
+                self.loop_depth += 1
+                self.visit(node.test)
+                for child in node.body:
+                    self.visit(child)
+                self.loop_depth -= 1
+                for child in node.orelse:
+                    self.visit(child)
+
+            def visit_ListComp(self, node):
+                first = node.generators[0]
+                self.visit(first.iter)
+                self.loop_depth += 1
+                for gen in node.generators:
+                    if gen is not first:
+                        self.visit(gen.iter)
+                    self.visit(gen.target)
+                    for cond in gen.ifs:
+                        self.visit(cond)
+                for field in ("elt", "key", "value"):
+                    if getattr(node, field, None) is not None:
+                        self.visit(getattr(node, field))
+                self.loop_depth -= 1
+
+            visit_SetComp = visit_GeneratorExp = visit_DictComp = visit_ListComp
+
             def visit_Call(self, node):
                 call_name = None
-                receiver = None  # "self", "super", a class name, or None (bare call)
+                receiver = None  # "self", "super", dotted receiver text ("Cls", "self.repo", "make()"), or None (bare call)
                 
                 if isinstance(node.func, ast.Name):
                     call_name = node.func.id
@@ -257,15 +370,20 @@ class StructuralParser:
                             receiver = "super"
                         else:
                             receiver = val.id  # ClassName.method()
-                    elif isinstance(val, ast.Call):
+                    elif isinstance(val, ast.Call) and isinstance(val.func, ast.Name) and val.func.id == "super":
                         # super().__init__() — val is Call to super
-                        if isinstance(val.func, ast.Name) and val.func.id == "super":
-                            receiver = "super"
+                        receiver = "super"
+                    else:
+                        receiver = StructuralParser._py_receiver_text(val)
                 
                 if call_name:
                     self.calls_detailed_in_current.append({
                         "name": call_name,
-                        "receiver": receiver
+                        "receiver": receiver,
+                        "receiver_type": None,
+                        "line": node.lineno,
+                        "loop_depth": self.loop_depth,
+                        "args": StructuralParser._py_call_args(node, self.source_lines)
                     })
                     all_calls.append(call_name)
                 
@@ -283,7 +401,145 @@ class StructuralParser:
             "variables": analyzer.variables
         }
 
-    def _parse_with_treesitter(self, code: str, lang_id: str) -> Dict[str, Any]:
+    # ── Python: flow-insensitive receiver type inference ──
+    # Types are class names, or "<callee>()" for a call result that the
+    # ClassHierarchy resolves later (constructor or return annotation).
+
+    WRAPPER_ANNOTATIONS = {'Optional', 'Annotated', 'Final', 'ClassVar', 'Union'}
+
+    @classmethod
+    def _py_annotation_type(cls, ann) -> Optional[str]:
+        """`Foo`, `mod.Foo`, `"Foo"`, `Optional[Foo]`, `Foo | None` -> "Foo"; containers -> None."""
+        if ann is None:
+            return None
+        if isinstance(ann, ast.Name):
+            return None if ann.id == 'None' else ann.id
+        if isinstance(ann, ast.Attribute):
+            return ann.attr
+        if isinstance(ann, ast.Constant) and isinstance(ann.value, str):
+            try:
+                return cls._py_annotation_type(ast.parse(ann.value, mode='eval').body)
+            except SyntaxError:
+                return None
+        if isinstance(ann, ast.Subscript) and cls._py_annotation_type(ann.value) in cls.WRAPPER_ANNOTATIONS:
+            inner = ann.slice.elts if isinstance(ann.slice, ast.Tuple) else [ann.slice]
+            for item in inner:
+                found = cls._py_annotation_type(item)
+                if found:
+                    return found
+            return None
+        if isinstance(ann, ast.BinOp) and isinstance(ann.op, ast.BitOr):
+            return cls._py_annotation_type(ann.left) or cls._py_annotation_type(ann.right)
+        return None
+
+    @classmethod
+    def _py_receiver_text(cls, node) -> str:
+        """Dotted receiver text with call arguments and subscripts dropped: `self.repo.get(x)` -> "self.repo.get()"."""
+        if isinstance(node, ast.Name):
+            return node.id
+        if isinstance(node, ast.Attribute):
+            return f"{cls._py_receiver_text(node.value)}.{node.attr}"
+        if isinstance(node, ast.Call):
+            return f"{cls._py_receiver_text(node.func)}()"
+        if isinstance(node, ast.Subscript):
+            return f"{cls._py_receiver_text(node.value)}[]"
+        return "<expr>"
+
+    ARG_TEXT_LIMIT = 80
+    INIT_TEXT_LIMIT = 200
+
+    @classmethod
+    def _py_call_args(cls, call, lines: List[bytes]) -> List[str]:
+        """Argument source texts (`kw=value` for keywords), each cut to ARG_TEXT_LIMIT chars."""
+        texts = []
+        for arg in call.args:
+            texts.append(cls._py_arg_text(arg, lines))
+        for kw in call.keywords:
+            value = cls._py_arg_text(kw.value, lines)
+            texts.append(f"{kw.arg}={value}" if kw.arg else f"**{value}")
+        return [t[:cls.ARG_TEXT_LIMIT] for t in texts]
+
+    @classmethod
+    def _py_arg_text(cls, node, lines: List[bytes]) -> str:
+        """
+        Names and literals are rendered directly; anything else is sliced from
+        the source, reading no further than ARG_TEXT_LIMIT characters. A cut
+        string literal keeps no closing quote, so it never parses as a literal.
+        """
+        if isinstance(node, ast.Name):
+            return node.id
+        if isinstance(node, ast.Constant):
+            value = node.value
+            if isinstance(value, (str, bytes)):
+                return repr(value[:cls.ARG_TEXT_LIMIT + 1])[:cls.ARG_TEXT_LIMIT]
+            return ast.unparse(node)
+        row, end_row = node.lineno - 1, node.end_lineno - 1
+        if row == end_row:
+            raw = lines[row][node.col_offset:node.end_col_offset]
+        else:
+            raw = lines[row][node.col_offset:]
+            budget = cls.ARG_TEXT_LIMIT * 4  # UTF-8 bytes per character, at most
+            while len(raw) < budget and row < end_row:
+                row += 1
+                raw += lines[row][:node.end_col_offset] if row == end_row else lines[row]
+        text = raw[:cls.ARG_TEXT_LIMIT * 4].decode('utf-8', errors='ignore')
+        return re.sub(r"\s*\n\s*", " ", text.strip())
+
+    @classmethod
+    def _py_expr_type(cls, value, local_types: Dict[str, str]) -> Optional[str]:
+        if isinstance(value, ast.Call):
+            callee = cls._py_receiver_text(value.func)
+            if "<expr>" in callee or "[]" in callee:
+                return None
+            # self.make() stays qualified; module.Factory() -> Factory()
+            return f"{callee}()" if callee.startswith("self.") else f"{callee.split('.')[-1]}()"
+        if isinstance(value, ast.Name):
+            return local_types.get(value.id)
+        return None
+
+    @classmethod
+    def _py_local_types(cls, func) -> Dict[str, str]:
+        """Parameter annotations, annotated locals, `x = Foo(...)` and `with Foo() as x`."""
+        types: Dict[str, Optional[str]] = {}
+
+        def record(name, type_name):
+            if not type_name or name == "self":
+                return
+            if types.get(name, type_name) != type_name:
+                types[name] = None  # conflicting assignments: give up on this name
+            elif name not in types:
+                types[name] = type_name
+
+        args = func.args
+        for arg in args.posonlyargs + args.args + args.kwonlyargs:
+            record(arg.arg, cls._py_annotation_type(arg.annotation))
+        for node in ast.walk(func):
+            if isinstance(node, ast.AnnAssign) and isinstance(node.target, ast.Name):
+                record(node.target.id, cls._py_annotation_type(node.annotation))
+            elif isinstance(node, ast.Assign) and len(node.targets) == 1 and isinstance(node.targets[0], ast.Name):
+                record(node.targets[0].id, cls._py_expr_type(node.value, types))
+            elif isinstance(node, (ast.With, ast.AsyncWith)):
+                for item in node.items:
+                    if isinstance(item.optional_vars, ast.Name):
+                        record(item.optional_vars.id, cls._py_expr_type(item.context_expr, types))
+        return {name: t for name, t in types.items() if t}
+
+    @classmethod
+    def _py_self_attributes(cls, init, local_types: Dict[str, str]) -> Dict[str, str]:
+        """`self.attr = Foo(...)`, `self.attr = typed_param`, `self.attr: Foo = ...` inside __init__."""
+        fields = {}
+        for node in ast.walk(init):
+            target, attr_type = None, None
+            if isinstance(node, ast.Assign) and len(node.targets) == 1:
+                target, attr_type = node.targets[0], cls._py_expr_type(node.value, local_types)
+            elif isinstance(node, ast.AnnAssign):
+                target, attr_type = node.target, cls._py_annotation_type(node.annotation)
+            if (isinstance(target, ast.Attribute) and isinstance(target.value, ast.Name)
+                    and target.value.id == "self" and attr_type):
+                fields[target.attr] = attr_type
+        return fields
+
+    def _parse_with_treesitter(self, code: str, lang_id: str, tree=None) -> Dict[str, Any]:
         """Extract functions and classes using Tree-sitter queries."""
         parser = self.parsers[lang_id]
         query = self.queries.get(lang_id)
@@ -296,7 +552,8 @@ class StructuralParser:
             return None
 
         try:
-            tree = parser.parse(bytes(code, "utf8"))
+            if tree is None:
+                tree = parser.parse(bytes(code, "utf8"))
             root = tree.root_node
         except Exception as e:
             print(f"Error parsing with Tree-sitter ({lang_id}): {e}")
@@ -315,19 +572,17 @@ class StructuralParser:
             return results
 
         captures = query.captures(root)
-        
-        # We need to track which node belongs to which class
-        # (Simplified: functions/methods following a class but before next class)
-        current_class = None
+        namespaces = self._ts_namespaces(root)
 
         for node, tag in captures:
             if tag == 'class':
-                current_class = node.child_by_field_name('name').text.decode('utf8')
                 results["classes"].append({
-                    "name": current_class,
+                    "name": node.child_by_field_name('name').text.decode('utf8'),
                     "line": node.start_point[0] + 1,
                     "methods": [],
                     "attributes": [],
+                    "bases": self._ts_bases(node),
+                    "fields": self._ts_fields(node),
                     "body_code": code[node.start_byte:node.end_byte]
                 })
             
@@ -378,17 +633,21 @@ class StructuralParser:
                 params_str = sig_parts[0] if sig_parts else '()'
                 signature = f"{return_type + ' ' if return_type else ''}{name}{params_str}"
                 
+                parent_class = self._ts_owner_class(node, namespaces)
                 results["functions"].append({
                     "name": name,
                     "line": node.start_point[0] + 1,
                     "signature": signature,
                     "body_code": code[node.start_byte:node.end_byte],
                     "calls": [],
-                    "parent_class": current_class
+                    "calls_detailed": [],
+                    "parent_class": parent_class,
+                    "namespace": self._ts_namespace_of(node, namespaces)
                 })
                 
-                if current_class:
-                    results["classes"][-1]["methods"].append(name)
+                owner = next((c for c in reversed(results["classes"]) if c["name"] == parent_class), None)
+                if owner:
+                    owner["methods"].append(name)
 
         # ── Tree-sitter: Extract imports, globals, and call sites ──
         
@@ -427,25 +686,30 @@ class StructuralParser:
                 results["global_vars"].append(child.text.decode('utf8').strip())
         
         # 2. Extract call sites from each function body
-        def extract_calls(node):
-            """Recursively find call_expression nodes."""
+        def extract_calls(node, local_types, loop_depth=0):
+            """Recursively find call sites, keeping the receiver, its static type and loop nesting."""
             calls = []
+            detail = None
             if node.type == 'call_expression':
                 func_node = node.child_by_field_name('function')
                 if func_node:
-                    call_name = func_node.text.decode('utf8')
-                    # Simplify: take last part of dotted names (e.g. System.out.println -> println)
-                    if '.' in call_name:
-                        call_name = call_name.split('.')[-1]
-                    if '::' in call_name:
-                        call_name = call_name.split('::')[-1]
-                    calls.append(call_name)
+                    detail = self._ts_cpp_call(func_node)
             elif node.type == 'method_invocation': # Java specific
-                name_node = node.child_by_field_name('name')
-                if name_node:
-                    calls.append(name_node.text.decode('utf8'))
+                detail = self._ts_java_call(node)
+            elif node.type == 'binary_expression':
+                detail = self._ts_stream_flush(node)
+            if detail and detail["name"]:
+                root = (detail["receiver"] or "").split('.')[0]
+                if root in local_types and not detail.get("receiver_type"):
+                    detail["receiver_type"] = local_types[root]
+                detail["line"] = node.start_point[0] + 1
+                detail["loop_depth"] = loop_depth
+                detail.setdefault("args", self._ts_call_args(node))
+                calls.append(detail)
+            if node.type in self.TS_LOOP_TYPES:
+                loop_depth += 1
             for child in node.children:
-                calls.extend(extract_calls(child))
+                calls.extend(extract_calls(child, local_types, loop_depth))
             return calls
         
         for func in results["functions"]:
@@ -453,7 +717,11 @@ class StructuralParser:
             func_line = func["line"] - 1  # 0-indexed
             for node, tag in captures:
                 if tag == 'func' and node.start_point[0] == func_line:
-                    func["calls"] = extract_calls(node)
+                    detailed = extract_calls(node, self._ts_local_types(node))
+                    func["calls"] = [c["name"] for c in detailed]
+                    func["calls_detailed"] = detailed
+                    func["variables"] = self._ts_variables(node)
+                    func["iterated"] = self._ts_iterated(node)
                     break
 
         if usage_query:
@@ -466,3 +734,296 @@ class StructuralParser:
                     except: pass
 
         return results
+
+    # ── Tree-sitter: class hierarchy and receiver types (C++ / Java) ──
+
+    @classmethod
+    def _type_name(cls, text: str) -> Optional[str]:
+        """Class name behind a declared type: `const ns::Foo<T>&` -> Foo, `unique_ptr<Foo>` -> Foo."""
+        text = re.sub(r'\b(const|volatile|struct|class|typename|final|static)\b', ' ', text)
+        match = re.match(r'\s*([\w:.]+)\s*(?:<(.*)>)?', text)
+        if not match:
+            return None
+        outer = re.split(r'::|\.', match.group(1))[-1]
+        if outer in cls.SMART_POINTERS and match.group(2):
+            return cls._type_name(match.group(2).split(',')[0])
+        return outer or None
+
+    def _ts_bases(self, class_node) -> List[str]:
+        """Base classes and implemented/extended interfaces of a class node."""
+        bases = []
+        for child in class_node.children:
+            if child.type not in ('base_class_clause', 'superclass', 'super_interfaces', 'extends_interfaces'):
+                continue
+            for type_node in child.named_children:
+                items = type_node.named_children if type_node.type == 'type_list' else [type_node]
+                for item in items:
+                    if item.type in self.TS_TYPE_NODES:
+                        name = self._type_name(item.text.decode('utf8'))
+                        if name and name not in bases:
+                            bases.append(name)
+        return bases
+
+    def _ts_fields(self, class_node) -> Dict[str, str]:
+        """Data members with a class-like type: field name -> type name."""
+        body = class_node.child_by_field_name('body')
+        fields = {}
+        for decl in (body.named_children if body is not None else []):
+            if decl.type != 'field_declaration':
+                continue
+            type_node = decl.child_by_field_name('type')
+            if type_node is None:
+                continue
+            for declarator in self._ts_field_children(decl, 'declarator'):
+                if self._ts_has_function_declarator(declarator):
+                    continue  # member function declaration
+                name = self._ts_declarator_name(declarator)
+                type_name = self._type_name(type_node.text.decode('utf8'))
+                if name and type_name:
+                    fields[name] = type_name
+        return fields
+
+    def _ts_local_types(self, func_node) -> Dict[str, str]:
+        """Parameters and locals with a class-like static type (flow-insensitive)."""
+        types = {}
+        stack = [func_node]
+        while stack:
+            node = stack.pop()
+            if node.type in ('parameter_declaration', 'optional_parameter_declaration', 'declaration',
+                             'formal_parameter', 'local_variable_declaration', 'enhanced_for_statement',
+                             'for_range_loop'):
+                type_node = node.child_by_field_name('type')
+                declarators = self._ts_field_children(node, 'declarator') or self._ts_field_children(node, 'name')
+                for declarator in declarators:
+                    name = self._ts_declarator_name(declarator)
+                    type_text = type_node.text.decode('utf8') if type_node is not None else ""
+                    if type_text in ('auto', 'var'):
+                        # auto p = new Foo(...) / var p = new Foo(...)
+                        value = declarator.child_by_field_name('value')
+                        created = value.child_by_field_name('type') if value is not None and value.type in (
+                            'new_expression', 'object_creation_expression') else None
+                        type_text = created.text.decode('utf8') if created is not None else ""
+                    type_name = self._type_name(type_text) if type_text else None
+                    if name and type_name:
+                        types[name] = type_name
+            stack.extend(node.named_children)
+        return types
+
+    def _ts_variables(self, func_node) -> Dict[str, Dict[str, Any]]:
+        """Parameters and locals with their full declared type (templates kept) and initializer text."""
+        variables = {}
+        stack = [func_node]
+        while stack:
+            node = stack.pop()
+            if node.type in ('parameter_declaration', 'optional_parameter_declaration', 'declaration',
+                             'formal_parameter', 'local_variable_declaration'):
+                type_node = node.child_by_field_name('type')
+                type_text = type_node.text.decode('utf8') if type_node is not None else ""
+                for declarator in self._ts_field_children(node, 'declarator') or self._ts_field_children(node, 'name'):
+                    name = self._ts_declarator_name(declarator)
+                    value = declarator.child_by_field_name('value')
+                    if name and type_text and name not in variables:
+                        variables[name] = {
+                            "type": type_text,
+                            "init": value.text.decode('utf8')[:self.INIT_TEXT_LIMIT] if value is not None else "",
+                            "line": node.start_point[0] + 1,
+                            "parameter": 'parameter' in node.type,
+                        }
+            stack.extend(node.named_children)
+        return variables
+
+    def _ts_iterated(self, func_node) -> List[str]:
+        """Range expressions of range-for / for-each loops (`for (x : items)` -> "items")."""
+        found = []
+        stack = [func_node]
+        while stack:
+            node = stack.pop()
+            if node.type in ('for_range_loop', 'enhanced_for_statement'):
+                source = node.child_by_field_name('right') or node.child_by_field_name('value')
+                if source is not None:
+                    found.append(source.text.decode('utf8').replace('->', '.'))
+            stack.extend(node.named_children)
+        return found
+
+    # Range-for / for-each headers count as inside the loop; close enough for nesting depth
+    TS_LOOP_TYPES = ('for_statement', 'while_statement', 'do_statement', 'for_range_loop',
+                     'enhanced_for_statement')
+
+    def _ts_call_args(self, call_node) -> List[str]:
+        args = call_node.child_by_field_name('arguments')
+        if args is None:
+            return []
+        return [child.text.decode('utf8')[:self.ARG_TEXT_LIMIT] for child in args.named_children
+                if child.type != 'comment']
+
+    STREAM_FLUSHES = ('endl', 'std::endl', 'flush', 'std::flush')
+
+    def _ts_stream_flush(self, node) -> Optional[Dict[str, Any]]:
+        """`out << ... << std::endl` as a call to operator<< on `out` (the flush is the costly part)."""
+        right = node.child_by_field_name('right')
+        operator = node.child_by_field_name('operator')
+        if right is None or operator is None or operator.text != b'<<' or \
+                right.text.decode('utf8') not in self.STREAM_FLUSHES:
+            return None
+        stream = node.child_by_field_name('left')
+        while stream is not None and stream.type == 'binary_expression':
+            stream = stream.child_by_field_name('left')
+        return {"name": "operator<<", "receiver": self._ts_receiver(stream), "receiver_type": None,
+                "args": [right.text.decode('utf8')]}
+
+    def _ts_cpp_call(self, func_node) -> Dict[str, Any]:
+        """call_expression callee -> {name, receiver, receiver_type}; `this` is reported as "self"."""
+        detail = {"name": None, "receiver": None, "receiver_type": None}
+        if func_node.type == 'field_expression':
+            field = func_node.child_by_field_name('field')
+            detail["name"] = self._ts_last_name(field) if field is not None else None
+            detail["receiver"] = self._ts_receiver(func_node.child_by_field_name('argument'))
+        elif func_node.type == 'qualified_identifier':
+            # A::b() / ns::A::b(): the innermost scope is the class (or a namespace)
+            scope, name_node = None, func_node
+            while name_node is not None and name_node.type == 'qualified_identifier':
+                scope = name_node.child_by_field_name('scope') or scope
+                name_node = name_node.child_by_field_name('name')
+            detail["name"] = self._ts_last_name(name_node) if name_node is not None else None
+            if scope is not None:
+                detail["receiver"] = self._type_name(scope.text.decode('utf8'))
+                detail["scoped"] = True  # `::` scope: a class or a namespace, never an object
+        else:
+            detail["name"] = self._ts_last_name(func_node)
+        return detail
+
+    def _ts_java_call(self, node) -> Dict[str, Any]:
+        name_node = node.child_by_field_name('name')
+        obj = node.child_by_field_name('object')
+        detail = {"name": name_node.text.decode('utf8') if name_node is not None else None,
+                  "receiver": None, "receiver_type": None}
+        if obj is not None:
+            if obj.type == 'object_creation_expression' and obj.child_by_field_name('type') is not None:
+                # new Foo().bar()
+                detail["receiver_type"] = self._type_name(obj.child_by_field_name('type').text.decode('utf8'))
+            detail["receiver"] = self._ts_receiver(obj)
+        return detail
+
+    def _ts_receiver(self, node) -> Optional[str]:
+        """Receiver expression as text, with `this`/`this->x`/`this.x` normalised to "self"/"self.x"."""
+        if node is None:
+            return None
+        if node.type == 'this':
+            return "self"
+        if node.type == 'super':
+            return "super"
+        if node.type in ('field_expression', 'field_access'):
+            inner = node.child_by_field_name('argument') or node.child_by_field_name('object')
+            field = node.child_by_field_name('field')
+            if inner is not None and inner.type == 'this' and field is not None:
+                return f"self.{field.text.decode('utf8')}"
+        if node.type == 'pointer_expression':
+            # (*p).foo()
+            arg = node.child_by_field_name('argument')
+            if arg is not None:
+                return self._ts_receiver(arg)
+        return node.text.decode('utf8').replace('->', '.')
+
+    def _ts_owner_class(self, func_node, namespaces: set) -> Optional[str]:
+        """
+        Class a function belongs to: the enclosing class body, or the scope of `A::f` definitions.
+        A scope that is not a namespace of this file may still be one declared in a header;
+        ClassHierarchy only treats it as a class when a class of that name was parsed.
+        """
+        parent = func_node.parent
+        while parent is not None:
+            if parent.type in self.TS_CLASS_NODES:
+                name = parent.child_by_field_name('name')
+                return name.text.decode('utf8') if name is not None else None
+            parent = parent.parent
+        declarator = func_node.child_by_field_name('declarator')
+        while declarator is not None and declarator.type in ('function_declarator', 'pointer_declarator',
+                                                             'reference_declarator'):
+            declarator = declarator.child_by_field_name('declarator') or (
+                declarator.named_children[-1] if declarator.named_children else None)
+        if declarator is not None and declarator.type == 'qualified_identifier':
+            scope = declarator.child_by_field_name('scope')
+            inner = declarator.child_by_field_name('name')
+            while inner is not None and inner.type == 'qualified_identifier':
+                scope = inner.child_by_field_name('scope') or scope
+                inner = inner.child_by_field_name('name')
+            owner = self._type_name(scope.text.decode('utf8')) if scope is not None else None
+            if owner and owner not in namespaces:
+                return owner
+        return None
+
+    def _ts_namespace_of(self, func_node, namespaces: set) -> Optional[str]:
+        """Innermost namespace of a function: the enclosing `namespace x {}` or the scope of `x::f() {}`."""
+        declarator = func_node.child_by_field_name('declarator')
+        while declarator is not None and declarator.type in ('function_declarator', 'pointer_declarator',
+                                                             'reference_declarator'):
+            declarator = declarator.child_by_field_name('declarator') or (
+                declarator.named_children[-1] if declarator.named_children else None)
+        if declarator is not None and declarator.type == 'qualified_identifier':
+            scope, inner = declarator.child_by_field_name('scope'), declarator.child_by_field_name('name')
+            while inner is not None and inner.type == 'qualified_identifier':
+                scope = inner.child_by_field_name('scope') or scope
+                inner = inner.child_by_field_name('name')
+            owner = self._type_name(scope.text.decode('utf8')) if scope is not None else None
+            if owner in namespaces:
+                return owner
+        parent = func_node.parent
+        while parent is not None:
+            if parent.type == 'namespace_definition':
+                name = parent.child_by_field_name('name')
+                return name.text.decode('utf8').split('::')[-1] if name is not None else None
+            parent = parent.parent
+        return None
+
+    @staticmethod
+    def _ts_namespaces(root) -> set:
+        names, stack = set(), [root]
+        while stack:
+            node = stack.pop()
+            if node.type == 'namespace_definition':
+                name = node.child_by_field_name('name')
+                if name is not None:
+                    names.add(name.text.decode('utf8').split('::')[-1])
+                body = node.child_by_field_name('body')
+                if body is not None:
+                    stack.extend(body.named_children)
+            elif node is root:
+                stack.extend(node.named_children)
+        return names
+
+    @staticmethod
+    def _ts_field_children(node, field_name: str) -> list:
+        if hasattr(node, 'children_by_field_name'):
+            return list(node.children_by_field_name(field_name))
+        child = node.child_by_field_name(field_name)
+        return [child] if child is not None else []
+
+    def _ts_declarator_name(self, node) -> Optional[str]:
+        if node is None:
+            return None
+        if node.type in ('identifier', 'field_identifier'):
+            return node.text.decode('utf8')
+        inner = node.child_by_field_name('declarator') or node.child_by_field_name('name')
+        if inner is not None:
+            return self._ts_declarator_name(inner)
+        for child in node.named_children:  # reference_declarator has no field
+            if child.type in ('identifier', 'field_identifier', 'pointer_declarator', 'reference_declarator'):
+                return self._ts_declarator_name(child)
+        return None
+
+    @staticmethod
+    def _ts_has_function_declarator(node) -> bool:
+        while node is not None:
+            if node.type == 'function_declarator':
+                return True
+            node = node.child_by_field_name('declarator')
+        return False
+
+    @staticmethod
+    def _ts_last_name(node) -> Optional[str]:
+        """Plain callee name: template arguments and qualification dropped."""
+        if node.type in ('template_function', 'template_method'):
+            inner = node.child_by_field_name('name')
+            node = inner if inner is not None else node
+        text = node.text.decode('utf8')
+        return re.split(r'::|\.|->', text.split('<')[0])[-1].strip() or None
@@ -3,10 +3,13 @@ Call Graph Builder
 Constructs function call graph and file dependency graph using NetworkX.
 """
 
+import os
 from pathlib import Path
 from typing import Dict, List, Set, Tuple
 import networkx as nx
-from core.symbol_table import Symbol, SymbolTableBuilder
+from core.symbol_table import Symbol, SymbolTableBuilder, SymbolType
+from core.reachability import ReachabilityIndex
+from core.class_hierarchy import ClassHierarchy
 
 class CallGraphBuilder:
     """
@@ -18,6 +21,9 @@ class CallGraphBuilder:
         self.function_graph = nx.DiGraph()  # Function -> Function calls
         self.file_graph = nx.DiGraph()       # File -> File dependencies
         self.call_sites: Dict[str, List[str]] = {}  # function -> list of functions it calls
+        self.reachability = ReachabilityIndex(self.function_graph)
+        self.hierarchy = ClassHierarchy()
+        self.namespace_of: Dict[Tuple[str, str], str] = {}  # (file, free function) -> C++ namespace
     
     def build_call_graph(self, parsed_files: Dict[Path, dict]):
         """
@@ -26,6 +32,12 @@ class CallGraphBuilder:
         # Phase 1: Add all function nodes
         for qualified_name, symbol in self.symbol_table.symbols.items():
             self.function_graph.add_node(qualified_name, symbol=symbol)
+        self.reachability.invalidate()
+        self.hierarchy = ClassHierarchy.build(parsed_files, self.symbol_table)
+        self.namespace_of = {(str(path), func["name"]): func["namespace"]
+                             for path, data in parsed_files.items()
+                             for func in data.get("functions", [])
+                             if func.get("namespace") and not func.get("parent_class")}
         
         # Phase 2: Add call edges (Function -> Function)
         for file_path, data in parsed_files.items():
@@ -35,10 +47,12 @@ class CallGraphBuilder:
                 
                 if caller:
                     self.call_sites[caller] = calls
-                    for call_name in calls:
-                        callee = self._resolve_call(call_name, file_path)
-                        if callee and callee in self.symbol_table.symbols:
-                            self.function_graph.add_edge(caller, callee)
+                    detailed = func_data.get("calls_detailed") or [{"name": c} for c in calls]
+                    owner = func_data.get("parent_class")
+                    for call in detailed:
+                        for callee in self._resolve_call(call, file_path, owner):
+                            if callee in self.symbol_table.symbols:
+                                self.reachability.add_edge(caller, callee)
             
             # Phase 3: Add import edges (File -> File) directly from parser data
             caller_file = str(file_path)
@@ -46,6 +60,13 @@ class CallGraphBuilder:
                 self.file_graph.add_node(caller_file)
                 
             for imp in data.get("imports", []):
+                # Handle '#include' already resolved to a header on disk
+                if imp.get("resolved"):
+                    for other_path in parsed_files.keys():
+                        if os.path.abspath(other_path) == imp["resolved"]:
+                            self.file_graph.add_edge(caller_file, str(other_path))
+                    continue
+
                 # Handle 'from module import names'
                 if imp.get("module"):
                     module_name = imp["module"]
@@ -64,28 +85,44 @@ class CallGraphBuilder:
         # Phase 4: Build file dependency graph from function calls as well
         self._build_file_graph()
     
-    def _resolve_call(self, call_name: str, current_file: Path) -> str:
+    def _resolve_call(self, call: dict, current_file: Path, owner: str = None) -> List[str]:
         """
-        Resolve a function call to its qualified name.
-        Simple heuristic: check if exact match exists in symbol table.
+        Resolve a call to qualified names. Method calls go through class-hierarchy
+        analysis on the receiver's type; other calls match free functions by name.
         """
+        implicit_this = Path(current_file).suffix != ".py"
+        targets = self.hierarchy.resolve_method_call(call, owner, implicit_this)
+        if targets is not None:
+            return [t.qualified_name for t in targets]
+        
+        call_name = call["name"]
+        if call.get("scoped"):
+            # ns::foo(): only free functions declared in that namespace (std::sort finds none),
+            # including out-of-line `ns::foo() {}` definitions whose `ns` is not a parsed class
+            namespace = call.get("receiver")
+            return [c.qualified_name for c in self.symbol_table.find_symbols_by_name(call_name)
+                    if c.type == SymbolType.FUNCTION
+                    and (c.parent_name == namespace if c.parent_name
+                         else self.namespace_of.get((str(c.file), call_name)) == namespace)]
+
         # Try exact match first
         if call_name in self.symbol_table.symbols:
-            return call_name
+            return [call_name]
         
         # Try matching by name only (find in same file first)
-        candidates = self.symbol_table.find_symbols_by_name(call_name)
+        candidates = [c for c in self.symbol_table.find_symbols_by_name(call_name)
+                      if c.type == SymbolType.FUNCTION and not c.parent_name]
         
         # Prefer symbols in same file
         for candidate in candidates:
             if candidate.file == current_file:
-                return candidate.qualified_name
+                return [candidate.qualified_name]
         
         # Return first match if any
         if candidates:
-            return candidates[0].qualified_name
+            return [candidates[0].qualified_name]
         
-        return None
+        return []
     
     def _build_file_graph(self):
         """Build file dependency graph from function call graph."""
@@ -121,11 +158,7 @@ class CallGraphBuilder:
         """
         if entry_points:
             # Find all reachable functions from entry points
-            reachable = set()
-            for entry in entry_points:
-                if entry in self.function_graph:
-                    reachable.add(entry)
-                    reachable.update(nx.descendants(self.function_graph, entry))
+            reachable = self.reachability.reachable_from(entry_points)
             
             # Dead code = all functions - reachable
             all_functions = set(self.function_graph.nodes())
@@ -146,9 +179,4 @@ class CallGraphBuilder:
     
     def get_call_chain(self, from_func: str, to_func: str) -> List[str]:
         """Get shortest call chain between two functions."""
-        try:
-            if nx.has_path(self.function_graph, from_func, to_func):
-                return nx.shortest_path(self.function_graph, from_func, to_func)
-        except:
-            pass
-        return []
+        return self.reachability.shortest_path(from_func, to_func)
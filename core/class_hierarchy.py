@@ -0,0 +1,231 @@
+"""
+Class Hierarchy
+Class-hierarchy analysis (CHA) for resolving method calls to call-graph edges.
+
+Base-class lists from the parser give, for every class, its supertypes and
+a precomputed set of subtypes. A call through a receiver whose static type
+is T resolves to the implementation T inherits plus every override in T's
+subtypes, instead of to every method in the codebase with the same name.
+Receivers of unknown or external types resolve to nothing.
+
+Static types come from the parser: declared types for C++/Java, and a
+flow-insensitive local inference for Python (constructor assignments,
+annotations, `self.attr` assignments in `__init__`). A Python type may be a
+call marker "make()" / "self.make()", resolved here to the constructed
+class or the callee's return annotation.
+"""
+
+from typing import Any, Dict, List, Mapping, Optional, Set
+
+from core.symbol_table import Symbol, SymbolTableBuilder, SymbolType
+
+
+class ClassHierarchy:
+    """Supertypes, subtypes, methods and field types per class name."""
+
+    def __init__(self):
+        self.bases: Dict[str, List[str]] = {}
+        self.fields: Dict[str, Dict[str, str]] = {}        # class -> field name -> type name
+        self.methods: Dict[str, Dict[str, Symbol]] = {}    # class -> method name -> Symbol
+        self.returns: Dict[tuple, str] = {}                # (class or "", function) -> return type
+        self._subtypes: Optional[Dict[str, Set[str]]] = None
+        self._supertypes: Dict[str, List[str]] = {}
+
+    @classmethod
+    def build(cls, file_data: Mapping[str, Any], symbol_table: SymbolTableBuilder) -> "ClassHierarchy":
+        """From parser output (classes with "bases"/"fields") and the function symbols."""
+        hierarchy = cls()
+        for data in file_data.values():
+            for class_info in data.get("classes", []):
+                hierarchy.add_class(class_info["name"], class_info.get("bases", []), class_info.get("fields"))
+            for func in data.get("functions", []):
+                if func.get("returns"):
+                    hierarchy.returns.setdefault((func.get("parent_class") or "", func["name"]), func["returns"])
+        for sym in symbol_table.symbols.values():
+            # An out-of-line `x::f() {}` is a method only if a class x was parsed; otherwise x is a namespace
+            if sym.type == SymbolType.FUNCTION and sym.parent_name and hierarchy.has_class(sym.parent_name):
+                hierarchy.add_method(sym.parent_name, sym)
+        return hierarchy
+
+    def add_class(self, name: str, bases: List[str], fields: Optional[Dict[str, str]] = None):
+        # Forward declarations and header/source splits repeat a class: merge them
+        known = self.bases.setdefault(name, [])
+        known.extend(b for b in bases if b not in known and b != name)
+        if fields:
+            self.fields.setdefault(name, {}).update(fields)
+        self._subtypes = None
+        self._supertypes.clear()
+
+    def add_method(self, class_name: str, symbol: Symbol):
+        self.methods.setdefault(class_name, {})[symbol.name] = symbol
+        self.bases.setdefault(class_name, [])
+
+    def has_class(self, name: str) -> bool:
+        return name in self.bases
+
+    # ── Hierarchy ────────────────────────────────────────────────────
+
+    def supertypes(self, name: str) -> List[str]:
+        """All ancestors, nearest first (breadth-first over the base lists)."""
+        cached = self._supertypes.get(name)
+        if cached is not None:
+            return cached
+        order, seen, frontier = [], {name}, list(self.bases.get(name, []))
+        while frontier:
+            nxt = []
+            for base in frontier:
+                if base in seen:
+                    continue
+                seen.add(base)
+                order.append(base)
+                nxt.extend(self.bases.get(base, []))
+            frontier = nxt
+        self._supertypes[name] = order
+        return order
+
+    def subtypes(self, name: str) -> Set[str]:
+        """The class itself and every class deriving from it, directly or not."""
+        if self._subtypes is None:
+            self._compute_subtypes()
+        return self._subtypes.get(name, {name})
+
+    def _compute_subtypes(self):
+        children: Dict[str, List[str]] = {}
+        for cls, bases in self.bases.items():
+            for base in bases:
+                children.setdefault(base, []).append(cls)
+        subtypes = {}
+        for root in set(self.bases) | set(children):
+            seen, stack = {root}, [root]
+            while stack:
+                for child in children.get(stack.pop(), []):
+                    if child not in seen:
+                        seen.add(child)
+                        stack.append(child)
+            subtypes[root] = seen
+        self._subtypes = subtypes
+
+    # ── Method and field lookup ──────────────────────────────────────
+
+    def lookup(self, class_name: str, method: str) -> Optional[Symbol]:
+        """Implementation `class_name` has for `method`: its own, else the nearest inherited one."""
+        for cls in [class_name] + self.supertypes(class_name):
+            target = self.methods.get(cls, {}).get(method)
+            if target:
+                return target
+        return None
+
+    def dispatch_targets(self, static_type: str, method: str) -> List[Symbol]:
+        """CHA: the inherited implementation plus all overrides below `static_type`."""
+        targets = []
+        inherited = self.lookup(static_type, method)
+        if inherited:
+            targets.append(inherited)
+        for sub in sorted(self.subtypes(static_type)):
+            override = self.methods.get(sub, {}).get(method)
+            if override and override not in targets:
+                targets.append(override)
+        return targets
+
+    def super_targets(self, class_name: str, method: str) -> List[Symbol]:
+        for base in self.supertypes(class_name):
+            target = self.methods.get(base, {}).get(method)
+            if target:
+                return [target]
+        return []
+
+    def field_type(self, class_name: str, field: str) -> Optional[str]:
+        for cls in [class_name] + self.supertypes(class_name):
+            type_name = self.fields.get(cls, {}).get(field)
+            if type_name:
+                return type_name
+        return None
+
+    def method_returns(self, class_name: str, method: str) -> Optional[str]:
+        for cls in [class_name] + self.supertypes(class_name):
+            type_name = self.returns.get((cls, method))
+            if type_name:
+                return type_name
+        return None
+
+    # ── Type resolution ──────────────────────────────────────────────
+
+    def resolve_type(self, type_expr: Optional[str], context: Optional[str] = None, depth: int = 0) -> Optional[str]:
+        """Known class named by a type expression; `context` is the class "self" refers to."""
+        if not type_expr or depth > 8:
+            return None
+        if type_expr.endswith("()"):
+            callee = type_expr[:-2]
+            if callee.startswith("self."):
+                ret = self.method_returns(context, callee[5:]) if context else None
+                return self.resolve_type(ret, context, depth + 1)
+            if self.has_class(callee):
+                return callee  # constructor call
+            return self.resolve_type(self.returns.get(("", callee)), context, depth + 1)
+        return type_expr if self.has_class(type_expr) else None
+
+    def receiver_class(self, receiver: str, receiver_type: Optional[str], owner: Optional[str],
+                       implicit_this: bool = False) -> Optional[str]:
+        """
+        Static class of a dotted receiver ("s", "self.repo", "self.repo.get()", "make()").
+        `receiver_type` types its first component when the parser inferred it.
+        """
+        parts = receiver.split(".")
+        if receiver_type:
+            cls, rest = self.resolve_type(receiver_type, owner), parts[1:]
+        elif parts[0] == "self" and owner:
+            cls, rest = owner, parts[1:]
+        elif implicit_this and owner and self.field_type(owner, parts[0]):
+            cls, rest = owner, parts  # C++/Java member used without this
+        elif parts[0].endswith("()"):
+            cls, rest = self.resolve_type(parts[0], owner), parts[1:]
+        else:
+            return None
+        for attr in rest:
+            if cls is None:
+                return None
+            if attr.endswith("()"):
+                cls = self.resolve_type(self.method_returns(cls, attr[:-2]), cls)
+            else:
+                cls = self.resolve_type(self.field_type(cls, attr), cls)
+        return cls
+
+    # ── Call resolution ──────────────────────────────────────────────
+
+    def resolve_method_call(self, call: Dict[str, Any], owner: Optional[str],
+                            implicit_this: bool = False) -> Optional[List[Symbol]]:
+        """
+        Targets of one parsed call (`calls_detailed` entry) made from a method of
+        `owner`. Returns [] when the receiver cannot be typed to a known class and
+        None for a bare call that is not a method call, or a C++ `ns::f()` call
+        whose scope is not a known class (left to the caller to match against
+        free functions, in that namespace for scoped calls). `implicit_this`
+        enables C++/Java rules: bare calls and bare field receivers may refer to
+        members of `owner`.
+        """
+        name = call["name"]
+        receiver = call.get("receiver")
+
+        if receiver == "self":
+            return self.dispatch_targets(owner, name) if owner else []
+        if receiver == "super":
+            return self.super_targets(owner, name) if owner else []
+
+        static_type = None
+        if receiver is not None:
+            static_type = self.receiver_class(receiver, call.get("receiver_type"), owner, implicit_this)
+        if static_type:
+            return self.dispatch_targets(static_type, name)
+
+        if receiver is not None:
+            if self.has_class(receiver):
+                # ClassName.method() / A::method(): statically bound
+                target = self.lookup(receiver, name)
+                return [target] if target else []
+            if call.get("scoped"):
+                return None  # utils::parse(), std::sort(): a namespace, not an object
+            return []
+
+        if implicit_this and owner and self.lookup(owner, name):
+            return self.dispatch_targets(owner, name)
+        return None
@@ -0,0 +1,233 @@
+"""
+Compilation Database
+Reads compile_commands.json to scope C/C++ analysis to what is actually built.
+Provides per-file language, include paths and defines for the include resolver.
+"""
+
+import os
+import re
+import json
+import shlex
+from pathlib import Path
+from typing import Dict, List, Optional, Set
+
+C_FAMILY_EXTENSIONS = {'.c', '.cpp', '.cc', '.cxx', '.h', '.hpp', '.hh', '.hxx'}
+
+INCLUDE_RE = re.compile(r'^\s*#\s*include\s*(?:([<"])([^>"]+)[>"]|([A-Za-z_]\w*))', re.MULTILINE)
+
+
+class CompileEntry:
+    def __init__(self, file_path: Path, directory: Path, language: str,
+                 include_paths: List[Path], quote_paths: List[Path], defines: Dict[str, str]):
+        self.file = file_path
+        self.directory = directory
+        self.language = language          # "c" or "cpp"
+        self.include_paths = include_paths  # -I / -isystem, in search order
+        self.quote_paths = quote_paths      # -iquote (searched first for "..." includes)
+        self.defines = defines              # -D NAME[=VALUE]
+
+
+class CompilationDatabase:
+    """
+    Index over a compile_commands.json file.
+
+    - Translation units: files that appear as compile entries
+    - Reachable headers: project headers transitively #included by those units
+    - Language: taken from the compiler driver / -x / -std flags, headers inherit it
+    """
+
+    CANDIDATE_LOCATIONS = ["compile_commands.json", "build/compile_commands.json"]
+
+    def __init__(self, db_path: Path, project_root: Path = None):
+        self.db_path = Path(db_path)
+        self.project_root = self._norm(project_root or self.db_path.parent)
+        self.entries: Dict[str, CompileEntry] = {}   # normalized path -> entry
+        self.headers: Dict[str, List[CompileEntry]] = {}  # normalized header path -> including units
+        self._load()
+        self._collect_headers()
+
+    @classmethod
+    def discover(cls, folder: Path) -> Optional["CompilationDatabase"]:
+        """Look for compile_commands.json in the usual places under `folder`."""
+        for rel in cls.CANDIDATE_LOCATIONS:
+            candidate = Path(folder) / rel
+            if candidate.is_file():
+                return cls(candidate, project_root=folder)
+        return None
+
+    # ── Queries ──────────────────────────────────────────────────────
+
+    def covers(self, file_path: Path) -> bool:
+        """True if the file is a compiled unit or a header one of them reaches."""
+        key = self._norm(file_path)
+        return key in self.entries or key in self.headers
+
+    def language_for(self, file_path: Path) -> Optional[str]:
+        """Language the file is actually compiled as, or None if unknown."""
+        key = self._norm(file_path)
+        if key in self.entries:
+            return self.entries[key].language
+        units = self.headers.get(key)
+        if not units:
+            return None
+        # A header shared with a C unit must stay valid C
+        return "c" if all(u.language == "c" for u in units) else "cpp"
+
+    def defines_for(self, file_path: Path) -> Dict[str, str]:
+        key = self._norm(file_path)
+        if key in self.entries:
+            return self.entries[key].defines
+        merged = {}
+        for unit in self.headers.get(key, []):
+            merged.update(unit.defines)
+        return merged
+
+    def resolve_include(self, spec: str, from_file: Path, angled: bool = False) -> Optional[Path]:
+        """Resolve an #include spec (as written) using the including file's search paths."""
+        key = self._norm(from_file)
+        units = [self.entries[key]] if key in self.entries else self.headers.get(key, [])
+        return self._resolve(spec, Path(key), units, angled)
+
+    @property
+    def translation_units(self) -> List[Path]:
+        return [e.file for e in self.entries.values()]
+
+    # ── Loading ──────────────────────────────────────────────────────
+
+    def _load(self):
+        try:
+            with open(self.db_path, 'r', encoding='utf-8') as f:
+                raw = json.load(f)
+        except Exception as e:
+            print(f"Warning: Failed to read {self.db_path}: {e}")
+            return
+
+        for item in raw:
+            try:
+                entry = self._parse_entry(item)
+            except Exception as e:
+                print(f"Warning: Skipping compile entry for {item.get('file')}: {e}")
+                continue
+            self.entries[str(entry.file)] = entry
+
+    def _parse_entry(self, item: Dict) -> CompileEntry:
+        directory = Path(item.get("directory", "."))
+        if not directory.is_absolute():
+            directory = self.db_path.parent / directory
+        args = item.get("arguments") or shlex.split(item.get("command", ""))
+        file_path = Path(item["file"])
+        if not file_path.is_absolute():
+            file_path = directory / file_path
+
+        include_paths, quote_paths, defines = [], [], {}
+        forced_lang = None
+        std = ""
+
+        def as_dir(p: str) -> Path:
+            path = Path(p)
+            return Path(self._norm(path if path.is_absolute() else directory / path))
+
+        i = 1
+        while i < len(args):
+            arg = args[i]
+            nxt = args[i + 1] if i + 1 < len(args) else ""
+            for flag, target in (("-I", include_paths), ("-isystem", include_paths), ("-iquote", quote_paths)):
+                if arg == flag:
+                    target.append(as_dir(nxt))
+                    i += 1
+                    break
+                if arg.startswith(flag) and len(arg) > len(flag):
+                    target.append(as_dir(arg[len(flag):]))
+                    break
+            else:
+                if arg in ("-D", "-U", "-x"):
+                    value, i = nxt, i + 1
+                    arg = arg + value
+                if arg.startswith("-D"):
+                    name, _, val = arg[2:].partition("=")
+                    defines[name] = val or "1"
+                elif arg.startswith("-U"):
+                    defines.pop(arg[2:], None)
+                elif arg.startswith("-x"):
+                    forced_lang = arg[2:]
+                elif arg.startswith("-std="):
+                    std = arg[5:]
+            i += 1
+
+        compiler = os.path.basename(args[0]) if args else ""
+        if forced_lang:
+            language = "cpp" if "++" in forced_lang else "c"
+        elif "++" in std or "++" in compiler:
+            language = "cpp"
+        elif file_path.suffix.lower() == ".c":
+            language = "c"
+        else:
+            language = "cpp"
+
+        return CompileEntry(Path(self._norm(file_path)), directory, language,
+                            include_paths, quote_paths, defines)
+
+    def _collect_headers(self):
+        """Walk #include chains from every unit, staying inside the project root."""
+        for entry in self.entries.values():
+            seen: Set[str] = set()
+            stack = [entry.file]
+            while stack:
+                current = stack.pop()
+                try:
+                    source = current.read_text(encoding='utf-8', errors='replace')
+                except OSError:
+                    continue
+                for match in INCLUDE_RE.finditer(source):
+                    delim, spec, macro = match.groups()
+                    if macro:
+                        spec, delim = self.expand_include_macro(macro, entry.defines)
+                        if not spec:
+                            continue
+                    resolved = self._resolve(spec, current, [entry], delim == "<")
+                    if not resolved:
+                        continue
+                    key = str(resolved)
+                    if key in seen or key in self.entries:
+                        continue
+                    seen.add(key)
+                    self.headers.setdefault(key, []).append(entry)
+                    stack.append(resolved)
+
+    # ── Helpers ──────────────────────────────────────────────────────
+
+    def _resolve(self, spec: str, from_file: Path, units: List[CompileEntry], angled: bool) -> Optional[Path]:
+        search: List[Path] = []
+        if not angled:
+            search.append(from_file.parent)
+            for unit in units:
+                search.extend(unit.quote_paths)
+        for unit in units:
+            search.extend(unit.include_paths)
+
+        for base in search:
+            candidate = Path(self._norm(base / spec))
+            if not self._inside(candidate):
+                continue  # system / third-party headers outside the tree
+            if candidate.is_file():
+                return candidate
+        return None
+
+    @staticmethod
+    def expand_include_macro(name: str, defines: Dict[str, str]):
+        """`#include CONFIG_H` with -DCONFIG_H="cfg.h" or -DCONFIG_H=<cfg.h>."""
+        value = defines.get(name, "").strip()
+        if len(value) >= 2 and value[0] == '"' and value[-1] == '"':
+            return value[1:-1], '"'
+        if len(value) >= 2 and value[0] == '<' and value[-1] == '>':
+            return value[1:-1], '<'
+        return None, None
+
+    @staticmethod
+    def _norm(path) -> str:
+        return os.path.normpath(os.path.abspath(str(path)))
+
+    def _inside(self, path: Path) -> bool:
+        """Under the project root by path components (`/proj` does not contain `/project2`)."""
+        path = str(path)
+        return path == self.project_root or path.startswith(self.project_root.rstrip(os.sep) + os.sep)
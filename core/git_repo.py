@@ -0,0 +1,101 @@
+"""
+Git Repository Access
+Thin wrapper over git plumbing for history walks keyed by blob IDs.
+"""
+
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+
+class Commit:
+    def __init__(self, sha: str, timestamp: int, subject: str):
+        self.sha = sha
+        self.timestamp = timestamp
+        self.subject = subject
+
+
+class GitRepository:
+    """
+    Reads commits, trees and blobs without touching the working tree.
+    Blob contents are streamed through one long-lived `git cat-file --batch`.
+    """
+
+    def __init__(self, root: Path):
+        self.root = Path(root)
+        self._batch = None
+
+    def _git(self, *args: str) -> str:
+        result = subprocess.run(
+            ["git", "-C", str(self.root), *args],
+            capture_output=True, text=True, encoding='utf-8', errors='replace'
+        )
+        if result.returncode != 0:
+            raise RuntimeError(f"git {' '.join(args)} failed: {result.stderr.strip()}")
+        return result.stdout
+
+    def commits(self, count: int, rev: str = "HEAD") -> List[Commit]:
+        """Last `count` first-parent commits reachable from `rev`, oldest first."""
+        out = self._git("log", "--first-parent", f"-n{count}", "--format=%H%x09%ct%x09%s", rev)
+        commits = []
+        for line in out.splitlines():
+            sha, ts, subject = (line.split("\t", 2) + ["", ""])[:3]
+            commits.append(Commit(sha, int(ts or 0), subject))
+        commits.reverse()
+        return commits
+
+    def tree_blobs(self, commit: str) -> Dict[str, str]:
+        """Full file listing of a commit: path -> blob ID."""
+        out = self._git("ls-tree", "-r", "-z", "--full-tree", commit)
+        blobs = {}
+        for record in out.split("\0"):
+            if not record:
+                continue
+            meta, path = record.split("\t", 1)
+            _mode, obj_type, sha = meta.split()
+            if obj_type == "blob":
+                blobs[path] = sha
+        return blobs
+
+    def changed_blobs(self, old: str, new: str) -> List[Tuple[str, Optional[str]]]:
+        """
+        Paths that differ between two commits with their new blob ID
+        (None when the path was deleted). Renames are reported as delete + add.
+        """
+        out = self._git("diff-tree", "-r", "-z", "--no-renames", old, new)
+        fields = out.split("\0")
+        changes = []
+        i = 0
+        while i < len(fields) - 1:
+            meta = fields[i]
+            if not meta.startswith(":"):
+                i += 1
+                continue
+            path = fields[i + 1]
+            _old_mode, _new_mode, _old_sha, new_sha, status = meta[1:].split()
+            changes.append((path, None if status == "D" else new_sha))
+            i += 2
+        return changes
+
+    def read_blob(self, sha: str) -> str:
+        """Read one blob through the persistent cat-file process."""
+        if self._batch is None:
+            self._batch = subprocess.Popen(
+                ["git", "-C", str(self.root), "cat-file", "--batch"],
+                stdin=subprocess.PIPE, stdout=subprocess.PIPE
+            )
+        self._batch.stdin.write(f"{sha}\n".encode())
+        self._batch.stdin.flush()
+        header = self._batch.stdout.readline().decode().split()
+        if len(header) < 3 or header[1] == "missing":
+            raise RuntimeError(f"Blob {sha} not found")
+        size = int(header[2])
+        data = self._batch.stdout.read(size)
+        self._batch.stdout.read(1)  # trailing newline
+        return data.decode('utf-8', errors='replace')
+
+    def close(self):
+        if self._batch is not None:
+            self._batch.stdin.close()
+            self._batch.wait()
+            self._batch = None
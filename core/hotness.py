@@ -0,0 +1,82 @@
+"""
+Hotness Index
+Static estimate of how often each function runs, used to rank findings.
+
+Call-graph edges carry the loop nesting of their deepest call site (set by
+the structural phase). A function's estimated call count is the sum over its
+callers of the caller's count times LOOP_FACTOR ** loop_depth; functions
+nobody calls count once. Recursion is collapsed into strongly connected
+components, so the whole estimate is one pass over the condensation in
+topological order. Counts are kept as log10 ("orders of magnitude") so long
+call chains cannot overflow.
+"""
+
+import math
+from typing import Dict, Hashable, List, Optional
+
+import networkx as nx
+
+
+class HotnessIndex:
+    """Fan-in and estimated call frequency per qualified name."""
+
+    LOOP_FACTOR = 10       # assumed iterations of each enclosing loop
+    MAX_LOG_CALLS = 9.0    # cap: beyond ~1e9 estimated calls the ranking no longer discriminates
+
+    def __init__(self, call_graph: nx.DiGraph):
+        self.graph = call_graph
+        self._log_calls: Optional[Dict[Hashable, float]] = None
+
+    def fan_in(self, qname: str) -> int:
+        """Distinct direct callers, self-recursion excluded."""
+        if qname not in self.graph:
+            return 0
+        return sum(1 for pred in self.graph.predecessors(qname) if pred != qname)
+
+    def log_calls(self, qname: str) -> float:
+        """log10 of the estimated number of times `qname` runs per run of the program."""
+        if self._log_calls is None:
+            self._log_calls = self._compute()
+        return self._log_calls.get(qname, 0.0)
+
+    def heat(self, qname: str, loop_depth: int = 0) -> float:
+        """log10 of the estimated executions of a statement at `loop_depth` inside `qname`."""
+        return self.log_calls(qname) + loop_depth * math.log10(self.LOOP_FACTOR)
+
+    def hot_chain(self, qname: str, limit: int = 8) -> List[str]:
+        """Call chain from an entry point to `qname` through the caller contributing most calls at each step."""
+        step = math.log10(self.LOOP_FACTOR)
+        chain, seen = [qname], {qname}
+        while len(chain) < limit and chain[0] in self.graph:
+            callers = [(self.log_calls(pred) + self.graph.edges[pred, chain[0]].get("loop_depth", 0) * step, pred)
+                       for pred in self.graph.predecessors(chain[0]) if pred not in seen]
+            if not callers:
+                break
+            _, best = max(callers)
+            chain.insert(0, best)
+            seen.add(best)
+        return chain
+
+    def _compute(self) -> Dict[Hashable, float]:
+        if not self.graph.number_of_nodes():
+            return {}
+        cond = nx.condensation(self.graph)
+        mapping = cond.graph["mapping"]
+        step = math.log10(self.LOOP_FACTOR)
+        per_comp: Dict[int, float] = {}
+        for comp in nx.topological_sort(cond):
+            terms = []
+            for node in cond.nodes[comp]["members"]:
+                for pred in self.graph.predecessors(node):
+                    if mapping[pred] == comp:
+                        continue  # recursion adds no static information
+                    depth = self.graph.edges[pred, node].get("loop_depth", 0)
+                    terms.append(per_comp[mapping[pred]] + depth * step)
+            per_comp[comp] = min(self._log_sum(terms), self.MAX_LOG_CALLS) if terms else 0.0
+        return {node: per_comp[comp] for node, comp in mapping.items()}
+
+    @staticmethod
+    def _log_sum(terms) -> float:
+        """log10(sum(10 ** t)) without leaving log space."""
+        top = max(terms)
+        return top + math.log10(sum(10 ** (t - top) for t in terms))
@@ -0,0 +1,145 @@
+"""
+Parse Store
+On-disk, column-oriented spill store for per-file parser output.
+
+Each top-level key of a parse result ("functions", "imports", "calls", ...)
+is written to its own append-only column file as soon as a file is indexed.
+Reads return lazy rows that load only the columns a check touches, through
+an LRU cache held under a memory budget.
+"""
+
+import os
+import zlib
+import shutil
+import pickle
+import tempfile
+from collections import OrderedDict
+from collections.abc import Mapping, MutableMapping
+from pathlib import Path
+from typing import Any, Dict, Iterator, Optional, Tuple
+
+
+class LazyRecord(Mapping):
+    """Read-only view of one file's parse result; columns are fetched on access."""
+
+    def __init__(self, store: "ParseStore", key: str):
+        self._store = store
+        self._key = key
+
+    def __getitem__(self, column: str) -> Any:
+        return self._store._read_column(self._key, column)
+
+    def __iter__(self) -> Iterator[str]:
+        return iter(self._store._index.get(self._key, {}))
+
+    def __len__(self) -> int:
+        return len(self._store._index.get(self._key, {}))
+
+    def materialize(self) -> Dict[str, Any]:
+        return {column: self[column] for column in self}
+
+
+class ParseStore(MutableMapping):
+    """
+    Mapping path -> parse result backed by column files in `directory`
+    (a temporary directory removed on close() when not given).
+    """
+
+    DECODED_FACTOR = 5  # decoded Python objects vs. pickled bytes, for budgeting (compression ratios vary too much)
+
+    def __init__(self, max_memory_bytes: int, directory: Optional[Path] = None):
+        self.max_memory = max(0, int(max_memory_bytes))
+        self._owns_dir = directory is None
+        self.directory = Path(directory or tempfile.mkdtemp(prefix="parse_store_"))
+        self.directory.mkdir(parents=True, exist_ok=True)
+
+        self._index: Dict[str, Dict[str, Tuple[int, int]]] = {}  # key -> column -> (offset, length)
+        self._files: Dict[str, Any] = {}                          # column -> open file handle
+        self._cache: "OrderedDict[Tuple[str, str], Tuple[Any, int]]" = OrderedDict()
+        self._cached_bytes = 0
+        self.stats = {"spilled_bytes": 0, "column_reads": 0, "cache_hits": 0}
+
+    # ── MutableMapping ───────────────────────────────────────────────
+
+    def __setitem__(self, key: str, data: Dict[str, Any]):
+        self._drop_cached(key)
+        columns = {}
+        for column, value in data.items():
+            blob = zlib.compress(pickle.dumps(value, protocol=pickle.HIGHEST_PROTOCOL), 1)
+            handle = self._column_file(column)
+            handle.seek(0, os.SEEK_END)
+            offset = handle.tell()
+            handle.write(blob)
+            columns[column] = (offset, len(blob))
+            self.stats["spilled_bytes"] += len(blob)
+        self._index[key] = columns
+
+    def __getitem__(self, key: str) -> LazyRecord:
+        if key not in self._index:
+            raise KeyError(key)
+        return LazyRecord(self, key)
+
+    def __delitem__(self, key: str):
+        del self._index[key]  # column space is not reclaimed; the store is per-run
+        self._drop_cached(key)
+
+    def __iter__(self) -> Iterator[str]:
+        return iter(list(self._index))
+
+    def __len__(self) -> int:
+        return len(self._index)
+
+    def __contains__(self, key) -> bool:
+        return key in self._index
+
+    # ── Column access ────────────────────────────────────────────────
+
+    def _column_file(self, column: str):
+        handle = self._files.get(column)
+        if handle is None:
+            safe = "".join(ch if ch.isalnum() or ch in "_-" else "_" for ch in column)
+            handle = open(self.directory / f"{safe}.col", "a+b")
+            self._files[column] = handle
+        return handle
+
+    def _read_column(self, key: str, column: str) -> Any:
+        cached = self._cache.get((key, column))
+        if cached is not None:
+            self._cache.move_to_end((key, column))
+            self.stats["cache_hits"] += 1
+            return cached[0]
+
+        columns = self._index.get(key)
+        if columns is None or column not in columns:
+            raise KeyError(column)
+        offset, length = columns[column]
+        handle = self._column_file(column)
+        handle.flush()
+        handle.seek(offset)
+        raw = zlib.decompress(handle.read(length))
+        value = pickle.loads(raw)
+        self.stats["column_reads"] += 1
+
+        cost = len(raw) * self.DECODED_FACTOR
+        if cost <= self.max_memory:
+            self._cache[(key, column)] = (value, cost)
+            self._cached_bytes += cost
+            while self._cached_bytes > self.max_memory and self._cache:
+                _, (_, evicted) = self._cache.popitem(last=False)
+                self._cached_bytes -= evicted
+        return value
+
+    def _drop_cached(self, key: str):
+        for column in self._index.get(key, {}):
+            entry = self._cache.pop((key, column), None)
+            if entry is not None:
+                self._cached_bytes -= entry[1]
+
+    def close(self):
+        for handle in self._files.values():
+            handle.close()
+        self._files.clear()
+        self._cache.clear()
+        self._cached_bytes = 0
+        if self._owns_dir:
+            shutil.rmtree(self.directory, ignore_errors=True)
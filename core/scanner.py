@@ -6,10 +6,12 @@ Recursively discovers code files.
 import os
 from pathlib import Path
 from typing import List
+from core.compile_db import C_FAMILY_EXTENSIONS
 
 class FileScanner:
-    def __init__(self, root_path: Path):
+    def __init__(self, root_path: Path, compile_db=None):
         self.root_path = root_path
+        self.compile_db = compile_db  # Optional CompilationDatabase scoping C/C++ files
         self.extensions = {'.py', '.c', '.cpp', '.cc', '.h', '.hpp', '.java'}
         self.ignore_dirs = {
             '.git', 'node_modules', '__pycache__', 'venv', '.venv',
@@ -27,7 +29,12 @@ class FileScanner:
             
             for file in files:
                 file_path = Path(root) / file
-                if file_path.suffix in self.extensions:
-                    code_files.append(file_path)
+                if file_path.suffix not in self.extensions:
+                    continue
+                # With a compilation database, only analyze what is actually built
+                if (self.compile_db and file_path.suffix in C_FAMILY_EXTENSIONS
+                        and not self.compile_db.covers(file_path)):
+                    continue
+                code_files.append(file_path)
         
         return code_files
@@ -4,7 +4,7 @@ Creates a global index of all symbols for cross-file analysis.
 """
 
 from pathlib import Path
-from typing import Dict, List
+from typing import Callable, Dict, List, Optional
 from enum import Enum
 
 class SymbolType(Enum):
@@ -24,7 +24,8 @@ class Symbol:
         docstring: str = "",
         body_code: str = "",
         parent_name: str = "",
-        attributes: List[str] = None
+        attributes: List[str] = None,
+        body_loader: Optional[Callable[[], str]] = None
     ):
         self.name = name
         self.type = symbol_type
@@ -32,11 +33,24 @@ class Symbol:
         self.line = line
         self.signature = signature
         self.docstring = docstring
-        self.body_code = body_code
+        self._body_code = body_code
+        # Spill mode: the body stays in the parse store and is read back on each access
+        self._body_loader = body_loader
         self.parent_name = parent_name
         self.attributes = attributes or []
         self.qualified_name = ""  # Set by table builder
 
+    @property
+    def body_code(self) -> str:
+        if self._body_loader is not None:
+            return self._body_loader()
+        return self._body_code
+
+    @body_code.setter
+    def body_code(self, value: str):
+        self._body_code = value
+        self._body_loader = None
+
 class SymbolTableBuilder:
     """
     Builds a comprehensive symbol table from parsed files.
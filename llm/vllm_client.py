@@ -5,6 +5,7 @@ Interfaces with local Qwen2.5-Coder via OpenAI-compatible API.
 
 from typing import Optional
 from openai import AsyncOpenAI
+import asyncio
 import hashlib
 import json
 
@@ -16,6 +17,10 @@ class VLLMClient:
         )
         self.model = model
         self.cache = {}  # Disabled persistent caching per user request
+        self.in_flight = 0  # requests awaiting a response (shown by the progress dashboard)
+        self.tokenize_supported = True  # cleared once /tokenize answers 404 or an unexpected body
+        self._http = None  # shared httpx client for /tokenize, tied to the loop that created it
+        self._http_loop = None
     
     async def generate_completion(
         self, 
@@ -31,6 +36,7 @@ class VLLMClient:
         if cache_key in self.cache:
             return self.cache[cache_key]
         
+        self.in_flight += 1
         try:
             response = await self.client.chat.completions.create(
                 model=self.model,
@@ -45,3 +51,55 @@ class VLLMClient:
             
         except Exception as e:
             raise RuntimeError(f"vLLM request failed: {e}")
+        finally:
+            self.in_flight -= 1
+
+    async def count_tokens(self, text: str) -> Optional[int]:
+        """
+        Exact prompt token count via vLLM's /tokenize endpoint.
+        Returns None when the count is unavailable. Only a missing endpoint
+        or a malformed reply clears tokenize_supported; timeouts and
+        connection errors affect this call alone.
+        """
+        if not self.tokenize_supported:
+            return None
+        try:
+            import httpx
+        except ImportError:
+            self.tokenize_supported = False
+            return None
+        try:
+            response = await self._tokenize_client(httpx).post(
+                self._tokenize_url(), json={"model": self.model, "prompt": text})
+        except httpx.HTTPError:
+            return None
+        if response.status_code in (404, 405, 501):
+            self.tokenize_supported = False
+            return None
+        if response.status_code >= 400:
+            return None
+        try:
+            return int(response.json()["count"])
+        except (ValueError, KeyError, TypeError):
+            self.tokenize_supported = False
+            return None
+
+    def _tokenize_url(self) -> str:
+        root = str(self.client.base_url).rstrip("/")
+        if root.endswith("/v1"):
+            root = root[:-3]
+        return f"{root}/tokenize"
+
+    def _tokenize_client(self, httpx):
+        loop = asyncio.get_running_loop()
+        if self._http is None or self._http_loop is not loop:
+            self._http = httpx.AsyncClient(timeout=10)
+            self._http_loop = loop
+        return self._http
+
+    async def close(self):
+        """Release the shared tokenizer connection pool."""
+        if self._http is not None:
+            await self._http.aclose()
+            self._http = None
+            self._http_loop = None
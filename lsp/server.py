@@ -0,0 +1,455 @@
+"""
+Language Server
+Language Server Protocol frontend over stdio (JSON-RPC with Content-Length
+framing) for editor feedback while typing.
+
+Open documents are synced incrementally: each `didChange` range edit is
+applied to the text and, for C/C++/Java, to the document's Tree-sitter tree
+(`Tree.edit`), which is then reparsed with the old tree so only the edited
+region is re-scanned. After every change the file's syntax, static and
+structural diagnostics are recomputed from that tree and republished; the
+structural index of the workspace is updated for the one file only.
+LLM audits are optional and debounced: they start once a file has been quiet
+for `debounce` seconds and only re-audit functions whose body changed.
+"""
+
+import asyncio
+import hashlib
+import json
+import sys
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+from urllib.parse import unquote, urlparse
+from urllib.request import url2pathname
+
+from analyzers.static_syntax import StaticSyntaxAnalyzer
+from analyzers.static_bug_detector import StaticBugDetector
+from analyzers.structural_analyzer import StructuralAnalyzer
+
+
+# LSP constants
+SYNC_INCREMENTAL = 2
+ERROR, WARNING, INFORMATION, HINT = 1, 2, 3, 4
+TAG_UNNECESSARY = 1
+METHOD_NOT_FOUND, INVALID_REQUEST, SERVER_NOT_INITIALIZED = -32601, -32600, -32002
+
+
+def uri_to_path(uri: str) -> Path:
+    return Path(url2pathname(unquote(urlparse(uri).path)))
+
+
+# ── Transport ────────────────────────────────────────────────────────
+
+class JsonRpcStream:
+    """Content-Length framed JSON-RPC messages on binary streams."""
+
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+
+    def read_message(self) -> Optional[Dict[str, Any]]:
+        """Next message, or None at end of input."""
+        length = None
+        while True:
+            header = self.reader.readline()
+            if not header:
+                return None
+            header = header.decode('ascii', errors='replace').strip()
+            if not header:
+                break
+            name, _, value = header.partition(":")
+            if name.strip().lower() == "content-length":
+                length = int(value.strip())
+        if length is None:
+            return {}
+        body = self.reader.read(length)
+        if len(body) < length:
+            return None
+        return json.loads(body.decode('utf-8'))
+
+    def write_message(self, message: Dict[str, Any]):
+        body = json.dumps(message, separators=(",", ":")).encode('utf-8')
+        self.writer.write(b"Content-Length: %d\r\n\r\n" % len(body) + body)
+        self.writer.flush()
+
+
+# ── Documents ────────────────────────────────────────────────────────
+
+class TextDocument:
+    """An open buffer: text, version and (for Tree-sitter languages) its parse tree."""
+
+    def __init__(self, uri: str, text: str, version: int, language: Optional[str], parser=None):
+        self.uri = uri
+        self.path = uri_to_path(uri)
+        self.text = text
+        self.version = version
+        self.language = language   # Tree-sitter language id; None for Python / unsupported
+        self.parser = parser
+        self.tree = parser.parse(text.encode('utf-8')) if parser else None
+        self._lines: Optional[List[str]] = None
+
+    @property
+    def lines(self) -> List[str]:
+        if self._lines is None:
+            self._lines = self.text.split("\n")
+        return self._lines
+
+    def apply_changes(self, changes: List[Dict[str, Any]], version: int):
+        """Apply `didChange` content changes in order, then reparse incrementally."""
+        for change in changes:
+            if "range" not in change:
+                self.text = change["text"]
+                self._lines = None
+                self.tree = None
+                continue
+            start, start_byte, start_point = self._locate(change["range"]["start"])
+            end, old_end_byte, old_end_point = self._locate(change["range"]["end"])
+            new = change["text"]
+            self.text = self.text[:start] + new + self.text[end:]
+            self._lines = None
+            if self.tree is not None:
+                encoded = new.encode('utf-8')
+                rows = new.count("\n")
+                if rows:
+                    new_end_point = (start_point[0] + rows, len(new.rsplit("\n", 1)[1].encode('utf-8')))
+                else:
+                    new_end_point = (start_point[0], start_point[1] + len(encoded))
+                self.tree.edit(start_byte=start_byte, old_end_byte=old_end_byte,
+                               new_end_byte=start_byte + len(encoded), start_point=start_point,
+                               old_end_point=old_end_point, new_end_point=new_end_point)
+        self.version = version
+        if self.parser:
+            self.tree = self.parser.parse(self.text.encode('utf-8'), self.tree) if self.tree is not None \
+                else self.parser.parse(self.text.encode('utf-8'))
+
+    def _locate(self, position: Dict[str, int]) -> Tuple[int, int, Tuple[int, int]]:
+        """LSP position (UTF-16 column) -> (string index, byte offset, Tree-sitter point)."""
+        lines = self.lines
+        if position["line"] >= len(lines):
+            return len(self.text), len(self.text.encode('utf-8')), (len(lines) - 1, len(lines[-1].encode('utf-8')))
+        row = position["line"]
+        line = lines[row]
+        column = self._utf16_to_index(line, position["character"])
+        line_start = sum(len(text) + 1 for text in lines[:row])
+        byte_column = len(line[:column].encode('utf-8'))
+        line_start_byte = len(self.text[:line_start].encode('utf-8'))
+        return line_start + column, line_start_byte + byte_column, (row, byte_column)
+
+    @staticmethod
+    def _utf16_to_index(line: str, units: int) -> int:
+        index = 0
+        while index < len(line) and units > 0:
+            units -= 2 if ord(line[index]) > 0xFFFF else 1
+            index += 1
+        return index
+
+    def utf16_length(self, row: int, index: Optional[int] = None) -> int:
+        text = self.lines[row] if 0 <= row < len(self.lines) else ""
+        text = text if index is None else text[:index]
+        return sum(2 if ord(ch) > 0xFFFF else 1 for ch in text)
+
+    def line_range(self, line: int, column: int = 0, byte_column: bool = False) -> Dict[str, Any]:
+        """Range from 1-based (line, column) to the end of that line."""
+        row = max(0, min(line - 1, len(self.lines) - 1))
+        index = max(0, column - 1)
+        if byte_column:
+            index = len(self.lines[row].encode('utf-8')[:index].decode('utf-8', errors='ignore'))
+        start = min(self.utf16_length(row, index), self.utf16_length(row))
+        end = self.utf16_length(row)
+        return {"start": {"line": row, "character": start if start < end else 0},
+                "end": {"line": row, "character": end}}
+
+
+# ── Server ───────────────────────────────────────────────────────────
+
+class LanguageServer:
+    """Stdio language server publishing the analyzer's fast diagnostics per edit."""
+
+    SOURCE = "code-analyzer"
+    SEMANTIC_SEVERITY = {"critical": ERROR, "high": WARNING, "medium": INFORMATION, "low": HINT}
+
+    def __init__(self, llm_url: Optional[str] = None, debounce: float = 2.0, compile_commands: Optional[Path] = None):
+        self.llm_url = llm_url
+        self.debounce = debounce
+        self.compile_commands = compile_commands
+        self.stream: Optional[JsonRpcStream] = None
+        self.documents: Dict[str, TextDocument] = {}
+        self.structural: Optional[StructuralAnalyzer] = None
+        self.syntax: Optional[StaticSyntaxAnalyzer] = None
+        self.static_detector = StaticBugDetector()
+        self.root: Optional[Path] = None
+        self.initialized = False
+        self.shutdown_requested = False
+        self.indexing: Optional[asyncio.Task] = None
+        self.audits: Dict[str, asyncio.Task] = {}        # uri -> pending debounced LLM audit
+        self.fast_diagnostics: Dict[str, List[Dict]] = {}
+        self.semantic_diagnostics: Dict[str, List[Dict]] = {}
+        self.semantic_cache: Dict[Tuple[str, str], List[Any]] = {}   # (symbol, body md5) -> bugs
+        self.detector = None
+
+    async def serve(self, reader=None, writer=None) -> int:
+        """Run until `exit`; returns the process exit code."""
+        writer = writer or sys.stdout.buffer
+        reader = reader or sys.stdin.buffer
+        # Analyzer warnings are printed; keep them off the protocol stream
+        sys.stdout = sys.stderr
+        self.stream = JsonRpcStream(reader, writer)
+        loop = asyncio.get_running_loop()
+        while True:
+            message = await loop.run_in_executor(None, self.stream.read_message)
+            if message is None:
+                return 0 if self.shutdown_requested else 1
+            if message.get("method") == "exit":
+                return 0 if self.shutdown_requested else 1
+            try:
+                await self.handle(message)
+            except Exception as e:
+                print(f"Warning: {message.get('method')} failed: {e}")
+                if "id" in message:
+                    self._respond(message["id"], error={"code": -32603, "message": str(e)})
+
+    async def handle(self, message: Dict[str, Any]):
+        method, params, msg_id = message.get("method"), message.get("params") or {}, message.get("id")
+        if method is None:
+            return  # a response to a server request; none are sent
+        if method == "initialize":
+            self._respond(msg_id, self._initialize(params))
+            return
+        if not self.initialized and msg_id is not None:
+            self._respond(msg_id, error={"code": SERVER_NOT_INITIALIZED, "message": "Server not initialized"})
+            return
+        if self.shutdown_requested and msg_id is not None:
+            self._respond(msg_id, error={"code": INVALID_REQUEST, "message": "Server is shutting down"})
+            return
+
+        if method == "initialized":
+            self.indexing = asyncio.get_running_loop().create_task(self._index_workspace())
+        elif method == "shutdown":
+            self.shutdown_requested = True
+            for task in list(self.audits.values()) + [self.indexing]:
+                if task:
+                    task.cancel()
+            self._respond(msg_id, None)
+        elif method == "textDocument/didOpen":
+            item = params["textDocument"]
+            self._open(item["uri"], item["text"], item.get("version", 0))
+        elif method == "textDocument/didChange":
+            doc = self.documents.get(params["textDocument"]["uri"])
+            if doc:
+                doc.apply_changes(params["contentChanges"], params["textDocument"].get("version", doc.version))
+                self._refresh(doc)
+        elif method == "textDocument/didSave":
+            doc = self.documents.get(params["textDocument"]["uri"])
+            if doc and "text" in params:
+                doc.apply_changes([{"text": params["text"]}], doc.version)
+                self._refresh(doc)
+        elif method == "textDocument/didClose":
+            self._close(params["textDocument"]["uri"])
+        elif msg_id is not None:
+            self._respond(msg_id, error={"code": METHOD_NOT_FOUND, "message": f"Unsupported method {method}"})
+        # Other notifications ($/cancelRequest, workspace/didChangeConfiguration, ...) need no action
+
+    # ── Lifecycle ────────────────────────────────────────────────────
+
+    def _initialize(self, params: Dict[str, Any]) -> Dict[str, Any]:
+        root_uri = params.get("rootUri") or next(iter(params.get("workspaceFolders") or []), {}).get("uri")
+        self.root = uri_to_path(root_uri) if root_uri else (Path(params["rootPath"]) if params.get("rootPath") else None)
+
+        from core.compile_db import CompilationDatabase
+        compile_db = None
+        if self.compile_commands:
+            compile_db = CompilationDatabase(self.compile_commands, project_root=self.root or Path.cwd())
+        elif self.root:
+            compile_db = CompilationDatabase.discover(self.root)
+        self.structural = StructuralAnalyzer(compile_db=compile_db)
+        self.syntax = StaticSyntaxAnalyzer(compile_db=compile_db)
+        if self.llm_url:
+            from llm.vllm_client import VLLMClient
+            from analyzers.llm_bug_detector import LLMBugDetector
+            self.detector = LLMBugDetector(VLLMClient(base_url=self.llm_url))
+        self.initialized = True
+        return {
+            "capabilities": {
+                "textDocumentSync": {"openClose": True, "change": SYNC_INCREMENTAL,
+                                     "save": {"includeText": True}},
+            },
+            "serverInfo": {"name": self.SOURCE},
+        }
+
+    async def _index_workspace(self):
+        """Index the workspace for cross-file checks without blocking message handling."""
+        if self.root is None:
+            return
+        from core.scanner import FileScanner
+        for file_path in FileScanner(self.root, compile_db=self.structural.parser.compile_db).scan():
+            key = str(file_path)
+            if any(str(doc.path) == key for doc in self.documents.values()):
+                continue  # indexed from the open buffer
+            try:
+                code = file_path.read_text(encoding='utf-8')
+                self.structural.index_file(file_path, self.structural.parser.parse(code, file_path))
+            except Exception as e:
+                print(f"Warning: Could not parse {file_path}: {e}")
+            await asyncio.sleep(0)
+        for doc in self.documents.values():
+            self._refresh(doc, audit=False)  # dead code is only meaningful once everything is indexed
+
+    # ── Documents ────────────────────────────────────────────────────
+
+    def _open(self, uri: str, text: str, version: int):
+        path = uri_to_path(uri)
+        language = self.structural.parser.language_for(path) if path.suffix.lower() != '.py' else None
+        parser = self.structural.parser.parsers.get(language) if language else None
+        doc = TextDocument(uri, text, version, language if parser else None, parser)
+        self.documents[uri] = doc
+        self._refresh(doc)
+
+    def _close(self, uri: str):
+        doc = self.documents.pop(uri, None)
+        task = self.audits.pop(uri, None)
+        if task:
+            task.cancel()
+        self.fast_diagnostics.pop(uri, None)
+        self.semantic_diagnostics.pop(uri, None)
+        if doc is None:
+            return
+        # Back to the saved contents for cross-file checks
+        self.structural.flipped_names.clear()
+        try:
+            code = doc.path.read_text(encoding='utf-8')
+            self.structural.index_file(doc.path, self.structural.parser.parse(code, doc.path))
+        except (OSError, UnicodeDecodeError):
+            self.structural.remove_file(doc.path)
+        self._notify("textDocument/publishDiagnostics", {"uri": uri, "diagnostics": []})
+        self._republish_affected(None)
+
+    def _refresh(self, doc: TextDocument, audit: bool = True):
+        """Recompute and publish the fast diagnostics; (re)start the debounced LLM audit."""
+        data = self.structural.parser.parse(doc.text, doc.path, tree=doc.tree)
+        self.structural.flipped_names.clear()
+        self.structural.index_file(doc.path, data)  # replaces the document's previous version
+        self.fast_diagnostics[doc.uri] = self.diagnose(doc)
+        self._publish(doc)
+        self._republish_affected(doc)
+        if audit and self.detector is not None:
+            pending = self.audits.pop(doc.uri, None)
+            if pending:
+                pending.cancel()
+            self.audits[doc.uri] = asyncio.get_running_loop().create_task(self._audit_later(doc, data))
+
+    def _republish_affected(self, changed: Optional[TextDocument]):
+        """Other open documents defining a name that just gained its first caller/importer or lost its
+        last one: their dead-code and unused-variable hints changed."""
+        flipped = self.structural.flipped_names
+        if not flipped:
+            return
+        symbols = self.structural.symbol_table.symbols
+        for other in list(self.documents.values()):
+            if other is changed or other.uri not in self.fast_diagnostics:
+                continue
+            key = str(other.path)
+            names = {symbols[q].name for q in self.structural.file_symbols.get(key, []) if q in symbols}
+            data = self.structural.file_data_map.get(key)
+            if data is not None:
+                names.update(v["name"] for v in data.get("variables", []) if isinstance(v, dict) and "name" in v)
+            if names & flipped:
+                self.fast_diagnostics[other.uri] = self.diagnose(other)
+                self._publish(other)
+        flipped.clear()
+
+    def _publish(self, doc: TextDocument):
+        self._notify("textDocument/publishDiagnostics", {
+            "uri": doc.uri, "version": doc.version,
+            "diagnostics": self.fast_diagnostics.get(doc.uri, []) + self.semantic_diagnostics.get(doc.uri, []),
+        })
+
+    # ── Diagnostics ──────────────────────────────────────────────────
+
+    def diagnose(self, doc: TextDocument) -> List[Dict[str, Any]]:
+        """Syntax, static and structural diagnostics for the current buffer."""
+        diagnostics = []
+        if doc.path.suffix.lower() == '.py':
+            _, errors = self.syntax.analyze_code(doc.text, '.py')
+            byte_columns = False
+        elif doc.tree is not None:
+            errors = self.syntax.tree_errors(doc.tree, doc.text, doc.language)
+            byte_columns = True   # Tree-sitter columns count bytes
+        else:
+            errors = []
+        for err in errors:
+            diagnostics.append(self._diagnostic(doc, err.line, err.message, ERROR, "syntax",
+                                                column=err.column, byte_column=byte_columns, code=err.parser))
+        if errors:
+            return diagnostics  # the rest would describe a half-parsed file
+
+        if doc.path.suffix.lower() == '.py':
+            for issue in self.static_detector.analyze_code(doc.text):
+                diagnostics.append(self._diagnostic(doc, issue.get("line", 0), issue.get("message", ""), WARNING,
+                                                    "static"))
+
+        checks = self.structural.check_file(doc.path, doc.text)
+        for sym in checks["dead_code"]:
+            diagnostics.append(self._diagnostic(doc, sym.line, f"`{sym.name}` is never called", HINT, "structural",
+                                                code="dead-code", tags=[TAG_UNNECESSARY]))
+        for var in checks["unused_variables"]:
+            scope = "Global" if var["type"] == "global_variable" else "Local"
+            diagnostics.append(self._diagnostic(doc, var["line"], f"{scope} variable `{var['name']}` is never used",
+                                                HINT, "structural", code="unused-variable", tags=[TAG_UNNECESSARY]))
+        return diagnostics
+
+    def _diagnostic(self, doc: TextDocument, line: int, message: str, severity: int, phase: str,
+                    column: int = 0, byte_column: bool = False, code: Optional[str] = None,
+                    tags: Optional[List[int]] = None) -> Dict[str, Any]:
+        diagnostic = {"range": doc.line_range(line or 1, column, byte_column), "severity": severity,
+                      "source": f"{self.SOURCE}/{phase}", "message": message}
+        if code:
+            diagnostic["code"] = code
+        if tags:
+            diagnostic["tags"] = tags
+        return diagnostic
+
+    # ── Debounced LLM audit ──────────────────────────────────────────
+
+    async def _audit_later(self, doc: TextDocument, data: Dict[str, Any]):
+        try:
+            await asyncio.sleep(self.debounce)
+            version = doc.version
+            language = doc.language or 'python'
+            diagnostics = []
+            for func in data.get("functions", []):
+                body = func.get("body_code", "")
+                key = (func["name"], hashlib.md5(body.encode('utf-8', errors='replace')).hexdigest())
+                if key not in self.semantic_cache:
+                    bugs, _ = await self.detector.analyze_symbol(func["name"], body, language, doc.path)
+                    self.semantic_cache[key] = bugs
+                    if doc.version != version:
+                        return  # edited meanwhile; the newer audit takes over
+                for bug in self.semantic_cache[key]:
+                    line = bug.line if isinstance(bug.line, int) else 0
+                    if line < func["line"]:
+                        line = func["line"] + max(line, 1) - 1  # reported relative to the symbol
+                    diagnostics.append(self._diagnostic(
+                        doc, line, f"{bug.description}\n{bug.suggestion}".strip(),
+                        self.SEMANTIC_SEVERITY.get((bug.severity or "").lower(), INFORMATION), "semantic",
+                        code=bug.type))
+            self.semantic_diagnostics[doc.uri] = diagnostics
+            if self.documents.get(doc.uri) is doc:
+                self._publish(doc)
+        except asyncio.CancelledError:
+            pass
+        finally:
+            if self.audits.get(doc.uri) is asyncio.current_task():
+                del self.audits[doc.uri]
+
+    # ── Messages ─────────────────────────────────────────────────────
+
+    def _respond(self, msg_id, result: Any = None, error: Optional[Dict[str, Any]] = None):
+        message = {"jsonrpc": "2.0", "id": msg_id}
+        if error is not None:
+            message["error"] = error
+        else:
+            message["result"] = result
+        self.stream.write_message(message)
+
+    def _notify(self, method: str, params: Dict[str, Any]):
+        self.stream.write_message({"jsonrpc": "2.0", "method": method, "params": params})
@@ -15,6 +15,7 @@ import json
 import difflib
 import warnings
 import time
+from typing import List, Optional
 
 # Suppress Tree-sitter deprecation warnings
 warnings.filterwarnings("ignore", category=FutureWarning, module="tree_sitter")
@@ -28,7 +29,14 @@ def analyze(
     output: Path = typer.Option("report.json", "--output", "-o", help="Output report path"),
     vllm_url: str = typer.Option("http://127.0.0.1:8000/v1", "--vllm-url", help="LLM server URL (OpenAI-compatible)"),
     generate_fixes: bool = typer.Option(True, "--fixes/--no-fixes", "--generate-fixes", help="Generate code fixes"),
-
+    compile_commands: Path = typer.Option(None, "--compile-commands", help="compile_commands.json scoping C/C++ analysis (auto-detected in FOLDER or FOLDER/build)"),
+    clone_index: Path = typer.Option(None, "--clone-index", help="Persistent clone index (SQLite) shared across runs and repositories"),
+    repo_name: str = typer.Option(None, "--repo-name", help="Name of this repository inside the clone index (default: folder name)"),
+    redundancy_config: Path = typer.Option(None, "--redundancy-config", help="Calibrated duplicate-detection thresholds (auto-detected as FOLDER/redundancy_thresholds.json)"),
+    max_memory: int = typer.Option(None, "--max-memory", help="Spill parse results to disk and keep at most this many MB of them in memory"),
+    log_file: Path = typer.Option(None, "--log-file", help="Write per-file and per-pair progress detail here (the terminal shows a live summary)"),
+    fix_cache: Path = typer.Option(None, "--fix-cache", help="Keep syntax-fix suggestions in this JSON file and reuse them across runs"),
+    verify_fixes: bool = typer.Option(False, "--verify-fixes", help="Run flagged functions and their LLM performance fixes side by side (differential test + benchmark); executes analyzed code"),
 ):
     """
     Analyze code folder with interactive task selection.
@@ -47,6 +55,7 @@ def analyze(
     menu.add_row("3.", "Semantic Bug Detection (LLM)")
     menu.add_row("4.", "Structural Assessment (Call Graph, Dead Code)")
     menu.add_row("5.", "Redundancy & Duplicate Check")
+    menu.add_row("6.", "Performance Audit (Threads/GIL, Hot-Path Rules)")
 
     console.print(Panel(
         menu,
@@ -56,14 +65,15 @@ def analyze(
     ))
 
     from rich.prompt import Prompt
-    choice = Prompt.ask("Choose an option", choices=["1", "2", "3", "4", "5"], default="1")
+    choice = Prompt.ask("Choose an option", choices=["1", "2", "3", "4", "5", "6"], default="1")
     
     mode_map = {
         "1": "full",
         "2": "syntax",
         "3": "semantic",
         "4": "structural",
-        "5": "redundancy"
+        "5": "redundancy",
+        "6": "performance"
     }
     analysis_mode = mode_map[choice]
 
@@ -77,12 +87,19 @@ def analyze(
     console.print(f"\n[bold blue]🔍 Starting {analysis_mode.upper()} Analysis:[/bold blue] {folder}\n")
     
     # Run async analysis
-    asyncio.run(run_analysis(folder, output, vllm_url, generate_fixes, analysis_mode))
+    asyncio.run(run_analysis(folder, output, vllm_url, generate_fixes, analysis_mode, compile_commands,
+                             clone_index, repo_name, redundancy_config, max_memory, log_file, fix_cache,
+                             verify_fixes))
 
-async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes: bool, analysis_mode: str = "full"):
+async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes: bool, analysis_mode: str = "full",
+                       compile_commands: Path = None, clone_index: Path = None, repo_name: str = None,
+                       redundancy_config: Path = None, max_memory: int = None, log_file: Path = None,
+                       fix_cache: Path = None, verify_fixes: bool = False):
     from core.scanner import FileScanner
+    from core.compile_db import CompilationDatabase
     from analyzers.static_syntax import StaticSyntaxAnalyzer, FileSyntaxError
     from analyzers.syntax_fix_generator import SyntaxFixGenerator
+    from analyzers.syntax_fix_cache import SyntaxFixCache
     from analyzers.llm_bug_detector import LLMBugDetector
     from analyzers.fix_generator import FixGenerator
     from analyzers.cross_file_redundancy import CrossFileRedundancyDetector
@@ -91,20 +108,40 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
     from analyzers.structural_analyzer import StructuralAnalyzer
     from llm.vllm_client import VLLMClient
     from utils.html_report_generator import HTMLReportGenerator
+    from utils.progress import ProgressDashboard
     
     # Initialize vLLM client
     console.print(f"[cyan]→ Connecting to LLM at {vllm_url}[/cyan]")
     llm_client = VLLMClient(base_url=vllm_url)
+    # Live counters for the batch phases; per-item detail goes to --log-file
+    dashboard = ProgressDashboard(console, llm_client=llm_client, log_file=log_file)
+    if log_file:
+        console.print(f"[cyan]→ Logging progress detail to {log_file}[/cyan]")
+    
+    # Compilation database (C/C++ scoping, language and include paths)
+    compile_db = None
+    if compile_commands:
+        if not compile_commands.exists():
+            console.print(f"[red]Error: {compile_commands} does not exist[/red]")
+            return
+        compile_db = CompilationDatabase(compile_commands, project_root=folder)
+    else:
+        compile_db = CompilationDatabase.discover(folder)
+    if compile_db:
+        console.print(f"[cyan]→ Using {compile_db.db_path}: {len(compile_db.entries)} translation units, "
+                      f"{len(compile_db.headers)} reachable headers[/cyan]")
     
     # Scan files
     console.print("\nScanning files...")
-    scanner = FileScanner(folder)
+    scanner = FileScanner(folder, compile_db=compile_db)
     files = scanner.scan()
     console.print(f"✓ Found {len(files)} code files\n")
     
     # Phase 2: Static Syntax Check
-    syntax_analyzer = StaticSyntaxAnalyzer(llm_client)
-    syntax_fix_generator = SyntaxFixGenerator(llm_client)
+    syntax_analyzer = StaticSyntaxAnalyzer(llm_client, compile_db=compile_db)
+    # Repeated error shapes reuse an earlier fix (revalidated by reparsing) instead of an LLM call
+    syntax_fix_cache = SyntaxFixCache(syntax_analyzer.analyze_code, path=fix_cache)
+    syntax_fix_generator = SyntaxFixGenerator(llm_client, fix_cache=syntax_fix_cache)
     
     # Results containers
     valid_files = []
@@ -125,65 +162,73 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
     
     # ── File-by-File Syntax Flow ──────────────────────────────
     if analysis_mode in ['full', 'syntax']:
-        for idx, file_path in enumerate(files, 1):
-            # 1. DETECT — scan this file
-            is_valid, errors = syntax_analyzer.analyze_file(file_path)
+        try:
+            with dashboard.phase("Syntax check", total=len(files)):
+                for idx, file_path in enumerate(files, 1):
+                    # 1. DETECT — scan this file
+                    is_valid, errors = syntax_analyzer.analyze_file(file_path)
             
-            if is_valid:
-                valid_files.append(file_path)
-                console.print(f"  [green]✅ {idx}/{len(files)} {file_path.name}[/green]")
-                continue
+                    if is_valid:
+                        valid_files.append(file_path)
+                        dashboard.log(f"  [green]✅ {idx}/{len(files)} {file_path.name}[/green]")
+                        dashboard.advance(files=1)
+                        continue
             
-            # Store errors for the report
-            syntax_errors[str(file_path)] = [
-                {"line": e.line, "column": e.column, "message": e.message, "parser": e.parser}
-                for e in errors
-            ]
+                    # Store errors for the report
+                    syntax_errors[str(file_path)] = [
+                        {"line": e.line, "column": e.column, "message": e.message, "parser": e.parser}
+                        for e in errors
+                    ]
+                    dashboard.advance(files=1)
             
-            # 2. SHOW — display errors with code snippet
-            console.print(f"\n[bold]{file_path.name}[/bold]  ({idx}/{len(files)})")
+                    # Errors are shown and fixed interactively: hold the live display meanwhile
+                    with dashboard.paused():
+                        # 2. SHOW — display errors with code snippet
+                        console.print(f"\n[bold]{file_path.name}[/bold]  ({idx}/{len(files)})")
             
-            for err in errors:
-                console.print(f"  [red]Line {err.line}, Col {err.column}:[/red] {err.message} [{err.parser}]")
-            console.print()
+                        for err in errors:
+                            console.print(f"  [red]Line {err.line}, Col {err.column}:[/red] {err.message} [{err.parser}]")
+                        console.print()
             
-            # 3. FIXING LOOP — if fixes are enabled
-            if not generate_fixes:
-                console.print("[yellow]Fixes disabled (--no-fixes). Skipping.[/yellow]\n")
-                continue
+                        # 3. FIXING LOOP — if fixes are enabled
+                        if not generate_fixes:
+                            console.print("[yellow]Fixes disabled (--no-fixes). Skipping.[/yellow]\n")
+                            continue
             
-            # Interactive fix loop: stay on this file until clean or user skips
-            while True:
-                # Re-read and re-parse from disk
-                current_valid, current_errors = syntax_analyzer.analyze_file(file_path)
+                        # Interactive fix loop: stay on this file until clean or user skips
+                        while True:
+                            # Re-read and re-parse from disk
+                            current_valid, current_errors = syntax_analyzer.analyze_file(file_path)
                 
-                if current_valid:
-                    applied_fixes[str(file_path)] = True
-                    valid_files.append(file_path)
-                    console.print(f"\n  [bold green]✅ {file_path.name} — all syntax errors fixed![/bold green]\n")
-                    input("  Press Enter to continue to the next file...")
-                    break
+                            if current_valid:
+                                applied_fixes[str(file_path)] = True
+                                valid_files.append(file_path)
+                                console.print(f"\n  [bold green]✅ {file_path.name} — all syntax errors fixed![/bold green]\n")
+                                input("  Press Enter to continue to the next file...")
+                                break
                 
-                # Read current code
-                with open(file_path, 'r', encoding='utf-8') as f:
-                    current_code = f.read()
+                            # Read current code
+                            with open(file_path, 'r', encoding='utf-8') as f:
+                                current_code = f.read()
                 
-                # 4. SUGGEST — LLM generates fix (shown as suggestion)
-                fix_result = await syntax_fix_generator.fix_file_manual_assist(
-                    file_path,
-                    current_code,
-                    current_errors
-                )
+                            # 4. SUGGEST — LLM generates fix (shown as suggestion)
+                            fix_result = await syntax_fix_generator.fix_file_manual_assist(
+                                file_path,
+                                current_code,
+                                current_errors
+                            )
                 
-                fixes_made = fix_result.get('fixes_presented', 0)
+                            fixes_made = fix_result.get('fixes_presented', 0)
                 
-                if fixes_made > 0:
-                    # 5. VERIFY — re-parse after user edits
-                    console.print(f"\n  [cyan]🔄 Re-checking {file_path.name}...[/cyan]")
-                else:
-                    console.print(f"\n  [yellow]⏩ Skipping {file_path.name}.[/yellow]\n")
-                    break
-        
+                            if fixes_made > 0:
+                                # 5. VERIFY — re-parse after user edits
+                                console.print(f"\n  [cyan]🔄 Re-checking {file_path.name}...[/cyan]")
+                            else:
+                                console.print(f"\n  [yellow]⏩ Skipping {file_path.name}.[/yellow]\n")
+                                break
+        finally:
+            syntax_fix_cache.save()  # once per run, also when the user quits mid-phase
+
         # Summary
         console.print(f"\n{'─'*50}")
         console.print(f"  [bold]Syntax Check Summary[/bold]")
@@ -192,6 +237,10 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
             console.print(f"  ✗ {len(syntax_errors)} files had errors")
         if applied_fixes:
             console.print(f"  ✅ {len(applied_fixes)} files fixed")
+        cache_stats = syntax_fix_cache.stats
+        if cache_stats["hits"]:
+            console.print(f"  ⚡ {cache_stats['hits'] - cache_stats['rejected']} fix(es) reused from cache "
+                          f"({cache_stats['rejected']} stale)")
         console.print(f"{'─'*50}\n")
     else:
         # Non-syntax modes: just silently classify files
@@ -206,44 +255,30 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
     circular_deps = []
     dead_code_data = {}
     symbol_table = None
-    parsed_files = {}
     struct_results = None
     
-    if analysis_mode in ['full', 'structural', 'redundancy', 'semantic']:
+    if analysis_mode in ['full', 'structural', 'redundancy', 'semantic', 'performance']:
         if analysis_mode == 'structural':
             console.print("\n[bold blue]Phase 4: Structural Analysis[/bold blue]")
         
         console.print("Building symbol table & call graph...")
         from analyzers.structural_analyzer import StructuralAnalyzer
         
-        struct_analyzer = StructuralAnalyzer()
+        parse_store = None
+        if max_memory:
+            from core.parse_store import ParseStore
+            parse_store = ParseStore(max_memory * 1024 * 1024)
+            console.print(f"  [dim]Spilling parse results to {parse_store.directory} "
+                          f"(≤ {max_memory} MB cached in memory)[/dim]")
+        struct_analyzer = StructuralAnalyzer(compile_db=compile_db, parse_store=parse_store)
         analysis_files = valid_files if valid_files else files
-        struct_results = struct_analyzer.analyze_codebase(analysis_files)
+        with dashboard.phase("Structural analysis", total=len(analysis_files)):
+            struct_results = struct_analyzer.analyze_codebase(analysis_files, progress=dashboard)
         
         symbol_table = struct_results["symbol_table_object"]
         circular_deps = struct_results["circular_dependencies"]
         dead_code_data = struct_results["dead_code"]
         
-        # Reconstruct parsed_files for compatibility with Semantic Phase
-        for file_path_str, data in struct_results["raw_data"].items():
-            fpath = Path(file_path_str)
-            module_name = fpath.stem
-            
-            cg_functions = []
-            for f in data.get("functions", []):
-                 prefix = f"{f['parent_class']}." if f.get("parent_class") else ""
-                 cg_functions.append({
-                     "qualified_name": f"{module_name}.{prefix}{f['name']}",
-                     "calls": f.get("calls", [])
-                 })
-            
-            
-            parsed_files[fpath] = {
-                "functions": cg_functions,
-                "calls": data.get("calls", []),
-                "imports": data.get("imports", [])
-            }
-            
         dead_code_symbols = dead_code_data
         console.print(f"✓ Symbol table built ({len(symbol_table.symbols)} symbols indexed)\n")
     
@@ -325,6 +360,29 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
             console.print("  [green]✓ No circular imports detected.[/green]\n")
         console.print()
     
+    # Phase 6: Performance Audit (static rule packs over the resolved call graph)
+    if analysis_mode in ['full', 'performance'] and struct_results:
+        console.print("\n[bold blue]═══ Performance Audit ═══[/bold blue]\n")
+        from analyzers.performance_audit import PerformanceAudit
+        perf_findings = PerformanceAudit(struct_analyzer).run()
+        severity_style = {"high": "red", "medium": "yellow", "low": "dim"}
+        by_file = {}
+        for finding in perf_findings:
+            by_file.setdefault(finding.file, []).append(finding)
+        for file_path, file_findings in sorted(by_file.items(), key=lambda kv: -max(f.priority for f in kv[1])):
+            console.print(f"  [bold cyan]📄 {Path(file_path).name}[/bold cyan]")
+            for finding in file_findings:
+                style = severity_style.get(finding.severity, "white")
+                where = f" in {finding.function.split('.')[-1]}()" if finding.function else ""
+                console.print(f"    • [{style}]{finding.severity.upper()}[/{style}] [bold]{finding.rule}[/bold] "
+                              f"(line {finding.line}{where}): {finding.message}")
+                console.print(f"      💡 [cyan]{finding.suggestion}[/cyan]")
+            console.print()
+        if perf_findings:
+            console.print(f"  [dim]Total: {len(perf_findings)} performance finding(s)[/dim]\n")
+        else:
+            console.print("  [green]✓ No performance issues detected.[/green]\n")
+
     # Phase 3: Semantic Bug Detection
     if analysis_mode in ['full', 'semantic']:
         console.print("\n[bold magenta]═══ Phase 3: Semantic Bug Detection ═══[/bold magenta]\n")
@@ -343,239 +401,276 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
         
         # Ensure helper objects are ready
         fix_gen = FixGenerator(llm_client)
+        from utils.context_builder import ContextBuilder
+        context_builder = ContextBuilder(llm_client)
+
+        async def fallback_fix(bugs, code, file_ctx):
+            """One fix for all of a symbol's bugs when the audit returned no corrected code; reuses the
+            file's precomputed imports/globals context."""
+            if not generate_fixes or not code:
+                return None
+            fix = await fix_gen.generate_fix(
+                bug_type=", ".join(sorted({b.type for b in bugs})), severity=bugs[0].severity,
+                file_path=file_ctx.file_path, line=bugs[0].line, code_snippet=code, language=file_ctx.language,
+                description=" ".join(f"({i}) {b.description}" for i, b in enumerate(bugs, 1)),
+                suggestion=" ".join(f"({i}) {b.suggestion}" for i, b in enumerate(bugs, 1)),
+                file_context=file_ctx)
+            return fix.fixed_code if fix else None
+
+        from analyzers.fix_verifier import FixVerifier
+        from rich.markup import escape
+        fix_verifier = FixVerifier() if verify_fixes else None
         if 'struct_analyzer' not in locals():
             from analyzers.structural_analyzer import StructuralAnalyzer
-            struct_analyzer = StructuralAnalyzer()
+            struct_analyzer = StructuralAnalyzer(compile_db=compile_db)
+
+        def next_or_skip():
+            """Wait for the user after a finding; the dashboard is held while prompting."""
+            with dashboard.paused():
+                return Prompt.ask("\n[bold]Next [[white]Enter[/white]=Next, [white]s[/white]=Skip File][/bold]", choices=["", "s"], default="")
 
         # Iterate through files interactively
         analysis_queue = valid_files if valid_files else files
         
-        for file_idx, file_path in enumerate(analysis_queue, 1):
-            if file_path.name in ['.gitignore', 'requirements.txt']: continue
+        with dashboard.phase("Semantic analysis", total=len(analysis_queue)):
+            for file_idx, file_path in enumerate(analysis_queue, 1):
+                try:
+                    if file_path.name in ['.gitignore', 'requirements.txt']: continue
             
-            console.print(f"\n[bold cyan]Analyzing File {file_idx}/{len(analysis_queue)}: {file_path.name}[/bold cyan]")
+                    dashboard.log(f"[bold cyan]Analyzing File {file_idx}/{len(analysis_queue)}: {file_path.name}[/bold cyan]")
             
-            try:
-                with open(file_path, 'r', encoding='utf-8') as f:
-                    code = f.read()
-            except Exception as e:
-                console.print(f"[red]Error reading {file_path.name}: {e}[/red]")
-                continue
+                    try:
+                        with open(file_path, 'r', encoding='utf-8') as f:
+                            code = f.read()
+                    except Exception as e:
+                        dashboard.error(f"Error reading {file_path.name}: {e}")
+                        continue
 
-            # Parse file once per session
-            parse_result = struct_analyzer.parser.parse(code, file_path)
-            functions = parse_result.get("functions", [])
-            
-            # Context extraction
-            imports_str = ""
-            global_vars_str = ""
-            parsed_imports = parse_result.get("imports", [])
-            if parsed_imports:
-                imp_lines = []
-                for imp in parsed_imports:
-                    if isinstance(imp, dict):
-                        mod = imp.get("module", "")
-                        nms = imp.get("names", [])
-                        if nms: imp_lines.append(f"from {mod} import {', '.join(nms)}")
-                        elif mod: imp_lines.append(mod)
-                    else: imp_lines.append(str(imp))
-                imports_str = "\n".join(imp_lines)
+                    # Parse file once per session
+                    parse_result = struct_analyzer.parser.parse(code, file_path)
+                    functions = parse_result.get("functions", [])
             
-            parsed_globals = parse_result.get("global_vars", [])
-            if parsed_globals:
-                global_vars_str = "\n".join(parsed_globals)
-            
-            language = lang_map.get(file_path.suffix, 'python')
-            skip_file = False
-
-            # 1. Globals Analysis
-            if global_vars_str:
-                global_bugs, global_fix = await bug_detector.analyze_symbol(
-                    "Global Variables", global_vars_str, language, file_path,
-                    class_context="", dependency_hints="", 
-                    global_vars="", imports_list=imports_str
-                )
-                global_priority_bugs = [b for b in global_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
-                if global_priority_bugs:
-                     console.print("\n" + "─"*50)
-                     console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Global Variables[/cyan]")
+                    language = lang_map.get(file_path.suffix, 'python')
+                    if compile_db and language in ('c', 'cpp'):
+                        language = compile_db.language_for(file_path) or language
+                    skip_file = False
+
+                    # Context extraction (once per file, shared by every symbol below)
+                    file_ctx = await context_builder.build(file_path, parse_result, language)
+                    module_ctx = file_ctx.module_context(ContextBuilder.MODULE_TOKEN_BUDGET)
+                    imports_str = module_ctx["imports_list"]
+                    global_vars_str = file_ctx.globals_block
+
+                    # 1. Globals Analysis
+                    if global_vars_str:
+                        global_bugs, global_fix = await bug_detector.analyze_symbol(
+                            "Global Variables", global_vars_str, language, file_path,
+                            class_context="", dependency_hints="", 
+                            global_vars="", imports_list=imports_str
+                        )
+                        global_priority_bugs = [b for b in global_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
+                        if global_priority_bugs:
+                             console.print("\n" + "─"*50)
+                             console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Global Variables[/cyan]")
                      
-                     for i, bug in enumerate(global_priority_bugs, 1):
-                         console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
-                         console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
+                             for i, bug in enumerate(global_priority_bugs, 1):
+                                 console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
+                                 console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
                      
-                     # Show ONE integrated AI code patch for globals
-                     if global_fix and global_fix.strip():
-                        console.print(Panel(
-                            Syntax(global_fix, language, theme="monokai", line_numbers=True),
-                            title=f"[bold blue]UNIFIED FIX for Global Variables[/bold blue]", 
-                            border_style="blue"
-                        ))
-                     else:
-                        console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
+                             # Show ONE integrated AI code patch for globals
+                             if global_fix and global_fix.strip():
+                                console.print(Panel(
+                                    Syntax(global_fix, language, theme="monokai", line_numbers=True),
+                                    title=f"[bold blue]UNIFIED FIX for Global Variables[/bold blue]", 
+                                    border_style="blue"
+                                ))
+                             else:
+                                console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
                     
-                     action = Prompt.ask("\n[bold]Next [[white]Enter[/white]=Next, [white]s[/white]=Skip File][/bold]", choices=["", "s"], default="")
-                     if action == "s":
-                         continue
-                else:
-                    console.print(f"  [green]✓ No major bugs found in Global Variables.[/green]")
+                             action = next_or_skip()
+                             if action == "s":
+                                 continue
+                        else:
+                            dashboard.log(f"  [green]✓ No major bugs found in Global Variables.[/green]")
 
-            # 2. Global Code Analysis (Fallback for top-level code)
-            significant_top_level = False
-            if parse_result.get("calls") and len(parse_result.get("calls", [])) > 0:
-                significant_top_level = True
+                    # 2. Global Code Analysis (Fallback for top-level code)
+                    significant_top_level = False
+                    if parse_result.get("calls") and len(parse_result.get("calls", [])) > 0:
+                        significant_top_level = True
             
-            if significant_top_level:
-                console.print(f"  [dim]Auditing: Global/Top-level Code...[/dim]")
-                file_bugs, file_corrected_code = await bug_detector.analyze_code(file_path, code, language)
-                filter_file_bugs = [b for b in file_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
+                    if significant_top_level:
+                        dashboard.log(f"  [dim]Auditing: Global/Top-level Code...[/dim]")
+                        file_bugs, file_corrected_code = await bug_detector.analyze_code(file_path, code, language)
+                        filter_file_bugs = [b for b in file_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
                 
-                if filter_file_bugs:
-                    console.print("\n" + "─"*50)
-                    console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Global Code[/cyan]")
+                        if filter_file_bugs:
+                            console.print("\n" + "─"*50)
+                            console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Global Code[/cyan]")
                     
-                    for i, bug in enumerate(filter_file_bugs, 1):
-                        console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
-                        console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
+                            for i, bug in enumerate(filter_file_bugs, 1):
+                                console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
+                                console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
                     
-                    if file_corrected_code:
-                        console.print(Panel(
-                            Syntax(file_corrected_code, language, theme="monokai", line_numbers=True),
-                            title=f"[bold blue]UNIFIED FIX for Global Code[/bold blue]", 
-                            border_style="blue"
-                        ))
-                    else:
-                        console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
+                            if file_corrected_code:
+                                console.print(Panel(
+                                    Syntax(file_corrected_code, language, theme="monokai", line_numbers=True),
+                                    title=f"[bold blue]UNIFIED FIX for Global Code[/bold blue]", 
+                                    border_style="blue"
+                                ))
+                            else:
+                                console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
                     
-                    action = Prompt.ask("\n[bold]Next [[white]Enter[/white]=Next, [white]s[/white]=Skip File][/bold]", choices=["", "s"], default="")
-                    if action == "s":
-                        continue
-                else:
-                    console.print(f"  [green]✓ No major bugs found in Global Code.[/green]")
+                            action = next_or_skip()
+                            if action == "s":
+                                continue
+                        else:
+                            dashboard.log(f"  [green]✓ No major bugs found in Global Code.[/green]")
 
-            # 2. Sequential Function Analysis
-            for target_func in functions:
-                sym_name = target_func['name']
+                    # 2. Sequential Function Analysis
+                    for target_func in functions:
+                        sym_name = target_func['name']
                 
-                # Build Context (Identical logic as before)
-                class_ctx = ""
-                if target_func.get("parent_class"):
-                    cls_name = target_func["parent_class"]
-                    cls_data = next((c for c in parse_result.get("classes", []) if c["name"] == cls_name), None)
-                    if cls_data:
-                        skel = [f"class {cls_name} {{"]
-                        if cls_data.get("attributes"):
-                            for a in cls_data["attributes"]: skel.append(f"    {a};")
-                        skel.append(f"    // ... other methods ...")
-                        skel.append(f"    // === TARGET: {sym_name} ===")
-                        for l in target_func["body_code"].splitlines():
-                            skel.append(f"    {l}")
-                        skel.append("}")
-                        class_ctx = "\n".join(skel)
-
-                dep_hints = ""
-                if target_func.get("calls"):
-                    dep_hints += "Functions this calls: " + ", ".join(target_func["calls"]) + "\n"
-
-                # LLM Analysis
-                console.print(f"  [dim]Auditing: {sym_name}...[/dim]")
-                bugs, corrected_code = await bug_detector.analyze_symbol(
-                    sym_name, target_func["body_code"], language, file_path,
-                    class_context=class_ctx, dependency_hints=dep_hints,
-                    global_vars=global_vars_str, imports_list=imports_str
-                )
+                        class_ctx = file_ctx.class_context(target_func)
+
+                        dep_hints = ""
+                        if target_func.get("calls"):
+                            dep_hints += "Functions this calls: " + ", ".join(target_func["calls"]) + "\n"
+
+                        # LLM Analysis
+                        dashboard.log(f"  [dim]Auditing: {sym_name}...[/dim]")
+                        dashboard.advance(done=0, symbols=1)
+                        bugs, corrected_code = await bug_detector.analyze_symbol(
+                            sym_name, target_func["body_code"], language, file_path,
+                            class_context=class_ctx, dependency_hints=dep_hints,
+                            **module_ctx
+                        )
                 
-                priority_bugs = [b for b in bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
+                        priority_bugs = [b for b in bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
                 
-                if priority_bugs:
-                    console.print("\n" + "─"*50)
-                    console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]{sym_name}[/cyan]")
-                    
-                    for i, bug in enumerate(priority_bugs, 1):
-                        console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
-                        console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
+                        if priority_bugs:
+                            console.print("\n" + "─"*50)
+                            console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]{sym_name}[/cyan]")
                     
-                    # Show ONE integrated AI code patch for the whole function
-                    if corrected_code:
-                        console.print(Panel(
-                            Syntax(corrected_code, language, theme="monokai", line_numbers=True),
-                            title=f"[bold blue]UNIFIED FIX for {sym_name}[/bold blue]", 
-                            border_style="blue"
-                        ))
-                    else:
-                        console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
-                else:
-                    console.print(f"  [green]✓ No major bugs found in {sym_name}.[/green]")
+                            for i, bug in enumerate(priority_bugs, 1):
+                                console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
+                                console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
                     
-                action = Prompt.ask("\n[bold]Next [[white]Enter[/white]=Next, [white]s[/white]=Skip File][/bold]", choices=["", "s"], default="")
-                if action == "s":
-                    skip_file = True
-                    break
+                            if not corrected_code:
+                                corrected_code = await fallback_fix(priority_bugs, target_func["body_code"], file_ctx)
+
+                            # Performance claims get evidence: differential test + benchmark in a sandbox
+                            verdict = None
+                            if corrected_code and fix_verifier and any(b.type == "performance" for b in priority_bugs):
+                                dashboard.log(f"  [dim]Verifying performance fix for {sym_name}...[/dim]")
+                                verdict = await asyncio.to_thread(
+                                    fix_verifier.verify, target_func["body_code"], corrected_code, sym_name,
+                                    language, file_path, target_func.get("parent_class"))
+                                color = {"equivalent": "green", "different": "red", "error": "yellow"}.get(verdict.status, "dim")
+                                if verdict.status == "equivalent" and verdict.speedup is not None and verdict.speedup < 1:
+                                    color = "yellow"
+                                console.print(f"\n[{color}]   Fix check:[/{color}] {escape(verdict.summary())}")
+
+                            # Show ONE integrated AI code patch for the whole function
+                            if corrected_code:
+                                console.print(Panel(
+                                    Syntax(corrected_code, language, theme="monokai", line_numbers=True),
+                                    title=f"[bold blue]UNIFIED FIX for {sym_name}[/bold blue]", 
+                                    subtitle=f"[dim]{escape(verdict.summary())}[/dim]" if verdict else None,
+                                    border_style="blue"
+                                ))
+                            else:
+                                console.print(f"\n  [dim]No code patch generated for these issues.[/dim]")
+
+                            if next_or_skip() == "s":
+                                skip_file = True
+                                break
+                        else:
+                            dashboard.log(f"  [green]✓ No major bugs found in {sym_name}.[/green]")
             
-            if skip_file:
-                continue
+                    if skip_file:
+                        continue
 
-            # 3. Method-less Class Analysis (Data classes, etc.)
-            parsed_classes = parse_result.get("classes", [])
-            for cls in parsed_classes:
-                # Only analyze if it has NO methods (methods are handled in the function loop)
-                if cls["methods"]:
-                    continue
+                    # 3. Method-less Class Analysis (Data classes, etc.)
+                    parsed_classes = parse_result.get("classes", [])
+                    for cls in parsed_classes:
+                        # Only analyze if it has NO methods (methods are handled in the function loop)
+                        if cls["methods"]:
+                            continue
                 
-                cls_name = cls["name"]
-                console.print(f"  [dim]Auditing Class: {cls_name}...[/dim]")
+                        cls_name = cls["name"]
+                        dashboard.log(f"  [dim]Auditing Class: {cls_name}...[/dim]")
+                        dashboard.advance(done=0, symbols=1)
                 
-                # Context for Class:
-                # - Imports (already extracted)
-                # - Globals (already extracted)
-                # - Bases (inheritance)
-                bases_str = ""
-                if cls.get("bases"):
-                    bases_str = f"Inherits from: {', '.join(cls['bases'])}\n"
+                        # Context for Class:
+                        # - Imports (already extracted)
+                        # - Globals (already extracted)
+                        # - Bases (inheritance)
+                        bases_str = ""
+                        if cls.get("bases"):
+                            bases_str = f"Inherits from: {', '.join(cls['bases'])}\n"
                 
-                class_bugs, corrected_code = await bug_detector.analyze_symbol(
-                    cls_name, 
-                    cls.get("body_code", ""), 
-                    language, 
-                    file_path,
-                    class_context="", # It IS the class
-                    dependency_hints=bases_str,
-                    global_vars=global_vars_str,
-                    imports_list=imports_str
-                )
+                        class_bugs, corrected_code = await bug_detector.analyze_symbol(
+                            cls_name, 
+                            cls.get("body_code", ""), 
+                            language, 
+                            file_path,
+                            class_context="", # It IS the class
+                            dependency_hints=bases_str,
+                            **module_ctx
+                        )
                 
-                cls_priority_bugs = [b for b in class_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
+                        cls_priority_bugs = [b for b in class_bugs if b.severity.lower() in ['critical', 'high', 'medium', 'low']]
                 
-                if cls_priority_bugs:
-                     console.print("\n" + "─"*50)
-                     console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Class {cls_name}[/cyan]")
+                        if cls_priority_bugs:
+                             console.print("\n" + "─"*50)
+                             console.print(f"[bold red]BUGS DETECTED[/bold red] in [cyan]Class {cls_name}[/cyan]")
                      
-                     for i, bug in enumerate(cls_priority_bugs, 1):
-                         console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
-                         console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
+                             for i, bug in enumerate(cls_priority_bugs, 1):
+                                 console.print(f"\n[bold]{i}. Issue:[/bold] {bug.description}")
+                                 console.print(f"[green]   Suggestion:[/green] {bug.suggestion}")
                      
-                     if corrected_code:
-                        console.print(Panel(Syntax(corrected_code, language, theme="monokai", line_numbers=True), title=f"UNIFIED FIX for Class {cls_name}", border_style="blue"))
-                     else:
-                        console.print(f"  [dim]No code patch generated for these issues.[/dim]")
+                             if not corrected_code:
+                                 corrected_code = await fallback_fix(cls_priority_bugs, cls.get("body_code", ""), file_ctx)
+                             if corrected_code:
+                                console.print(Panel(Syntax(corrected_code, language, theme="monokai", line_numbers=True), title=f"UNIFIED FIX for Class {cls_name}", border_style="blue"))
+                             else:
+                                console.print(f"  [dim]No code patch generated for these issues.[/dim]")
                      
-                     action = Prompt.ask("\n[bold]Next [[white]Enter[/white]=Next, [white]s[/white]=Skip File][/bold]", choices=["", "s"], default="")
-                     if action == "s":
-                         skip_file = True
-                         break
-                else:
-                    console.print(f"  [green]✓ No major bugs found in Class {cls_name}.[/green]")
+                             action = next_or_skip()
+                             if action == "s":
+                                 skip_file = True
+                                 break
+                        else:
+                            dashboard.log(f"  [green]✓ No major bugs found in Class {cls_name}.[/green]")
             
-            if skip_file:
-                continue
+                    if skip_file:
+                        continue
+                finally:
+                    dashboard.advance(files=1)
         console.print("[bold green]Semantic Analysis Complete.[/bold green]")
     # Phase 5: Redundancy Detection
     duplicates = []
     if analysis_mode in ['full', 'redundancy']:
         console.print("\n[bold blue]Phase 5: Cross-file Redundancy Detection[/bold blue]")
         if symbol_table:
-            redundancy_detector = CrossFileRedundancyDetector(symbol_table, llm_client)
-            duplicates = await redundancy_detector.detect_duplicates(console=console)
+            index = None
+            if clone_index:
+                from analyzers.clone_index import CloneIndex
+                index = CloneIndex(clone_index)
+            thresholds = None
+            config_path = redundancy_config or folder / "redundancy_thresholds.json"
+            if config_path.exists():
+                thresholds = CrossFileRedundancyDetector.load_thresholds(config_path)
+                console.print(f"  [dim]Using calibrated thresholds from {config_path}[/dim]")
+            redundancy_detector = CrossFileRedundancyDetector(
+                symbol_table, llm_client,
+                clone_index=index, repo_name=repo_name or folder.resolve().name,
+                thresholds=thresholds
+            )
+            with dashboard.phase("Redundancy", unit="pairs"):
+                duplicates = await redundancy_detector.detect_duplicates(console=console, progress=dashboard)
+            if index:
+                index.close()
             
             console.print(f"\n[bold yellow]═══ Redundant / Duplicate Functions ═══[/bold yellow]\n")
             
@@ -596,12 +691,267 @@ async def run_analysis(folder: Path, output: Path, vllm_url: str, generate_fixes
                 console.print(f"  [dim]Total: {len(duplicates)} duplicate pair(s) found[/dim]\n")
             else:
                 console.print("  [green]✓ No redundant or duplicate functions detected.[/green]\n")
+            stats = redundancy_detector.stats
+            if stats:
+                console.print(f"  [dim]Tree edit distance: {stats['ted_duplicate']} accepted, "
+                              f"{stats['ted_distinct']} rejected, {stats['ted_ambiguous']} escalated "
+                              f"({stats['llm_verifications']} LLM call(s))[/dim]\n")
         else:
             console.print("[red]  ✗ Redundancy detection requires structural analysis first. Skipping.[/red]\n")
+
+    if struct_results and hasattr(struct_analyzer.file_data_map, "close"):
+        stats = struct_analyzer.file_data_map.stats
+        console.print(f"[dim]Parse store: {stats['spilled_bytes'] / 1e6:.1f} MB spilled, "
+                      f"{stats['column_reads']} column reads, {stats['cache_hits']} cache hits[/dim]")
+        struct_analyzer.file_data_map.close()
+    await llm_client.close()
+    dashboard.close()
     
 
 
 
+@app.command()
+def history(
+    repo: Path = typer.Argument(..., help="Git repository to analyze"),
+    commits: int = typer.Option(20, "--commits", "-n", help="Number of most recent commits to walk"),
+    rev: str = typer.Option("HEAD", "--rev", help="Revision to walk back from"),
+    output: Path = typer.Option("history.json", "--output", "-o", help="Time series output path"),
+    cache: Path = typer.Option(None, "--cache", help="On-disk blob cache reused across runs"),
+):
+    """
+    Trend dead code, cycles, duplicates and static findings across recent commits.
+    """
+    from analyzers.history_analyzer import HistoryAnalyzer
+
+    if not (repo / ".git").exists():
+        console.print(f"[red]Error: {repo} is not a git repository[/red]")
+        raise typer.Exit(1)
+
+    console.print(f"\n[bold blue]📈 History Analysis:[/bold blue] {repo} (last {commits} commits of {rev})\n")
+    analyzer = HistoryAnalyzer(repo, cache_path=cache)
+
+    table = Table(title="Per-Commit Trends")
+    for col in ["Commit", "Files", "Functions", "Dead", "Cycles", "Dup Groups", "Static", "Reparsed"]:
+        table.add_column(col, justify="right" if col != "Commit" else "left")
+
+    def on_commit(point):
+        console.print(f"  [dim]{point['commit'][:10]} {point['subject'][:60]} "
+                      f"({point['changed_files']} changed, {point['reparsed_blobs']} reparsed)[/dim]")
+
+    try:
+        series = analyzer.run(commits, rev, progress=on_commit)
+    except RuntimeError as e:
+        console.print(f"[red]Error: {e}[/red]")
+        raise typer.Exit(1)
+
+    for point in series:
+        table.add_row(
+            point["commit"][:10], str(point["files"]), str(point["functions"]),
+            str(point["dead_code"]), str(point["function_cycles"]),
+            str(point["duplicate_groups"]), str(point["static_findings"]),
+            str(point["reparsed_blobs"]),
+        )
+    console.print()
+    console.print(table)
+
+    with open(output, 'w', encoding='utf-8') as f:
+        json.dump({"repository": str(repo), "rev": rev, "stats": analyzer.stats, "series": series}, f, indent=2)
+    console.print(f"\n[green]✅ Time series saved to: {output}[/green] "
+                  f"[dim]({analyzer.stats['blobs_parsed']} blobs parsed, "
+                  f"{analyzer.stats['blobs_reused']} reused)[/dim]")
+
+
+@app.command()
+def calibrate(
+    labels: Path = typer.Option(None, "--labels", "-l", help="Extra labelled pairs (JSON) on top of the built-in redundancy fixtures"),
+    output: Path = typer.Option("redundancy_thresholds.json", "--output", "-o", help="Thresholds config read by the duplicate detector"),
+    target_recall: float = typer.Option(1.0, "--target-recall", help="Minimum recall on labelled duplicates"),
+    no_builtin: bool = typer.Option(False, "--no-builtin", help="Only use the pairs from --labels"),
+):
+    """
+    Calibrate duplicate-detection thresholds: recall vs. number of LLM verifications.
+    """
+    from analyzers.redundancy_calibration import RedundancyCalibrator
+
+    calibrator = RedundancyCalibrator(target_recall=target_recall)
+    if not no_builtin:
+        calibrator.load_builtin()
+    if labels:
+        if not labels.exists():
+            console.print(f"[red]Error: {labels} does not exist[/red]")
+            raise typer.Exit(1)
+        calibrator.load_labels_file(labels)
+    if not any(p.is_duplicate for p in calibrator.pairs):
+        console.print("[red]Error: No labelled duplicate pairs to calibrate on[/red]")
+        raise typer.Exit(1)
+
+    result = calibrator.calibrate()
+    console.print(f"\n[bold blue]📐 Redundancy Calibration:[/bold blue] {result['functions']} functions, "
+                  f"{result['positives']} duplicate / {result['negatives']} distinct pairs "
+                  f"({result['labelled_pairs']} labelled)\n")
+
+    chosen, baseline = result["chosen"], result["baseline"]
+    console.print(f"[bold]Recall vs. LLM calls[/bold] [dim](AUTO_CONFIRM={chosen['AUTO_CONFIRM_THRESHOLD']}, "
+                  f"MIN_BODY_LINES={chosen['MIN_BODY_LINES']}, TED reject={chosen['TED_REJECT_SIMILARITY']})[/dim]")
+    for line in calibrator.render_curve(result["curve"], chosen):
+        console.print(f"  {line}", highlight=False)
+
+    table = Table(title="Thresholds")
+    for col in ["Setting", "AST", "Auto-confirm", "Min lines", "TED reject", "Recall", "LLM calls", "False accepts"]:
+        table.add_column(col, justify="left" if col == "Setting" else "right")
+    for label, r in (("Current defaults", baseline), ("Calibrated", chosen)):
+        table.add_row(
+            label, f"{r['AST_SIMILARITY_THRESHOLD']:.2f}", f"{r['AUTO_CONFIRM_THRESHOLD']:.2f}",
+            str(r["MIN_BODY_LINES"]), f"{r['TED_REJECT_SIMILARITY']:.2f}", f"{r['recall']:.0%}",
+            str(r["llm_calls"]), str(r["false_accepts"]),
+        )
+    console.print()
+    console.print(table)
+
+    calibrator.write_config(result, output)
+    console.print(f"\n[green]✅ Thresholds saved to: {output}[/green] "
+                  f"[dim](pass with --redundancy-config, or place in the analyzed folder)[/dim]")
+
+
+@app.command()
+def query(
+    folder: Path = typer.Argument(..., help="Folder to index"),
+    source: str = typer.Option(None, "--from", help="Calling function (name, Class.method or qualified name)"),
+    target: str = typer.Option(None, "--to", help="Called function"),
+    impact: Optional[List[str]] = typer.Option(None, "--impact", help="Changed function; repeat for several"),
+    compile_commands: Path = typer.Option(None, "--compile-commands", help="compile_commands.json scoping C/C++ analysis (auto-detected in FOLDER or FOLDER/build)"),
+):
+    """
+    Call-graph reachability: call chains, callers of a function, impact of a change.
+    """
+    from core.scanner import FileScanner
+    from core.compile_db import CompilationDatabase
+    from core.symbol_table import SymbolType
+    from analyzers.structural_analyzer import StructuralAnalyzer
+
+    if not folder.exists():
+        console.print(f"[red]Error: Folder {folder} does not exist[/red]")
+        raise typer.Exit(1)
+    if not (source or target or impact):
+        console.print("[red]Error: Give --from and/or --to, or --impact[/red]")
+        raise typer.Exit(1)
+
+    compile_db = CompilationDatabase(compile_commands, project_root=folder) if compile_commands \
+        else CompilationDatabase.discover(folder)
+    files = FileScanner(folder, compile_db=compile_db).scan()
+    structural = StructuralAnalyzer(compile_db=compile_db)
+    for file_path in files:
+        try:
+            code = file_path.read_text(encoding='utf-8')
+            structural.index_file(file_path, structural.parser.parse(code, file_path))
+        except Exception as e:
+            console.print(f"[yellow]Warning: Could not parse {file_path}: {e}[/yellow]")
+    structural.run_checks(unused_variables=False)
+    index = structural.reachability
+    console.print(f"[dim]{structural.call_graph.number_of_nodes()} functions, "
+                  f"{structural.call_graph.number_of_edges()} resolved calls[/dim]\n")
+
+    def resolve(name: str) -> List[str]:
+        matches = [q for q, sym in structural.symbol_table.symbols.items()
+                   if sym.type == SymbolType.FUNCTION and (q == name or q.endswith("." + name))]
+        if not matches:
+            console.print(f"[red]Error: No function named {name}[/red]")
+            raise typer.Exit(1)
+        return sorted(matches)
+
+    def show(title: str, names):
+        names = sorted(names)
+        console.print(f"[bold]{title}[/bold] ({len(names)})")
+        for name in names[:50]:
+            console.print(f"  {name}", highlight=False)
+        if len(names) > 50:
+            console.print(f"  [dim]... {len(names) - 50} more[/dim]")
+
+    if source and target:
+        for a in resolve(source):
+            for b in resolve(target):
+                chain = index.shortest_path(a, b)
+                if chain:
+                    console.print(f"[green]✓ {a} reaches {b}[/green]: {' → '.join(chain)}", highlight=False)
+                else:
+                    console.print(f"[yellow]✗ {b} is not reachable from {a}[/yellow]", highlight=False)
+    elif source:
+        for a in resolve(source):
+            show(f"Reachable from {a}", index.descendants(a))
+    elif target:
+        for b in resolve(target):
+            show(f"Entry points reaching {b}", index.entry_points_reaching(b) - {b})
+            show(f"All transitive callers of {b}", index.ancestors(b))
+
+    if impact:
+        changed = [q for name in impact for q in resolve(name)]
+        affected = index.impact_set(changed)
+        show("Impacted functions", affected - set(changed))
+        show("Impacted entry points", index.entry_points() & affected)
+
+
+@app.command()
+def export_graph(
+    folder: Path = typer.Argument(..., help="Folder to index"),
+    output: Path = typer.Option("callgraph.dot", "--output", "-o", help="Output file (.dot/.gv, .ndjson/.jsonl, .bin/.cgx)"),
+    graph: str = typer.Option("calls", "--graph", "-g", help="calls (function call graph) or imports (file import graph)"),
+    level: str = typer.Option("function", "--level", "-l", help="Level of detail: function, scc, file or directory"),
+    depth: int = typer.Option(None, "--depth", help="With --level directory: collapse to the first N path components"),
+    fmt: str = typer.Option(None, "--format", "-f", help="dot, ndjson or binary (default: from the output suffix)"),
+    cluster: str = typer.Option(None, "--cluster", help="DOT only: group nodes by directory (nested) or module"),
+    compile_commands: Path = typer.Option(None, "--compile-commands", help="compile_commands.json scoping C/C++ analysis (auto-detected in FOLDER or FOLDER/build)"),
+):
+    """
+    Export the call or import graph (DOT, NDJSON edge list or compact binary), optionally collapsed.
+    """
+    from core.scanner import FileScanner
+    from core.compile_db import CompilationDatabase
+    from analyzers.structural_analyzer import StructuralAnalyzer
+    from utils.graph_export import GraphExporter
+
+    if not folder.exists():
+        console.print(f"[red]Error: Folder {folder} does not exist[/red]")
+        raise typer.Exit(1)
+
+    compile_db = CompilationDatabase(compile_commands, project_root=folder) if compile_commands \
+        else CompilationDatabase.discover(folder)
+    files = FileScanner(folder, compile_db=compile_db).scan()
+    structural = StructuralAnalyzer(compile_db=compile_db)
+    for file_path in files:
+        try:
+            code = file_path.read_text(encoding='utf-8')
+            structural.index_file(file_path, structural.parser.parse(code, file_path))
+        except Exception as e:
+            console.print(f"[yellow]Warning: Could not parse {file_path}: {e}[/yellow]")
+    if graph == "calls":
+        structural.run_checks(unused_variables=False)  # resolves call edges
+
+    start = time.time()
+    try:
+        counts = GraphExporter(structural, folder).export(output, graph=graph, level=level, fmt=fmt,
+                                                          depth=depth, cluster=cluster)
+    except ValueError as e:
+        console.print(f"[red]Error: {e}[/red]")
+        raise typer.Exit(1)
+    console.print(f"[green]✅ {graph.title()} graph ({counts['level']}) saved to: {output}[/green] "
+                  f"[dim]({counts['nodes']} nodes, {counts['edges']} edges, {time.time() - start:.2f}s)[/dim]")
+
+
+@app.command()
+def lsp(
+    vllm_url: str = typer.Option(None, "--vllm-url", help="LLM server URL for background semantic audits (omit to disable)"),
+    debounce: float = typer.Option(2.0, "--debounce", help="Seconds a file must stay unchanged before its LLM audit starts"),
+    compile_commands: Path = typer.Option(None, "--compile-commands", help="compile_commands.json scoping C/C++ analysis (auto-detected in the workspace root or root/build)"),
+):
+    """
+    Language server over stdio: syntax, static and structural diagnostics as you edit.
+    """
+    from lsp.server import LanguageServer
+
+    # stdout carries the protocol: nothing may be printed to the console here
+    server = LanguageServer(llm_url=vllm_url, debounce=debounce, compile_commands=compile_commands)
+    raise typer.Exit(asyncio.run(server.serve()))
+
 
 if __name__ == "__main__":
     app()
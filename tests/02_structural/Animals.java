@@ -0,0 +1,42 @@
+// Expected call edges:
+//   Animal.describe -> Animal.sound, Dog.sound, Cat.sound   (virtual, implicit this)
+//   Animals.chorus  -> Animal.sound, Dog.sound, Cat.sound   (through an Animal reference)
+//   Animals.main    -> Animals.chorus, Names.parse          (static call)
+import java.util.List;
+
+abstract class Animal {
+    abstract String sound();
+
+    String describe(int times) {
+        return sound().repeat(times);
+    }
+}
+
+class Dog extends Animal {
+    String sound() { return "woof"; }
+}
+
+class Cat extends Animal {
+    String sound() { return "meow"; }
+}
+
+class Names {
+    static int parse(String text) {
+        return Integer.parseInt(text.trim());
+    }
+}
+
+public class Animals {
+    static String chorus(List<Animal> animals) {
+        StringBuilder out = new StringBuilder();
+        for (Animal animal : animals) {
+            out.append(animal.sound());
+        }
+        return out.toString();
+    }
+
+    public static void main(String[] args) {
+        String all = chorus(List.of(new Dog(), new Cat()));
+        System.out.println(all.repeat(Names.parse("2")));
+    }
+}
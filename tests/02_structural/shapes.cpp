@@ -0,0 +1,40 @@
+// Expected call edges:
+//   Shape::scaled        -> Shape::area, Circle::area, Square::area   (virtual, implicit this)
+//   geometry::total_area -> Shape::area, Circle::area, Square::area   (through a Shape*)
+//   main                 -> geometry::total_area, utils::parse        (std::sort adds none)
+// utils::parse is defined out of line; `namespace utils` is only opened in shapes.h.
+#include "shapes.h"
+#include <algorithm>
+
+double Shape::scaled(double k) const {
+    return area() * k;
+}
+
+double Circle::area() const {
+    return 3.14159 * r_ * r_;
+}
+
+int utils::parse(const char* text) {
+    int value = 0;
+    while (*text >= '0' && *text <= '9') {
+        value = value * 10 + (*text++ - '0');
+    }
+    return value;
+}
+
+namespace geometry {
+double total_area(const std::vector<Shape*>& shapes) {
+    double total = 0.0;
+    for (const Shape* shape : shapes) {
+        total += shape->area();
+    }
+    return total;
+}
+}
+
+int main() {
+    std::vector<Shape*> shapes{new Circle(1.0), new Square(2.0)};
+    std::sort(shapes.begin(), shapes.end());
+    double area = geometry::total_area(shapes);
+    return utils::parse("42") + static_cast<int>(area);
+}
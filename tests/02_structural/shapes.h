@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+
+class Shape {
+public:
+    virtual ~Shape() {}
+    virtual double area() const { return 0.0; }
+    double scaled(double k) const;
+};
+
+class Circle : public Shape {
+public:
+    explicit Circle(double r) : r_(r) {}
+    double area() const override;
+private:
+    double r_;
+};
+
+class Square : public Shape {
+public:
+    explicit Square(double side) : side_(side) {}
+    double area() const override { return side_ * side_; }
+private:
+    double side_;
+};
+
+namespace utils {
+int parse(const char* text);
+}
+
+namespace geometry {
+double total_area(const std::vector<Shape*>& shapes);
+}
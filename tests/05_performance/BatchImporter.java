@@ -0,0 +1,50 @@
+// Expected logging-cost findings:
+//   importAll  line 17  medium  log.debug() concatenates its message on every record, DEBUG is usually off
+//   summarize  line 27  low     log.info() builds its message with String.format() inside a loop
+// Not reported: `importGuarded` checks isDebugEnabled() first; `importParameterised` passes arguments.
+import java.util.List;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+public class BatchImporter {
+    private static final Logger log = LoggerFactory.getLogger(BatchImporter.class);
+
+    private int stored;
+
+    public void importAll(List<String> records) {
+        for (String record : records) {
+            store(record);
+            log.debug("stored record " + record + " total=" + stored);
+        }
+    }
+
+    public void summarize(List<List<String>> batches) {
+        int index = 0;
+        for (List<String> batch : batches) {
+            for (String record : batch) {
+                store(record);
+            }
+            log.info(String.format("batch %d: %d records", index++, batch.size()));
+        }
+    }
+
+    public void importGuarded(List<String> records) {
+        for (String record : records) {
+            store(record);
+            if (log.isDebugEnabled()) {
+                log.debug("stored record " + record);
+            }
+        }
+    }
+
+    public void importParameterised(List<String> records) {
+        for (String record : records) {
+            store(record);
+            log.debug("stored record {} total={}", record, stored);
+        }
+    }
+
+    private void store(String record) {
+        stored++;
+    }
+}
@@ -0,0 +1,26 @@
+// Expected regex-backtracking findings:
+//   (field)  line 8   high    USERNAME `^([a-zA-Z0-9]+\\s?)+$` nests quantifiers: exponential on "000...0!"
+//   fields   line 24  medium  split("\\s*,\\s*") re-scans runs of whitespace from every start: quadratic
+// Not reported: ISO_DATE and the validTag pattern have no ambiguous repetition.
+import java.util.regex.Pattern;
+
+public class InputValidator {
+    private static final Pattern USERNAME = Pattern.compile("^([a-zA-Z0-9]+\\s?)+$");
+    private static final Pattern ISO_DATE = Pattern.compile("^\\d{4}-\\d{2}-\\d{2}$");
+
+    public boolean validUsername(String name) {
+        return USERNAME.matcher(name).matches();
+    }
+
+    public boolean validDate(String date) {
+        return ISO_DATE.matcher(date).matches();
+    }
+
+    public boolean validTag(String tag) {
+        return tag.matches("[a-z]+-\\d+");
+    }
+
+    public String[] fields(String line) {
+        return line.split("\\s*,\\s*");
+    }
+}
@@ -0,0 +1,60 @@
+// Expected cpp-containers findings:
+//   count_words  line 17  low     std::map `counts` is only used for lookups, never iterated in order
+//   drain        line 28  high    `queue.erase(queue.begin())` inside a loop shifts the whole vector
+//   common_ids   line 36  medium  `std::find` over vector `known` inside a loop
+// Not reported: `sorted_counts` iterates its map in key order; `drain_all` clears once after the loop.
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Job {
+    int id;
+    void run() const {}
+};
+
+int count_words(const std::vector<std::string>& words, const std::string& needle) {
+    std::map<std::string, int> counts;
+    for (const auto& w : words) {
+        counts[w] += 1;
+    }
+    auto it = counts.find(needle);
+    return it == counts.end() ? 0 : it->second;
+}
+
+void drain(std::vector<Job>& queue) {
+    while (!queue.empty()) {
+        queue.front().run();
+        queue.erase(queue.begin());
+    }
+}
+
+std::vector<int> common_ids(const std::vector<int>& incoming, const std::vector<int>& seed) {
+    std::vector<int> known(seed);
+    std::vector<int> common;
+    for (int id : incoming) {
+        if (std::find(known.begin(), known.end(), id) != known.end()) {
+            common.push_back(id);
+        }
+    }
+    return common;
+}
+
+std::vector<std::string> sorted_counts(const std::vector<std::string>& words) {
+    std::map<std::string, int> counts;
+    for (const auto& w : words) {
+        counts[w] += 1;
+    }
+    std::vector<std::string> out;
+    for (const auto& entry : counts) {
+        out.push_back(entry.first);
+    }
+    return out;
+}
+
+void drain_all(std::vector<Job>& queue) {
+    for (const auto& job : queue) {
+        job.run();
+    }
+    queue.clear();
+}
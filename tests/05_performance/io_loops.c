@@ -0,0 +1,53 @@
+// Expected io-patterns findings:
+//   count_lines   line 15  medium  fgetc() one character at a time in a loop
+//   append_lines  line 25  medium  fopen("events.log") of the same path on every iteration
+//   send_bytes    line 33  high    write() of 1 byte per iteration is a system call each
+//   first_missing line 40  medium  stat() per candidate inside a loop
+// Not reported: `copy_blocks` moves 4096-byte blocks with fread/fwrite.
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+long count_lines(FILE *in) {
+    long lines = 0;
+    int ch;
+    while ((ch = fgetc(in)) != EOF) {
+        if (ch == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+void append_lines(const char **lines, int n) {
+    for (int i = 0; i < n; i++) {
+        FILE *out = fopen("events.log", "a");
+        fputs(lines[i], out);
+        fclose(out);
+    }
+}
+
+void send_bytes(int fd, const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        write(fd, &data[i], 1);
+    }
+}
+
+const char *first_missing(const char **paths, int n) {
+    struct stat st;
+    for (int i = 0; i < n; i++) {
+        if (stat(paths[i], &st) != 0) {
+            return paths[i];
+        }
+    }
+    return NULL;
+}
+
+void copy_blocks(FILE *in, FILE *out) {
+    char buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof buf, in)) > 0) {
+        fwrite(buf, 1, got, out);
+    }
+}
@@ -0,0 +1,136 @@
+"""
+Context Builder
+Per-file LLM context artifacts computed once and shared by every symbol.
+
+For each file the imports block, globals block and class skeleton prefixes
+are built a single time (with their token counts) and reused for all
+function/class audits and fix prompts of that file.
+"""
+
+import re
+import asyncio
+import hashlib
+from pathlib import Path
+from typing import Dict, Any, Optional
+
+
+class FileContext:
+    """Precomputed context for one parsed file."""
+
+    def __init__(self, file_path: Path, language: str):
+        self.file_path = file_path
+        self.language = language
+        self.imports_block = ""
+        self.globals_block = ""
+        self.class_prefixes: Dict[str, str] = {}   # class name -> skeleton up to the target marker
+        self.tokens: Dict[str, int] = {}           # "imports", "globals", "class:<name>"
+        self.exact_tokens = False                  # True when counted by the server tokenizer
+
+    @property
+    def module_block(self) -> str:
+        """Imports and globals together (the fix prompt's global context)."""
+        return "\n".join(part for part in (self.imports_block, self.globals_block) if part)
+
+    def class_context(self, func: Dict[str, Any]) -> str:
+        """Class skeleton with the target method's body, or "" for free functions."""
+        prefix = self.class_prefixes.get(func.get("parent_class") or "")
+        if not prefix:
+            return ""
+        skel = [prefix, f"    // === TARGET: {func['name']} ==="]
+        for line in func["body_code"].splitlines():
+            skel.append(f"    {line}")
+        skel.append("}")
+        return "\n".join(skel)
+
+    def module_context(self, max_tokens: Optional[int] = None) -> Dict[str, str]:
+        """
+        Keyword arguments for LLMBugDetector.analyze_symbol. With a budget,
+        globals are dropped before imports when the blocks do not fit.
+        """
+        imports, globals_ = self.imports_block, self.globals_block
+        if max_tokens is not None:
+            if self.tokens.get("imports", 0) + self.tokens.get("globals", 0) > max_tokens:
+                globals_ = ""
+            if self.tokens.get("imports", 0) > max_tokens:
+                imports = ""
+        return {"global_vars": globals_, "imports_list": imports}
+
+
+class ContextBuilder:
+    """
+    Builds and caches FileContext objects. Token counts come from the LLM
+    server's tokenizer when the client supports it, else from an estimate.
+    """
+
+    MODULE_TOKEN_BUDGET = 6000   # imports + globals allowance per prompt
+    _TOKEN_RE = re.compile(r"\w+|[^\w\s]")
+
+    def __init__(self, llm_client=None):
+        self.llm_client = llm_client
+        self._files: Dict[str, tuple] = {}       # path -> (parse result, FileContext)
+        self._token_cache: Dict[str, int] = {}   # md5(text) -> exact token count
+        self._exact = llm_client is not None and hasattr(llm_client, "count_tokens")
+
+    async def build(self, file_path: Path, parse_result: Dict[str, Any], language: str) -> FileContext:
+        cached = self._files.get(str(file_path))
+        if cached and cached[0] is parse_result:
+            return cached[1]
+
+        ctx = FileContext(file_path, language)
+        ctx.imports_block = self._imports_block(parse_result.get("imports", []))
+        ctx.globals_block = "\n".join(parse_result.get("global_vars", []))
+        for cls in parse_result.get("classes", []):
+            skel = [f"class {cls['name']} {{"]
+            for attr in cls.get("attributes", []):
+                skel.append(f"    {attr};")
+            skel.append("    // ... other methods ...")
+            ctx.class_prefixes[cls["name"]] = "\n".join(skel)
+
+        keys = ["imports", "globals"] + [f"class:{name}" for name in ctx.class_prefixes]
+        texts = [ctx.imports_block, ctx.globals_block] + list(ctx.class_prefixes.values())
+        counts = await asyncio.gather(*(self._count(text) for text in texts))
+        for key, (count, _) in zip(keys, counts):
+            ctx.tokens[key] = count
+        ctx.exact_tokens = all(exact for _, exact in counts)
+
+        self._files[str(file_path)] = (parse_result, ctx)
+        return ctx
+
+    async def count_tokens(self, text: str) -> int:
+        return (await self._count(text))[0]
+
+    async def _count(self, text: str):
+        """(count, exact). Only server counts are cached; estimates are retried next build."""
+        if not text:
+            return 0, self._exact
+        key = hashlib.md5(text.encode('utf-8', errors='replace')).hexdigest()
+        if key in self._token_cache:
+            return self._token_cache[key], True
+        if self._exact:
+            count = await self.llm_client.count_tokens(text)
+            if count is not None:
+                self._token_cache[key] = count
+                return count, True
+            if not getattr(self.llm_client, "tokenize_supported", True):
+                self._exact = False  # server has no tokenizer endpoint; stop asking
+        return self.estimate_tokens(text), False
+
+    @classmethod
+    def estimate_tokens(cls, text: str) -> int:
+        """Word/punctuation pieces; close to BPE counts for source code."""
+        return len(cls._TOKEN_RE.findall(text))
+
+    @staticmethod
+    def _imports_block(imports) -> str:
+        lines = []
+        for imp in imports:
+            if isinstance(imp, dict):
+                mod = imp.get("module", "")
+                names = imp.get("names", [])
+                if names:
+                    lines.append(f"from {mod} import {', '.join(names)}")
+                elif mod:
+                    lines.append(mod)
+            else:
+                lines.append(str(imp))
+        return "\n".join(lines)
@@ -0,0 +1,372 @@
+"""
+Graph Export
+Streams the call graph and the file import graph to DOT, NDJSON edge lists or
+a compact binary format, optionally collapsed to a coarser level of detail.
+
+Levels: `function` (call graph only), `scc` (each strongly connected
+component becomes one node), `file` and `directory` (`depth` keeps only the
+first N path components, so a whole package becomes one node). Collapsed edges
+carry a `weight` (number of underlying edges); edges inside one node are
+dropped and counted on the node as `internal`. Writers emit one line/record
+per node and edge as they go; only the collapsed graph, never the output, is
+held in memory.
+
+DOT output can be clustered by directory (nested `subgraph cluster_*` blocks
+following the path hierarchy) or by module (one cluster per file).
+
+Binary layout (all integers unsigned LEB128 varints, strings UTF-8 with a
+varint byte length):
+    b"CGX1" | path count | paths... | node count | (name, path index + 1 or 0,
+    size, internal)... | edge count | (source - previous source, target,
+    weight)...
+Edges are ordered by source index, so the source delta is never negative.
+"""
+
+import json
+from collections import Counter
+from pathlib import Path
+from typing import Any, BinaryIO, Dict, Iterator, List, Optional, Tuple
+
+import networkx as nx
+
+
+class GraphNode:
+    """One exported node: a function, an SCC, a file or a directory."""
+
+    __slots__ = ("id", "label", "path", "size", "internal")
+
+    def __init__(self, node_id: str, label: str, path: Optional[str], size: int = 1):
+        self.id = node_id
+        self.label = label
+        self.path = path          # project-relative file (or directory) the node belongs to
+        self.size = size          # underlying functions/files collapsed into it
+        self.internal = 0         # underlying edges hidden inside it
+
+
+class GraphExporter:
+    """Exports a StructuralAnalyzer's graphs after its files were indexed and checks run."""
+
+    GRAPHS = ("calls", "imports")
+    LEVELS = ("function", "scc", "file", "directory")
+    FORMATS = ("dot", "ndjson", "binary")
+    CLUSTERS = ("directory", "module")
+    SUFFIX_FORMATS = {".dot": "dot", ".gv": "dot", ".ndjson": "ndjson", ".jsonl": "ndjson",
+                      ".bin": "binary", ".cgx": "binary"}
+    MAGIC = b"CGX1"
+
+    def __init__(self, structural, root: Path):
+        self.structural = structural
+        self.root = root.resolve()
+
+    @classmethod
+    def format_for(cls, output: Path) -> Optional[str]:
+        return cls.SUFFIX_FORMATS.get(output.suffix.lower())
+
+    # ── Base graphs ──────────────────────────────────────────────────
+
+    def _relative(self, path) -> str:
+        try:
+            return Path(path).resolve().relative_to(self.root).as_posix()
+        except ValueError:
+            return Path(path).as_posix()
+
+    def base_graph(self, graph: str) -> Tuple[nx.DiGraph, Dict[Any, Optional[str]]]:
+        """(graph, node -> relative path) for "calls" or "imports"."""
+        if graph == "calls":
+            symbols = self.structural.symbol_table.symbols
+            call_graph = self.structural.call_graph
+            paths = {}
+            for node in call_graph.nodes:
+                sym = symbols.get(node)
+                paths[node] = self._relative(sym.file) if sym is not None else None
+            return call_graph, paths
+        if graph == "imports":
+            return self._import_graph()
+        raise ValueError(f"Unknown graph {graph!r} (expected one of {', '.join(self.GRAPHS)})")
+
+    def _import_graph(self) -> Tuple[nx.DiGraph, Dict[Any, Optional[str]]]:
+        """File -> file edges for imports and #includes that resolve to indexed files."""
+        files = {self._relative(p): p for p in self.structural.file_data_map}
+        by_module, by_stem = {}, {}
+        for rel in files:
+            parts = rel.rsplit(".", 1)[0].split("/")
+            if parts[-1] == "__init__":
+                parts = parts[:-1]
+            if parts:
+                by_module[".".join(parts)] = rel
+                by_stem.setdefault(parts[-1], []).append(rel)
+
+        def resolve(name: str) -> Optional[str]:
+            if name in by_module:
+                return by_module[name]
+            # Imported relative to a source root below the exported folder
+            suffix = [m for m in by_module if m.endswith("." + name)]
+            if len(suffix) == 1:
+                return by_module[suffix[0]]
+            candidates = by_stem.get(name.rsplit(".", 1)[-1], [])
+            return candidates[0] if len(candidates) == 1 else None
+
+        graph = nx.DiGraph()
+        graph.add_nodes_from(files)
+        for rel, key in files.items():
+            for imp in (self.structural.file_data_map.get(key) or {}).get("imports", []):
+                if imp.get("resolved"):
+                    targets = [self._relative(imp["resolved"])]
+                elif imp.get("module") and Path(key).suffix == ".py":
+                    targets = [resolve(f"{imp['module']}.{n}") or resolve(imp["module"]) for n in imp.get("names", [])]
+                elif Path(key).suffix == ".py":
+                    targets = [resolve(n) for n in imp.get("names", [])]
+                else:
+                    targets = []
+                for target in targets:
+                    if target and target != rel and target in graph:
+                        graph.add_edge(rel, target)
+        return graph, {rel: rel for rel in files}
+
+    # ── Level of detail ──────────────────────────────────────────────
+
+    def collapse(self, graph: nx.DiGraph, paths: Dict[Any, Optional[str]], level: str,
+                 depth: Optional[int] = None) -> Tuple[List[GraphNode], Iterator[Tuple[str, str, int]]]:
+        """Nodes and a (source, target, weight) edge stream at `level`."""
+        if level not in self.LEVELS:
+            raise ValueError(f"Unknown level {level!r} (expected one of {', '.join(self.LEVELS)})")
+        if level == "function":
+            nodes = [GraphNode(str(n), str(n), paths.get(n)) for n in graph.nodes]
+            return nodes, ((str(u), str(v), 1) for u, v in graph.edges)
+
+        group: Dict[Any, str] = {}
+        nodes: Dict[str, GraphNode] = {}
+        if level == "scc":
+            for index, members in enumerate(sorted(nx.strongly_connected_components(graph),
+                                                   key=lambda c: min(map(str, c)))):
+                first = min(map(str, members))
+                node_id = first if len(members) == 1 else f"scc:{index}"
+                member_paths = {paths.get(m) for m in members}
+                path = member_paths.pop() if len(member_paths) == 1 else self._common_dir(member_paths)
+                label = first if len(members) == 1 else f"{first} (+{len(members) - 1})"
+                nodes[node_id] = GraphNode(node_id, label, path, len(members))
+                for member in members:
+                    group[member] = node_id
+        else:
+            for node in graph.nodes:
+                key = self._group_key(paths.get(node), level, depth)
+                if key not in nodes:
+                    nodes[key] = GraphNode(key, key, key if key != "<external>" else None, 0)
+                nodes[key].size += 1
+                group[node] = key
+
+        weights: Counter = Counter()
+        for u, v in graph.edges:
+            gu, gv = group[u], group[v]
+            if gu == gv:
+                nodes[gu].internal += 1
+            else:
+                weights[gu, gv] += 1
+        order = {node_id: i for i, node_id in enumerate(nodes)}
+        edges = sorted(weights.items(), key=lambda item: (order[item[0][0]], order[item[0][1]]))
+        return list(nodes.values()), ((u, v, w) for (u, v), w in edges)
+
+    @staticmethod
+    def _group_key(path: Optional[str], level: str, depth: Optional[int]) -> str:
+        if path is None:
+            return "<external>"
+        if level == "file":
+            return path
+        parts = Path(path).parent.parts
+        if depth is not None:
+            parts = parts[:depth]
+        return "/".join(parts) or "."
+
+    @staticmethod
+    def _common_dir(paths) -> Optional[str]:
+        dirs = [Path(p).parent.parts for p in paths if p]
+        if not dirs:
+            return None
+        common = []
+        for parts in zip(*dirs):
+            if len(set(parts)) != 1:
+                break
+            common.append(parts[0])
+        return "/".join(common) or "."
+
+    # ── Writers ──────────────────────────────────────────────────────
+
+    def export(self, output: Path, graph: str = "calls", level: str = "function", fmt: Optional[str] = None,
+               depth: Optional[int] = None, cluster: Optional[str] = None) -> Dict[str, int]:
+        """Write one graph; returns node/edge counts and the level actually used."""
+        fmt = fmt or self.format_for(output) or "dot"
+        if fmt not in self.FORMATS:
+            raise ValueError(f"Unknown format {fmt!r} (expected one of {', '.join(self.FORMATS)})")
+        if cluster is not None and cluster not in self.CLUSTERS:
+            raise ValueError(f"Unknown clustering {cluster!r} (expected one of {', '.join(self.CLUSTERS)})")
+        base, paths = self.base_graph(graph)
+        if graph == "imports" and level == "function":
+            level = "file"  # import graph nodes are files already
+        nodes, edges = self.collapse(base, paths, level, depth)
+
+        if fmt == "binary":
+            with open(output, 'wb') as f:
+                count = self.write_binary(f, nodes, edges, base.number_of_edges() if level == "function" else None)
+        else:
+            with open(output, 'w', encoding='utf-8') as f:
+                if fmt == "dot":
+                    count = self.write_dot(f, nodes, edges, cluster, graph)
+                else:
+                    count = self.write_ndjson(f, nodes, edges, graph, level)
+        return {"nodes": len(nodes), "edges": count, "level": level}
+
+    def write_dot(self, out, nodes: List[GraphNode], edges, cluster: Optional[str], name: str = "calls") -> int:
+        out.write(f"digraph {name} {{\n  rankdir=LR;\n  node [shape=box, fontsize=10];\n")
+        if cluster:
+            self._write_clustered_nodes(out, nodes, cluster)
+        else:
+            for node in nodes:
+                out.write(f"  {self._dot_node(node)}\n")
+        count = 0
+        for u, v, weight in edges:
+            attrs = f" [weight={weight}, penwidth={min(1 + weight.bit_length(), 8)}]" if weight > 1 else ""
+            out.write(f"  {self._quote(u)} -> {self._quote(v)}{attrs};\n")
+            count += 1
+        out.write("}\n")
+        return count
+
+    def _write_clustered_nodes(self, out, nodes: List[GraphNode], cluster: str):
+        """Nodes inside nested `subgraph cluster_*` blocks, opened and closed as the path prefix changes."""
+        def key(node):
+            if node.path is None:
+                return ("<external>",)
+            if cluster == "module":
+                return (node.path,)
+            return Path(node.path).parent.parts if Path(node.path).suffix else Path(node.path).parts[:-1]
+
+        open_parts: List[str] = []
+        serial = 0
+        for node in sorted(nodes, key=lambda n: (key(n), n.id)):
+            parts = list(key(node))
+            shared = 0
+            while shared < min(len(parts), len(open_parts)) and parts[shared] == open_parts[shared]:
+                shared += 1
+            for _ in range(len(open_parts) - shared):
+                out.write("  " * len(open_parts) + "}\n")
+                open_parts.pop()
+            for part in parts[shared:]:
+                serial += 1
+                out.write("  " * (len(open_parts) + 1) + f"subgraph cluster_{serial} {{ label={self._quote(part)};\n")
+                open_parts.append(part)
+            out.write("  " * (len(open_parts) + 1) + self._dot_node(node) + "\n")
+        for depth in range(len(open_parts), 0, -1):
+            out.write("  " * depth + "}\n")
+
+    def _dot_node(self, node: GraphNode) -> str:
+        label = node.label if node.size <= 1 else f"{node.label}\\n{node.size} nodes"
+        attrs = [f"label={self._quote(label, escape_newline=False)}"]
+        if node.size > 1:
+            attrs.append("style=filled, fillcolor=lightgrey")
+        return f"{self._quote(node.id)} [{', '.join(attrs)}];"
+
+    @staticmethod
+    def _quote(text: str, escape_newline: bool = True) -> str:
+        text = str(text).replace('"', '\\"')
+        if escape_newline:
+            text = text.replace("\n", "\\n")
+        return f'"{text}"'
+
+    def write_ndjson(self, out, nodes: List[GraphNode], edges, graph: str = "calls", level: str = "function") -> int:
+        out.write(json.dumps({"type": "graph", "graph": graph, "level": level, "nodes": len(nodes)}) + "\n")
+        for node in nodes:
+            record = {"type": "node", "id": node.id, "path": node.path}
+            if node.label != node.id:
+                record["label"] = node.label
+            if node.size != 1 or node.internal:
+                record.update(size=node.size, internal=node.internal)
+            out.write(json.dumps(record) + "\n")
+        count = 0
+        for u, v, weight in edges:
+            out.write(json.dumps({"type": "edge", "source": u, "target": v, "weight": weight}) + "\n")
+            count += 1
+        return count
+
+    def write_binary(self, out: BinaryIO, nodes: List[GraphNode], edges, edge_count: Optional[int] = None) -> int:
+        """Compact layout described in the module docstring; `edge_count` lets edges stream unbuffered."""
+        path_index: Dict[str, int] = {}
+        for node in nodes:
+            if node.path is not None and node.path not in path_index:
+                path_index[node.path] = len(path_index)
+        index = {node.id: i for i, node in enumerate(nodes)}
+
+        out.write(self.MAGIC)
+        out.write(self._varint(len(path_index)))
+        for path in path_index:
+            out.write(self._string(path))
+        out.write(self._varint(len(nodes)))
+        for node in nodes:
+            out.write(self._string(node.id))
+            out.write(self._varint(path_index[node.path] + 1 if node.path is not None else 0))
+            out.write(self._varint(node.size) + self._varint(node.internal))
+
+        if edge_count is None:
+            edges = list(edges)
+            edge_count = len(edges)
+        out.write(self._varint(edge_count))
+        previous = 0
+        for u, v, weight in edges:
+            source = index[u]
+            out.write(self._varint(source - previous) + self._varint(index[v]) + self._varint(weight))
+            previous = source
+        return edge_count
+
+    @staticmethod
+    def _varint(value: int) -> bytes:
+        data = bytearray()
+        while True:
+            byte = value & 0x7F
+            value >>= 7
+            if value:
+                data.append(byte | 0x80)
+            else:
+                data.append(byte)
+                return bytes(data)
+
+    @classmethod
+    def _string(cls, text: str) -> bytes:
+        data = text.encode('utf-8')
+        return cls._varint(len(data)) + data
+
+    # ── Reader ───────────────────────────────────────────────────────
+
+    @classmethod
+    def read_binary(cls, source: BinaryIO) -> Dict[str, Any]:
+        """Decode a binary export: {"nodes": [{id, path, size, internal}], "edges": [(source, target, weight)]}."""
+        data = source.read()
+        if not data.startswith(cls.MAGIC):
+            raise ValueError("Not a binary graph export")
+        pos = len(cls.MAGIC)
+
+        def varint():
+            nonlocal pos
+            value, shift = 0, 0
+            while True:
+                byte = data[pos]
+                pos += 1
+                value |= (byte & 0x7F) << shift
+                if not byte & 0x80:
+                    return value
+                shift += 7
+
+        def string():
+            nonlocal pos
+            length = varint()
+            pos += length
+            return data[pos - length:pos].decode('utf-8')
+
+        paths = [string() for _ in range(varint())]
+        nodes = []
+        for _ in range(varint()):
+            node_id, path = string(), varint()
+            nodes.append({"id": node_id, "path": paths[path - 1] if path else None,
+                          "size": varint(), "internal": varint()})
+        edges, source_index = [], 0
+        for _ in range(varint()):
+            source_index += varint()
+            edges.append((nodes[source_index]["id"], nodes[varint()]["id"], varint()))
+        return {"nodes": nodes, "edges": edges}
@@ -0,0 +1,186 @@
+"""
+Progress Dashboard
+Rate-limited live progress display for long-running analysis phases.
+
+Analyzers only bump counters; a rich `Live` display redraws them at a fixed
+rate (REFRESH_PER_SECOND) from its own thread, so terminal writes no longer
+scale with the number of files, symbols or compared pairs. Per-item detail
+that used to be printed goes to an optional log file instead. Errors are
+logged too, counted on the dashboard and summarised when their phase ends.
+"""
+
+import time
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from rich.console import Console
+from rich.live import Live
+from rich.markup import escape
+from rich.table import Table
+from rich.text import Text
+
+
+class PhaseStats:
+    """Counters for one phase."""
+
+    def __init__(self, name: str, total: Optional[int], unit: str):
+        self.name = name
+        self.total = total
+        self.unit = unit
+        self.done = 0
+        self.files = 0
+        self.symbols = 0
+        self.errors: List[str] = []
+        self.started = time.monotonic()
+        self.finished: Optional[float] = None
+
+    @property
+    def elapsed(self) -> float:
+        return max((self.finished or time.monotonic()) - self.started, 1e-6)
+
+    def rate(self, count: int) -> float:
+        return count / self.elapsed
+
+    def eta(self) -> Optional[float]:
+        """Seconds left at the current rate, None while unknown."""
+        if not self.total or not self.done or self.finished:
+            return None
+        return (self.total - self.done) / self.rate(self.done)
+
+
+class ProgressDashboard:
+    """Per-phase counters, throughput, LLM requests in flight and ETA."""
+
+    REFRESH_PER_SECOND = 4
+    ERRORS_SHOWN = 10          # errors printed in a phase's summary; the log file keeps all of them
+
+    def __init__(self, console: Console, llm_client=None, log_file: Optional[Path] = None):
+        self.console = console
+        self.llm_client = llm_client
+        self.current: Optional[PhaseStats] = None
+        self.phases: Dict[str, PhaseStats] = {}
+        self._live: Optional[Live] = None
+        self._log = open(log_file, "a", encoding="utf-8") if log_file else None
+
+    # ── Phases ───────────────────────────────────────────────────────
+
+    @contextmanager
+    def phase(self, name: str, total: Optional[int] = None, unit: str = "files"):
+        """Show the dashboard for the duration of one phase; its final frame stays on screen."""
+        self.current = self.phases[name] = PhaseStats(name, total, unit)
+        self.log(f"── {name} started ──")
+        self._live = Live(self, console=self.console, refresh_per_second=self.REFRESH_PER_SECOND,
+                          transient=False)
+        self._live.start()
+        try:
+            yield self.current
+        finally:
+            self.current.finished = time.monotonic()
+            self._live.stop()
+            self._live = None
+            self.log(f"── {name} finished: {self.current.done} {unit} in {self.current.elapsed:.1f}s ──")
+            self._print_errors(self.current)
+            self.current = None  # advance()/error() after the phase no longer touch its counters
+
+    def set_total(self, total: int, unit: Optional[str] = None):
+        """Size of the current phase once known (e.g. pair count after filtering)."""
+        if self.current:
+            self.current.total = total
+            self.current.unit = unit or self.current.unit
+
+    def advance(self, done: int = 1, files: int = 0, symbols: int = 0):
+        """Count work items; cheap enough to call per file or per compared pair."""
+        phase = self.current
+        if phase:
+            phase.done += done
+            phase.files += files
+            phase.symbols += symbols
+
+    @contextmanager
+    def paused(self):
+        """Stop redrawing while the user is prompted, then resume."""
+        live = self._live
+        if live is None:
+            yield
+            return
+        live.stop()
+        try:
+            yield
+        finally:
+            live.start()
+
+    # ── Log file ─────────────────────────────────────────────────────
+
+    def log(self, message: str):
+        """Per-item detail: written to the log file (markup stripped), dropped without one."""
+        if self._log:
+            plain = Text.from_markup(message).plain.strip()
+            self._log.write(f"{time.strftime('%H:%M:%S')} {plain}\n")
+
+    def error(self, message: str):
+        """A failure the user must see: logged, counted on the dashboard, printed when the phase ends."""
+        self.log(message)
+        if self.current:
+            self.current.errors.append(message)
+        else:
+            self.console.print(f"[red]{escape(message)}[/red]")
+
+    def _print_errors(self, phase: PhaseStats):
+        if not phase.errors:
+            return
+        self.console.print(f"[red]{len(phase.errors)} error{'s' if len(phase.errors) != 1 else ''} during {phase.name}:[/red]")
+        for message in phase.errors[:self.ERRORS_SHOWN]:
+            self.console.print(f"  [red]{escape(message)}[/red]")
+        hidden = len(phase.errors) - self.ERRORS_SHOWN
+        if hidden > 0:
+            where = "see the log file" if self._log else "use --log-file to keep all of them"
+            self.console.print(f"  [dim]... and {hidden} more ({where})[/dim]")
+
+    def close(self):
+        if self._live:
+            self._live.stop()
+            self._live = None
+        if self._log:
+            self._log.close()
+            self._log = None
+
+    # ── Rendering (called by Live at most REFRESH_PER_SECOND times a second) ──
+
+    def __rich__(self) -> Table:
+        phase = self.current
+        grid = Table.grid(padding=(0, 2))
+        if phase is None:
+            return grid
+
+        count = f"{phase.done}/{phase.total}" if phase.total else str(phase.done)
+        if phase.total:
+            count += f" ({phase.done / phase.total:.0%})"
+        cells = [f"[bold blue]{phase.name}[/bold blue]", f"{count} {phase.unit}"]
+        if phase.files:
+            cells.append(f"{phase.rate(phase.files):.1f} files/s")
+        if phase.symbols:
+            cells.append(f"{phase.rate(phase.symbols):.1f} symbols/s")
+        if phase.errors:
+            cells.append(f"[red]{len(phase.errors)} error{'s' if len(phase.errors) != 1 else ''}[/red]")
+        in_flight = getattr(self.llm_client, "in_flight", 0)
+        if in_flight:
+            cells.append(f"[magenta]LLM in flight: {in_flight}[/magenta]")
+        eta = phase.eta()
+        if phase.finished:
+            cells.append(f"[green]done in {self._duration(phase.elapsed)}[/green]")
+        elif eta is not None:
+            cells.append(f"[dim]ETA {self._duration(eta)}[/dim]")
+        else:
+            cells.append(f"[dim]{self._duration(phase.elapsed)} elapsed[/dim]")
+        grid.add_row(*cells)
+        return grid
+
+    @staticmethod
+    def _duration(seconds: float) -> str:
+        seconds = int(seconds)
+        if seconds >= 3600:
+            return f"{seconds // 3600}h{seconds % 3600 // 60:02d}m"
+        if seconds >= 60:
+            return f"{seconds // 60}m{seconds % 60:02d}s"
+        return f"{seconds}s"